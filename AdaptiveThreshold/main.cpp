@@ -1,33 +1,36 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 
+#include "allocationCounter.hpp"
+#include "bitMask.hpp"
+#include "integralThreshold.hpp"
+#include "skinLut.hpp"
+
 // YCrCb skin detection thresholds
 int lowY = 0, lowCr = 133, lowCb = 77;
 int highY = 255, highCr = 173, highCb = 127;
 int threshold1 = 0;
 int threshold2 = 0;
 
-// Function to filter skin regions in YCrCb color space
-cv::Mat filterSkinYCrCb(cv::Mat &frame)
-{
-    cv::Mat ycrcb, skinMask;
-    cv::cvtColor(frame, ycrcb, cv::COLOR_BGR2YCrCb); // Convert frame to YCrCb color space
+// Adaptive threshold on running box sums, 'm' switches between the box mean and the 3 box Gaussian approximation
+AdaptiveBoxMethod adaptiveMethod = ADAPTIVE_BOX_GAUSSIAN;
 
-    // Define lower and upper bounds for skin color in YCrCb color space
-    cv::Scalar lower(lowY, lowCr, lowCb);
-    cv::Scalar upper(highY, highCr, highCb);
+// BGR → skin lookup table, rebuilt only when the trackbars move
+SkinLut skinLut;
+BitMask skinBits;
 
-    // Apply threshold to isolate skin regions
-    cv::inRange(ycrcb, lower, upper, skinMask);
+// Function to filter skin regions in YCrCb color space, into the caller's skinMask (reused frame after frame)
+void filterSkinYCrCb(const cv::Mat &frame, cv::Mat &skinMask)
+{
+    // Same as cvtColor(COLOR_BGR2YCrCb) + inRange(lower, upper) but straight from the BGR pixels, 1 bit per pixel
+    skinLut.setYCrCb(lowY, lowCr, lowCb, highY, highCr, highCb);
+    skinLut.apply(frame, skinBits);
 
     // Morphological operations to reduce noise
-    cv::erode(skinMask, skinMask, cv::Mat(), cv::Point(-1, -1), 2);
-    cv::dilate(skinMask, skinMask, cv::Mat(), cv::Point(-1, -1), 2);
-
-    // Optional: Smooth out edges to help contour detection
-    cv::GaussianBlur(skinMask, skinMask, cv::Size(5, 5), 0);
-
-    return skinMask;
+    // Same as cv::erode / cv::dilate(skinMask, skinMask, cv::Mat(), cv::Point(-1, -1), 2), on the bits
+    maskErode(skinBits, skinBits, 3, 3, 2);
+    maskDilate(skinBits, skinBits, 3, 3, 2);
+    skinBits.toMat(skinMask);
 }
 
 int main()
@@ -52,10 +55,18 @@ int main()
         return -1;
     }
 
+    // Every stage writes into these, same size every frame → allocated once
+    cv::Mat frame, grayFrame, adaptiveThresh, blurredFrame, edges;
+    cv::Mat skinMaskYCrCb, contourOutputYCrCb;
+    std::vector<std::vector<cv::Point>> contoursYCrCb;
+
+    // Skin mask, adaptive threshold and the overlay copy should allocate nothing after the first frames.
+    // GaussianBlur, findContours and Canny are left out : they build scratch of their own inside on every call
+    // (kernels, a bordered copy of the mask, the edge map) that can't be handed to them
+    AllocationMeter stageAllocations("skin mask + adaptive threshold");
+
     while (true)
     {
-        cv::Mat frame, grayFrame, adaptiveThresh, blurredFrame, edges;
-
         // Capture frame-by-frame
         cap >> frame;
         if (frame.empty())
@@ -64,11 +75,10 @@ int main()
             break;
         }
 
-        // Perform skin detection in YCrCb color space
-        cv::Mat skinMaskYCrCb = filterSkinYCrCb(frame);
+        stageAllocations.begin();
 
-        // Convert frame to grayscale
-        cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY);
+        // Perform skin detection in YCrCb color space
+        filterSkinYCrCb(frame, skinMaskYCrCb);
 
         // Option 1: Apply Gaussian Blur before adaptive thresholding
         // cv::GaussianBlur(grayFrame, blurredFrame, cv::Size(5, 5), 1.5);
@@ -79,8 +89,14 @@ int main()
         // void cv::adaptiveThreshold(InputArray src, OutputArray dst, double maxValue, int adaptiveMethod, int thresholdType, int blockSize, double C)
         // Check codingNotes.md for more detail about how to determine the right blockSize
         // Applies threshold dynamically for each pixel based on it's neighborhood which makes it best for images with varying lighting conditions
-        cv::adaptiveThreshold(grayFrame, adaptiveThresh, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C,
-                              cv::THRESH_BINARY, 11, 2);
+        // Same blockSize / C as cv::adaptiveThreshold(grayFrame, adaptiveThresh, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C, cv::THRESH_BINARY, 11, 2)
+        // but gray is computed on the fly from the BGR frame and every pixel costs the same whatever the blockSize
+        integralThreshold(lumaFromBGR(frame), adaptiveThresh, 11, 2, adaptiveMethod);
+
+        // Copy of the original frame for the contour overlay
+        frame.copyTo(contourOutputYCrCb);
+
+        stageAllocations.end();
 
         /*
             Keep in mind that:
@@ -94,12 +110,13 @@ int main()
                     - And since we're dealing with a lot of light in a surgical setting, we can totally skip this step.
         */
 
+        // Optional: Smooth out edges to help contour detection
+        cv::GaussianBlur(skinMaskYCrCb, skinMaskYCrCb, cv::Size(5, 5), 0);
+
         // Detect contours on the skin mask
-        std::vector<std::vector<cv::Point>> contoursYCrCb;
         cv::findContours(skinMaskYCrCb, contoursYCrCb, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
 
         // Draw contours on a copy of the original frame
-        cv::Mat contourOutputYCrCb = frame.clone();
         cv::drawContours(contourOutputYCrCb, contoursYCrCb, -1, cv::Scalar(255, 0, 0), 2); // Blue
 
         // Apply Canny Edge Detection on the adaptive thresholded image
@@ -112,12 +129,19 @@ int main()
         cv::imshow("Hand Detection - YCrCb", contourOutputYCrCb);
 
         // Press 'q' to exit the loop
-        if (cv::waitKey(1) == 'q')
+        int key = cv::waitKey(1);
+        if (key == 'q')
         {
             break;
         }
+        if (key == 'm')
+        {
+            adaptiveMethod = adaptiveMethod == ADAPTIVE_BOX_MEAN ? ADAPTIVE_BOX_GAUSSIAN : ADAPTIVE_BOX_MEAN;
+        }
     }
 
+    stageAllocations.printStats(std::cout);
+
     cap.release();
     cv::destroyAllWindows();
     return 0;
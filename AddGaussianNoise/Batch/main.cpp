@@ -0,0 +1,363 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gaussianNoise.hpp"
+
+namespace fs = std::filesystem;
+
+// ----------------- Batch Gaussian noise ----------------- //
+// Grows a folder of training images with noisy copies, several sigmas per image
+//  - ./addNoiseBatch <input folder> <output folder> [--sigma 5,10,20] [--copies 1] [--mean 0] [--seed 0] [--jobs N] [--png]
+//  - ./addNoiseBatch --check : Philox known answers + same output for 1 / 4 threads, exits with 1 on failure
+//  - Input folder is walked recursively, the output keeps its sub folders (HGR1/3/x.jpg → out/3/x_s10_0.jpg)
+//  - Every output has its own Philox stream picked from (relative path, sigma, copy) → the same command writes the
+//    same images again, whatever --jobs is or in which order the files are listed
+
+struct BatchOptions
+{
+    fs::path input;
+    fs::path output;
+    std::vector<std::string> sigmas = {"5", "10", "20"}; // Kept as typed, they go in the file names
+    std::vector<float> sigmaValues;                       // The same, parsed once in main
+    int copies = 1;
+    float mean = 0;
+    uint64_t seed = 0;
+    int jobs = 0;
+    bool png = false; // JPEG re-encoding smooths part of the noise away
+};
+
+// FNV-1a, stable across runs and platforms (std::hash isn't)
+uint64_t fnv1a(const std::string &text)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : text)
+    {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool isImage(const fs::path &path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c)
+                   { return (char)std::tolower(c); });
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
+
+// ---------- Option values ---------- //
+// Whole string a number in range, false otherwise : std::sto* throw on garbage / overflow and stop at the first
+// character they don't know, and a value addGaussianNoise asserts on would be std::terminate on a worker thread
+bool parseFloat(const std::string &text, float low, float high, float &value)
+{
+    size_t used = 0;
+    try
+    {
+        value = std::stof(text, &used);
+    }
+    catch (const std::invalid_argument &)
+    {
+        return false;
+    }
+    catch (const std::out_of_range &)
+    {
+        return false;
+    }
+    return used == text.size() && std::isfinite(value) && value >= low && value <= high;
+}
+
+bool parseInt(const std::string &text, int low, int high, int &value)
+{
+    size_t used = 0;
+    try
+    {
+        value = std::stoi(text, &used);
+    }
+    catch (const std::invalid_argument &)
+    {
+        return false;
+    }
+    catch (const std::out_of_range &)
+    {
+        return false;
+    }
+    return used == text.size() && value >= low && value <= high;
+}
+
+// stoull takes "-1" and wraps it, so only digits
+bool parseSeed(const std::string &text, uint64_t &value)
+{
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](unsigned char c)
+                                     { return std::isdigit(c); }))
+        return false;
+    try
+    {
+        value = std::stoull(text);
+    }
+    catch (const std::out_of_range &)
+    {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> splitList(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (char c : list + ",")
+    {
+        if (c != ',')
+            item += c;
+        else if (!item.empty())
+        {
+            items.push_back(item);
+            item.clear();
+        }
+    }
+    return items;
+}
+
+// ---------- Self check ---------- //
+bool runCheck()
+{
+    bool ok = true;
+
+    // Random123 known answers for Philox4x32-10
+    struct Known
+    {
+        uint32_t counter[4];
+        uint32_t key[2];
+        uint32_t expected[4];
+    };
+    const Known known[] = {
+        {{0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+    };
+    for (const Known &k : known)
+    {
+        uint32_t out[4];
+        philox4x32(k.counter, k.key, out);
+        if (!std::equal(out, out + 4, k.expected))
+        {
+            std::cerr << "❌ Philox4x32-10 known answer mismatch" << std::endl;
+            ok = false;
+        }
+    }
+
+    // Same image for any thread count, noise statistics close to the requested ones
+    cv::Mat image(480, 641, CV_8UC3, cv::Scalar(128, 128, 128));
+    cv::Mat one, four;
+    addGaussianNoise(image, one, 10, 0, 42, 7, 1);
+    addGaussianNoise(image, four, 10, 0, 42, 7, 4);
+    if (cv::norm(one, four, cv::NORM_INF) != 0)
+    {
+        std::cerr << "❌ Output depends on the thread count" << std::endl;
+        ok = false;
+    }
+
+    double sum = 0, sumSq = 0;
+    const int n = one.cols * one.channels();
+    for (int y = 0; y < one.rows; y++)
+    {
+        const uint8_t *row = one.ptr<uint8_t>(y);
+        for (int x = 0; x < n; x++)
+        {
+            const double d = row[x] - 128.0;
+            sum += d;
+            sumSq += d * d;
+        }
+    }
+    const double count = (double)one.rows * n;
+    const double mean = sum / count;
+    const double stddev = std::sqrt(sumSq / count - mean * mean);
+    if (std::abs(mean) > 0.1 || std::abs(stddev - 10) > 0.1)
+    {
+        std::cerr << "❌ Noise mean " << mean << " / sigma " << stddev << ", expected 0 / 10" << std::endl;
+        ok = false;
+    }
+
+    std::cout << (ok ? "✅" : "❌") << " check (" << gaussianNoiseBackend() << "), sigma 10 → mean " << mean
+              << ", sigma " << stddev << std::endl;
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    BatchOptions options;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--check")
+            return runCheck() ? 0 : 1;
+        else if (arg == "--sigma" && i + 1 < argc)
+            options.sigmas = splitList(argv[++i]);
+        else if (arg == "--copies" && i + 1 < argc)
+        {
+            if (!parseInt(argv[++i], 1, 100000, options.copies))
+            {
+                std::cerr << "❌ --copies " << argv[i] << " : expected a whole number, 1 .. 100000" << std::endl;
+                return -1;
+            }
+        }
+        else if (arg == "--mean" && i + 1 < argc)
+        {
+            if (!parseFloat(argv[++i], -GAUSSIAN_NOISE_MAX, GAUSSIAN_NOISE_MAX, options.mean))
+            {
+                std::cerr << "❌ --mean " << argv[i] << " : expected a number, -" << GAUSSIAN_NOISE_MAX << " .. "
+                          << GAUSSIAN_NOISE_MAX << std::endl;
+                return -1;
+            }
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            if (!parseSeed(argv[++i], options.seed))
+            {
+                std::cerr << "❌ --seed " << argv[i] << " : expected a whole number, 0 .. 2^64 - 1" << std::endl;
+                return -1;
+            }
+        }
+        else if (arg == "--jobs" && i + 1 < argc)
+        {
+            if (!parseInt(argv[++i], 0, 1024, options.jobs))
+            {
+                std::cerr << "❌ --jobs " << argv[i] << " : expected a whole number, 0 (one per core) .. 1024" << std::endl;
+                return -1;
+            }
+        }
+        else if (arg == "--png")
+            options.png = true;
+        else if (arg.rfind("--", 0) == 0)
+            std::cerr << "⚠️ Ignoring unknown option " << arg << std::endl;
+        else
+            positional.push_back(arg);
+    }
+
+    if (positional.size() != 2 || options.sigmas.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " <input folder> <output folder> [--sigma 5,10,20] [--copies 1] [--mean 0] "
+                  << "[--seed 0] [--jobs N] [--png]\n       " << argv[0] << " --check" << std::endl;
+        return -1;
+    }
+    options.input = positional[0];
+    options.output = positional[1];
+
+    for (const std::string &sigma : options.sigmas)
+    {
+        float value = 0;
+        if (!parseFloat(sigma, 0, GAUSSIAN_NOISE_MAX, value))
+        {
+            std::cerr << "❌ --sigma " << sigma << " : expected a number, 0 .. " << GAUSSIAN_NOISE_MAX << std::endl;
+            return -1;
+        }
+        options.sigmaValues.push_back(value);
+    }
+
+    if (!fs::is_directory(options.input))
+    {
+        std::cerr << "❌ " << options.input << " is not a folder" << std::endl;
+        return -1;
+    }
+
+    // Sorted so the log reads the same every run (the output doesn't depend on it)
+    std::vector<fs::path> files;
+    for (const auto &entry : fs::recursive_directory_iterator(options.input))
+        if (entry.is_regular_file() && isImage(entry.path()))
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    if (files.empty())
+    {
+        std::cerr << "❌ No images in " << options.input << std::endl;
+        return -1;
+    }
+
+    // ---------- Workers ---------- //
+    // imread / imwrite cost more than the noise, so files go over the workers and each image is noised on its
+    // worker's thread (addGaussianNoise splits rows over threads when it's called on its own)
+    const int jobs = options.jobs > 0 ? options.jobs : (int)std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> written{0};
+    std::atomic<size_t> failed{0};
+    std::atomic<uint64_t> noiseNs{0};
+    std::atomic<uint64_t> noiseBytes{0};
+    std::mutex logMutex;
+
+    auto worker = [&]()
+    {
+        cv::Mat noisy;
+        for (size_t i = next++; i < files.size(); i = next++)
+        {
+            const fs::path &file = files[i];
+            cv::Mat image = cv::imread(file.string(), cv::IMREAD_UNCHANGED);
+            if (image.empty() || image.depth() != CV_8U)
+            {
+                std::lock_guard<std::mutex> lock(logMutex);
+                std::cerr << "⚠️ Skipping " << file << " (unreadable or not 8-bit)" << std::endl;
+                failed++;
+                continue;
+            }
+
+            const fs::path relative = fs::relative(file, options.input);
+            const fs::path folder = options.output / relative.parent_path();
+            std::error_code ec;
+            fs::create_directories(folder, ec);
+
+            for (size_t s = 0; s < options.sigmas.size(); s++)
+            {
+                const std::string &sigma = options.sigmas[s];
+                for (int copy = 0; copy < options.copies; copy++)
+                {
+                    const uint64_t stream = fnv1a(relative.generic_string() + "|" + sigma + "|" + std::to_string(copy));
+                    auto t0 = std::chrono::steady_clock::now();
+                    addGaussianNoise(image, noisy, options.sigmaValues[s], options.mean, options.seed, stream, 1);
+                    noiseNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+                    noiseBytes += (uint64_t)noisy.total() * noisy.elemSize();
+
+                    const std::string ext = options.png ? ".png" : file.extension().string();
+                    const fs::path out = folder / (file.stem().string() + "_s" + sigma + "_" + std::to_string(copy) + ext);
+                    if (cv::imwrite(out.string(), noisy))
+                        written++;
+                    else
+                    {
+                        std::lock_guard<std::mutex> lock(logMutex);
+                        std::cerr << "❌ Could not write " << out << std::endl;
+                        failed++;
+                    }
+                }
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < jobs; i++)
+        workers.emplace_back(worker);
+    for (auto &w : workers)
+        w.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double noiseSeconds = noiseNs.load() * 1e-9;
+    std::cout << "✅ " << files.size() << " images → " << written.load() << " noisy copies in " << options.output << " ("
+              << seconds << " s, " << jobs << " jobs)\n"
+              << "Noise only : " << noiseBytes.load() / 1e6 / std::max(noiseSeconds, 1e-9) << " MB/s per thread ("
+              << gaussianNoiseBackend() << "), the rest is decode / encode" << std::endl;
+    if (failed.load() > 0)
+        std::cout << "⚠️ " << failed.load() << " images / copies failed" << std::endl;
+
+    return failed.load() > 0 ? 1 : 0;
+}
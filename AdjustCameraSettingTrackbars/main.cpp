@@ -7,6 +7,9 @@
 #include <ctime>
 #include <sstream>
 
+#include "cameraControl.hpp"
+#include "controlWorker.hpp"
+
 // Globals for trackbars
 int exposureValue = 3;    // Range: 3–2047 (for exposure_time_absolute)
 int focusValue = 30;      // Range: 0–250
@@ -25,17 +28,14 @@ int backlightCompensation = 0;
 int whiteBalanceTemperature = 4000;
 int whiteBalanceAuto = 1;
 
-void runCommand(const std::string &command)
+CameraControl camera; // VIDIOC_S_EXT_CTRLS straight on the device, no v4l2-ctl fork per trackbar tick
+
+ControlWorker controlWorker(camera, 30); // Applies trackbar values off the GUI thread, at most 30 ioctls/s
+
+// Only posts the value, the worker sends the newest one (and prints what the driver did with it)
+void applyControl(uint32_t id, int value)
 {
-    int result = system(command.c_str());
-    std::cout << "\n[CMD] " << command << std::endl;
-
-    if (result == 0)
-        std::cout << command << " executed successfully.\n";
-    else if (result == 127)
-        std::cout << "❌ 'v4l2-ctl' not found in PATH.\n";
-    else
-        std::cout << "⚠️ Error executing command. Return code: " << result << "\n";
+    controlWorker.post(id, value);
 }
 
 // Callback functions to be executed when trackbar values change
@@ -45,73 +45,65 @@ void setAutoExposure(int value, void *)
     // auto_exposure 0x009a0901 (menu)   : min=0 max=3 default=3 value=3 (Aperture       Priority Mode)
     //  1: Manual Mode
     //  3: Aperture Priority Mode
-    if (value == 0)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=1");
-    if (value == 1)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=3");
+    applyControl(V4L2_CID_EXPOSURE_AUTO, value == 0 ? V4L2_EXPOSURE_MANUAL : V4L2_EXPOSURE_APERTURE_PRIORITY);
 }
 
 void setExposureTime(int value, void *)
 {
     // exposure_time_absolute 0x009a0902 (int)    : min=3 max=2047 step=1 default=250 value=333 flags=inactive
-    //  runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=exposure_auto=1"); // Set manual mode
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=exposure_time_absolute=" + std::to_string(value));
+    applyControl(V4L2_CID_EXPOSURE_ABSOLUTE, value);
 }
 
 void onFocusChange(int value, void *)
 {
-    // runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_auto=0"); // Disable autofocus
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_absolute=" + std::to_string(value));
+    applyControl(V4L2_CID_FOCUS_ABSOLUTE, value);
 }
 
 void onAutofocusToggle(int value, void *)
 {
-    if (value == 0)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_automatic_continuous=0");
-    if (value == 1)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_automatic_continuous=1");
+    applyControl(V4L2_CID_FOCUS_AUTO, value);
 }
 
 // Additional recommended control callbacks
 
 void setBrightness(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=brightness=" + std::to_string(value));
+    applyControl(V4L2_CID_BRIGHTNESS, value);
 }
 
 void setContrast(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=contrast=" + std::to_string(value));
+    applyControl(V4L2_CID_CONTRAST, value);
 }
 
 void setSaturation(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=saturation=" + std::to_string(value));
+    applyControl(V4L2_CID_SATURATION, value);
 }
 
 void setGain(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=gain=" + std::to_string(value));
+    applyControl(V4L2_CID_GAIN, value);
 }
 
 void setSharpness(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=sharpness=" + std::to_string(value));
+    applyControl(V4L2_CID_SHARPNESS, value);
 }
 
 void setBacklightComp(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=backlight_compensation=" + std::to_string(value));
+    applyControl(V4L2_CID_BACKLIGHT_COMPENSATION, value);
 }
 
 void setWhiteBalanceTemperature(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_temperature=" + std::to_string(value));
+    applyControl(V4L2_CID_WHITE_BALANCE_TEMPERATURE, value);
 }
 
 void setWhiteBalanceAuto(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_automatic=" + std::to_string(value));
+    applyControl(V4L2_CID_AUTO_WHITE_BALANCE, value);
 }
 
 // Main app
@@ -130,8 +122,11 @@ int main()
     std::string filename = "cameraSettings_" + timeStr + ".csv";
     std::ofstream outFile(filename);
     // Print initial camera state
+    if (!camera.open("/dev/video2"))
+        return -1;
+
     std::cout << "------ Initial Camera Settings ------\n";
-    system("v4l2-ctl --device=/dev/video2 --all");
+    camera.printControls();
 
     // Open camera
     cv::VideoCapture cap(2, cv::CAP_V4L2);
@@ -177,19 +172,23 @@ int main()
     cv::createTrackbar("Auto WB (0/1)", "Camera Feed", &whiteBalanceAuto, 1, setWhiteBalanceAuto);
     cv::createTrackbar("WB Temp (2000-6500)", "Camera Feed", &whiteBalanceTemperature, 6500, setWhiteBalanceTemperature);
 
-    // Apply initial settings
-    setExposureTime(exposureValue, 0);
-    onFocusChange(focusValue, 0);
-    onAutofocusToggle(autofocusEnabled, 0);
-    setAutoExposure(setAperature, 0);
-    setBrightness(brightnessValue, 0);
-    setContrast(contrastValue, 0);
-    setSaturation(saturationValue, 0);
-    setGain(gainValue, 0);
-    setSharpness(sharpnessValue, 0);
-    setBacklightComp(backlightCompensation, 0);
-    setWhiteBalanceAuto(whiteBalanceAuto, 0);
-    setWhiteBalanceTemperature(whiteBalanceTemperature, 0);
+    // Apply initial settings, one VIDIOC_S_EXT_CTRLS for all of them (auto modes before the values they unlock)
+    std::vector<ControlValue> initial = {
+        {V4L2_CID_EXPOSURE_AUTO, setAperature == 0 ? V4L2_EXPOSURE_MANUAL : V4L2_EXPOSURE_APERTURE_PRIORITY},
+        {V4L2_CID_FOCUS_AUTO, autofocusEnabled},
+        {V4L2_CID_AUTO_WHITE_BALANCE, whiteBalanceAuto},
+        {V4L2_CID_EXPOSURE_ABSOLUTE, exposureValue},
+        {V4L2_CID_FOCUS_ABSOLUTE, focusValue},
+        {V4L2_CID_WHITE_BALANCE_TEMPERATURE, whiteBalanceTemperature},
+        {V4L2_CID_BRIGHTNESS, brightnessValue},
+        {V4L2_CID_CONTRAST, contrastValue},
+        {V4L2_CID_SATURATION, saturationValue},
+        {V4L2_CID_GAIN, gainValue},
+        {V4L2_CID_SHARPNESS, sharpnessValue},
+        {V4L2_CID_BACKLIGHT_COMPENSATION, backlightCompensation},
+    };
+    printControlResults(camera.set(initial));
+    controlWorker.start(); // Trackbar changes from here on go through the worker
 
     cv::Mat frame;
     while (true)
@@ -207,6 +206,9 @@ int main()
     }
 
     cap.release();
+    controlWorker.stop();
+    std::cout << controlWorker.posted() << " trackbar changes → " << controlWorker.batches() << " control ioctls\n";
+    camera.close();
     cv::destroyAllWindows();
 
     // Write CSV header
@@ -11,6 +11,10 @@
 #include <atomic>
 #include <iomanip>
 
+#include "bitMask.hpp"
+#include "skinLut.hpp"
+#include "threadPool.hpp"
+
 using namespace cv;
 using namespace std;
 using namespace std::chrono;
@@ -44,6 +48,9 @@ void calculateFPS()
 
 int main()
 {
+    // Workers started once and pinned, the skin LUT splits its rows over them every frame
+    ThreadPool &pool = ThreadPool::shared();
+    cout << "Thread pool : " << pool.size() << " threads" << endl;
 
     cv::namedWindow("Hand Detection - YCrCb", cv::WINDOW_AUTOSIZE);
     cv::createTrackbar("Low Y", "Hand Detection - YCrCb", &lowY, 255);
@@ -65,8 +72,14 @@ int main()
     usbCamera.set(cv::CAP_PROP_FRAME_WIDTH, 640);
     usbCamera.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
 
-    Mat frame, ycrcbImage;
-    Mat skinMaskYCrCbOutput, fgMask, combinedMask;
+    Mat frame;
+    Mat fgMask, combinedMask;
+
+    // Masks stay 1 bit per pixel until the combined one is displayed
+    BitMask skinMaskYCrCbOutput, fgBits, combinedBits;
+
+    // BGR → skin lookup table, only rebuilt when a trackbar moves
+    SkinLut skinLut;
 
     // Define skin color ranges for YCrCb
     Scalar ycrcbLower(0, 133, 77);
@@ -94,25 +107,24 @@ int main()
             break;
         }
 
-        cvtColor(frame, ycrcbImage, COLOR_BGR2YCrCb);
-
         // Apply skin color segmentation in YCrCb
         // inRange(ycrcbImage, ycrcbLower, ycrcbUpper, skinMaskYCrCbOutput);
 
-        // Define lower and upper bounds for skin color in YCrCb color space
-        cv::Scalar lower(lowY, lowCr, lowCb);
-        cv::Scalar upper(highY, highCr, highCb);
-
-        // Apply threshold to isolate skin regions
-        cv::inRange(ycrcbImage, lower, upper, skinMaskYCrCbOutput);
+        // Same mask as cvtColor(COLOR_BGR2YCrCb) + inRange(lower, upper), one table lookup per pixel
+        skinLut.setYCrCb(lowY, lowCr, lowCb, highY, highCr, highCb);
+        skinLut.apply(frame, skinMaskYCrCbOutput);
 
         // Apply Background Subtraction on the original frame
         pBackSub->apply(frame, fgMask);
 
+        // MOG2 marks foreground 255 and shadows 127, only keep the foreground
+        fgBits.fromMat(fgMask, 127);
+
         // Combine the skin mask with the foreground mask
         // I didn't do this on my first attempt
         // Was used so we could combine two masks in a way that only keeps the regoins where both masks have non-zero/active pixels
-        bitwise_and(fgMask, skinMaskYCrCbOutput, combinedMask);
+        maskAnd(fgBits, skinMaskYCrCbOutput, combinedBits);
+        combinedBits.toMat(combinedMask);
 
         // Display FPS on the frame
         frameCounter++;
@@ -120,11 +132,11 @@ int main()
         ss << "FPS: " << fixed << setprecision(2) << fps;
         std::cout << "FPS : " << fps << std::endl;
         putText(combinedMask, ss.str(), Point(15, 30), FONT_HERSHEY_SIMPLEX, 1, Scalar(255, 255, 255), 2);
-        putText(ycrcbImage, ss.str(), Point(15, 30), FONT_HERSHEY_SIMPLEX, 1, Scalar(0, 255, 0), 2);
+        putText(frame, ss.str(), Point(15, 30), FONT_HERSHEY_SIMPLEX, 1, Scalar(0, 255, 0), 2);
 
         // Show the combined mask
         imshow("Hand Gesture Detection", combinedMask);
-        imshow("ycrcbImage", ycrcbImage);
+        imshow("frame", frame);
 
         if (waitKey(1) == 'q')
         {
@@ -135,5 +147,6 @@ int main()
     updateFPS = false;
     fpsThread.join();
 
+    pool.printStats(cout);
     return 0;
 }
@@ -1,6 +1,184 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "v4l2Capture.hpp"
+#include "monotonicClock.hpp"
+
+// ----------------- Mode benchmark ----------------- //
+// What one mode actually delivers, measured instead of trusting cap.get()
+struct ModeStats
+{
+    bool ok = false;
+    int frames = 0;
+    double fps = 0;            // Achieved, from the buffer timestamps
+    double intervalMs = 0;     // Mean inter-frame interval
+    double jitterMs = 0;       // Std dev of the interval
+    double worstIntervalMs = 0;
+    uint32_t droppedSeq = 0;   // Gaps in the driver sequence numbers
+    double ageP50Ms = 0;       // Buffer timestamp → DQBUF returned
+    double ageP99Ms = 0;
+    double cpuUsPerFrame = 0;  // Process CPU time per frame, including the decode to gray the pipeline would need
+    const char *decode = "";   // What that decode was
+};
+
+static int64_t processCpuNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0;
+    size_t rank = (size_t)(p / 100.0 * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+ModeStats benchmarkMode(const std::string &device, const CaptureMode &mode, double seconds)
+{
+    ModeStats stats;
+
+    // 4 buffers while measuring so a slow decode doesn't show up as driver drops
+    V4L2Capture cap;
+    if (!cap.open(device, mode.width, mode.height, mode.pixelFormat, 4))
+        return stats;
+    if (cap.width() != mode.width || cap.height() != mode.height || cap.pixelFormat() != mode.pixelFormat)
+        return stats;
+    if (mode.intervalNumerator)
+        cap.setFrameInterval(mode.intervalNumerator, mode.intervalDenominator);
+    if (!cap.start())
+        return stats;
+
+    // Warm up : auto exposure settles and the first frames of a UVC stream are often late
+    FrameView view;
+    int64_t warmupEnd = monotonicNowNs() + 500000000LL;
+    while (monotonicNowNs() < warmupEnd && cap.grab(view, 2000))
+        view.release();
+
+    std::vector<double> intervals, ages;
+    int64_t lastTs = -1;
+    uint32_t lastSeq = 0;
+    cv::Mat gray;
+
+    int64_t cpuStart = processCpuNs();
+    int64_t end = monotonicNowNs() + (int64_t)(seconds * 1e9);
+    while (monotonicNowNs() < end)
+    {
+        if (!cap.grab(view, 2000))
+            break;
+        int64_t now = monotonicNowNs();
+
+        ages.push_back((now - view.timestampNs) / 1e6);
+        if (lastTs >= 0)
+        {
+            intervals.push_back((view.timestampNs - lastTs) / 1e6);
+            if (view.sequence > lastSeq + 1)
+                stats.droppedSeq += view.sequence - lastSeq - 1;
+        }
+        lastTs = view.timestampNs;
+        lastSeq = view.sequence;
+
+        // Count the work needed to get a gray image out of this format
+        if (mode.pixelFormat == V4L2_PIX_FMT_MJPEG || mode.pixelFormat == V4L2_PIX_FMT_JPEG)
+        {
+            cv::Mat jpeg(1, (int)view.bytesUsed, CV_8UC1, (void *)view.data);
+            gray = cv::imdecode(jpeg, cv::IMREAD_GRAYSCALE);
+            stats.decode = "imdecode";
+        }
+        else if (mode.pixelFormat == V4L2_PIX_FMT_YUYV)
+            stats.decode = "Y plane"; // Gray is already there (see thresholdStage)
+        else
+            stats.decode = "none";
+
+        view.release();
+        stats.frames++;
+    }
+    int64_t cpuUsed = processCpuNs() - cpuStart;
+    cap.close();
+
+    if (intervals.empty())
+        return stats;
+
+    double sum = 0, sumSq = 0;
+    for (double interval : intervals)
+    {
+        sum += interval;
+        sumSq += interval * interval;
+        stats.worstIntervalMs = std::max(stats.worstIntervalMs, interval);
+    }
+    stats.intervalMs = sum / intervals.size();
+    stats.jitterMs = std::sqrt(std::max(0.0, sumSq / intervals.size() - stats.intervalMs * stats.intervalMs));
+    stats.fps = 1000.0 / stats.intervalMs;
+    stats.ageP50Ms = percentile(ages, 50);
+    stats.ageP99Ms = percentile(ages, 99);
+    stats.cpuUsPerFrame = cpuUsed / 1e3 / stats.frames;
+    stats.ok = true;
+    return stats;
+}
+
+// Streams every mode the camera lists and prints what it really does
+int runBenchmark(const std::string &device, double seconds)
+{
+    std::vector<CaptureMode> modes = enumerateModes(device);
+    if (modes.empty())
+    {
+        std::cerr << "❌ No capture modes found on " << device << std::endl;
+        return 1;
+    }
+
+    std::cout << "Benchmarking " << modes.size() << " modes on " << device << ", " << seconds << " s each\n\n";
+    std::printf("%-4s %-10s %9s | %7s %9s %9s %9s %6s | %8s %8s | %9s %s\n",
+                "fmt", "size", "asked fps", "fps", "interval", "jitter", "worst", "drops", "age p50", "age p99", "cpu us/f", "decode");
+
+    std::vector<std::pair<CaptureMode, ModeStats>> results;
+    for (const CaptureMode &mode : modes)
+    {
+        ModeStats stats = benchmarkMode(device, mode, seconds);
+        std::string size = std::to_string(mode.width) + "x" + std::to_string(mode.height);
+
+        if (!stats.ok)
+        {
+            std::printf("%-4s %-10s %9.2f | ⚠️ could not stream this mode\n", fourccToString(mode.pixelFormat).c_str(), size.c_str(), mode.fps());
+            continue;
+        }
+
+        std::printf("%-4s %-10s %9.2f | %7.2f %9.2f %9.2f %9.2f %6u | %8.2f %8.2f | %9.1f %s\n",
+                    fourccToString(mode.pixelFormat).c_str(), size.c_str(), mode.fps(),
+                    stats.fps, stats.intervalMs, stats.jitterMs, stats.worstIntervalMs, stats.droppedSeq,
+                    stats.ageP50Ms, stats.ageP99Ms, stats.cpuUsPerFrame, stats.decode);
+        std::fflush(stdout);
+        results.push_back({mode, stats});
+    }
+
+    // A hand movement lands on average half an interval before the next exposure, then the frame is ageP50 old when we get it
+    auto expectedMs = [](const ModeStats &stats)
+    { return stats.intervalMs / 2 + stats.ageP50Ms + stats.cpuUsPerFrame / 1000.0; };
+
+    const std::pair<CaptureMode, ModeStats> *best = nullptr;
+    for (const auto &result : results)
+    {
+        if (result.first.width < 640 || result.first.height < 480) // Smaller than what the gesture pipeline was tuned on
+            continue;
+        if (!best || expectedMs(result.second) < expectedMs(best->second))
+            best = &result;
+    }
+
+    if (best)
+        std::cout << "\n✅ Lowest expected latency at >= 640x480 : " << fourccToString(best->first.pixelFormat) << " "
+                  << best->first.width << "x" << best->first.height << " @ " << best->second.fps << " fps (~"
+                  << expectedMs(best->second) << " ms from motion to dequeued frame)\n";
+    return 0;
+}
 
 void checkCameraProperties(cv::VideoCapture &cap)
 {
@@ -44,8 +222,15 @@ void checkCameraProperties(cv::VideoCapture &cap)
     }
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    // ./checkCamera --benchmark [device] [seconds per mode]
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+    {
+        std::string device = argc > 2 ? argv[2] : "/dev/video2";
+        double seconds = argc > 3 ? std::atof(argv[3]) : 3.0;
+        return runBenchmark(device, seconds > 0 ? seconds : 3.0);
+    }
 
     // Use sysfs rebind to 'reset' the webcamera
     // Use lsusb to find webcamera bus ID and replace it with '1-1' as shown in the example below
@@ -0,0 +1,121 @@
+#include "allocationCounter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+static std::atomic<uint64_t> allocations{0};
+
+// Stray allocations reported per meter in debug builds, the rest only show up in printStats
+static const uint64_t ALLOCATION_REPORTS = 5;
+
+uint64_t allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+// ----------------- operator new / delete ----------------- //
+static void *countedMalloc(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void *countedAlignedMalloc(std::size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = nullptr;
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void *));
+    return posix_memalign(&p, align, size ? size : 1) == 0 ? p : nullptr;
+}
+
+void *operator new(std::size_t size)
+{
+    if (void *p = countedMalloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    if (void *p = countedMalloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedMalloc(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedMalloc(size); }
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void *p = countedAlignedMalloc(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void *p = countedAlignedMalloc(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAlignedMalloc(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAlignedMalloc(size, alignment);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+
+// ----------------- AllocationMeter ----------------- //
+AllocationMeter::AllocationMeter(const char *name, int warmupFrames)
+    : name_(name),
+      warmupFrames_(warmupFrames)
+{
+}
+
+void AllocationMeter::end()
+{
+    const uint64_t count = allocationCount() - start_;
+    if (frames_++ < (uint64_t)warmupFrames_)
+        return;
+
+    measured_++;
+    allocations_ += count;
+    framesAllocating_ += count != 0;
+    worst_ = std::max(worst_, count);
+
+#ifndef NDEBUG
+    if (count != 0 && framesAllocating_ <= ALLOCATION_REPORTS)
+        std::cerr << "⚠️ " << name_ << ": " << count << " allocations in frame " << frames_ << " after the warm up"
+                  << (framesAllocating_ == ALLOCATION_REPORTS ? " (no more reports)" : "") << std::endl;
+#endif
+}
+
+void AllocationMeter::printStats(std::ostream &out) const
+{
+    if (measured_ == 0)
+        return;
+
+    out << "Allocations (" << name_ << "): " << (double)allocations_ / measured_ << " per frame over " << measured_
+        << " frames after the first " << warmupFrames_ << ", " << framesAllocating_ << " frames allocated (worst "
+        << worst_ << ")\n";
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// ----------------- Allocation counter ----------------- //
+// allocationCounter.cpp replaces the global operator new / delete with ones that count, then call malloc / free
+//  - Only in the tools whose Makefile lists it, nothing else changes
+//  - Counts operator new (std containers, std::string, new) in every thread
+//  - A cv::Mat buffer counts as 1 : the pixels come from cv::fastMalloc (not counted) but OpenCV news the UMatData
+//    that goes with them. Scratch an OpenCV function keeps on the stack or in an AutoBuffer isn't seen
+uint64_t allocationCount();
+
+// Allocations between begin() and end(), frame after frame
+//  - The first warmupFrames are left out (buffers, arenas and thread_local scratch reaching their size)
+//  - printStats : allocations per frame after that, and how many frames allocated at all (should be 0)
+//  - Built without -DNDEBUG, the first few frames that still allocate after the warm up are reported as they happen
+class AllocationMeter
+{
+public:
+    explicit AllocationMeter(const char *name, int warmupFrames = 30);
+
+    void begin() { start_ = allocationCount(); }
+    void end();
+
+    void printStats(std::ostream &out) const;
+
+private:
+    const char *name_;
+    int warmupFrames_;
+    uint64_t start_ = 0;
+
+    uint64_t frames_ = 0;
+    uint64_t measured_ = 0;
+    uint64_t allocations_ = 0;
+    uint64_t framesAllocating_ = 0;
+    uint64_t worst_ = 0;
+};
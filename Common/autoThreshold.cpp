@@ -0,0 +1,153 @@
+#include "autoThreshold.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+AutoThreshold::AutoThreshold(AutoThresholdMethod method, double percentile, int hysteresis, double smoothing)
+    : method_(method),
+      percentile_(std::min(std::max(percentile, 0.0), 1.0)),
+      hysteresis_(std::max(hysteresis, 0)),
+      smoothing_(std::min(std::max(smoothing, 0.01), 1.0))
+{
+}
+
+void AutoThreshold::reset(int start)
+{
+    started_ = false;
+    value_ = start;
+    candidate_ = start;
+    smoothed_ = start;
+    clearHistogram();
+}
+
+void AutoThreshold::sample(const LumaView &frame, int step)
+{
+    if (enabled())
+        lumaHistogram(frame, step, histogram_);
+}
+
+int AutoThreshold::update()
+{
+    if (!enabled())
+        return value_;
+
+    int pick = method_ == AUTO_THRESHOLD_OTSU ? otsuThreshold(histogram_) : percentileThreshold(histogram_, percentile_);
+    clearHistogram();
+    if (pick < 0)
+        return value_; // Nothing was thresholded this frame, keep what we had
+
+    frames_++;
+    candidate_ = pick;
+
+    // First frame in sets the value straight away, after that the smoothed candidate has to leave the dead band
+    if (!started_)
+    {
+        started_ = true;
+        smoothed_ = pick;
+        value_ = pick;
+        return value_;
+    }
+
+    smoothed_ += smoothing_ * (pick - smoothed_);
+    int target = (int)std::lround(smoothed_);
+    if (std::abs(target - value_) > hysteresis_)
+    {
+        value_ = target;
+        changes_++;
+    }
+    return value_;
+}
+
+bool AutoThreshold::parseMethod(const std::string &name, AutoThresholdMethod &method)
+{
+    if (name == "off" || name == "false")
+        method = AUTO_THRESHOLD_OFF;
+    else if (name == "otsu")
+        method = AUTO_THRESHOLD_OTSU;
+    else if (name == "percentile")
+        method = AUTO_THRESHOLD_PERCENTILE;
+    else
+        return false;
+    return true;
+}
+
+const char *AutoThreshold::methodName(AutoThresholdMethod method)
+{
+    switch (method)
+    {
+    case AUTO_THRESHOLD_OTSU:
+        return "otsu";
+    case AUTO_THRESHOLD_PERCENTILE:
+        return "percentile";
+    default:
+        return "off";
+    }
+}
+
+void AutoThreshold::printStats(std::ostream &out) const
+{
+    if (frames_ == 0)
+        return;
+
+    out << "Auto threshold (" << methodName(method_) << "): " << changes_ << " changes over " << frames_
+        << " frames, a value held " << (double)frames_ / (changes_ + 1) << " frames on average, last " << value_ << "\n";
+}
+
+// ----------------- Histogram thresholds ----------------- //
+int otsuThreshold(const LumaHistogram &histogram)
+{
+    uint64_t total = 0;
+    double sumAll = 0;
+    for (int i = 0; i < 256; i++)
+    {
+        total += histogram[i];
+        sumAll += (double)i * histogram[i];
+    }
+    if (total == 0)
+        return -1;
+
+    // Maximise the between class variance w0 * w1 * (mu0 - mu1)^2
+    uint64_t w0 = 0;
+    double sum0 = 0;
+    double best = -1;
+    int threshold = 0;
+    for (int t = 0; t < 255; t++)
+    {
+        w0 += histogram[t];
+        sum0 += (double)t * histogram[t];
+        if (w0 == 0)
+            continue;
+        uint64_t w1 = total - w0;
+        if (w1 == 0)
+            break;
+
+        double mu0 = sum0 / w0;
+        double mu1 = (sumAll - sum0) / w1;
+        double between = (double)w0 * (double)w1 * (mu0 - mu1) * (mu0 - mu1);
+        if (between > best)
+        {
+            best = between;
+            threshold = t;
+        }
+    }
+    return threshold;
+}
+
+int percentileThreshold(const LumaHistogram &histogram, double fraction)
+{
+    uint64_t total = 0;
+    for (uint32_t count : histogram)
+        total += count;
+    if (total == 0)
+        return -1;
+
+    const double wanted = fraction * (double)total;
+    uint64_t below = 0;
+    for (int t = 0; t < 256; t++)
+    {
+        below += histogram[t];
+        if ((double)below >= wanted)
+            return t;
+    }
+    return 255;
+}
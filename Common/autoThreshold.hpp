@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "thresholdStage.hpp"
+
+// ----------------- AutoThreshold ----------------- //
+// Threshold picked every frame from the luminance histogram of the whole frame
+//  - sample() counts a sparse grid of the frame (lumaHistogram), always the whole frame whatever part of it gets
+//    thresholded, so the pick doesn't jump when the tracker locks on / loses the hand (its ROI is mostly hand)
+//  - Histogram of frame N sets the threshold of frame N + 1 (one frame late)
+//  - Otsu : the level that best splits the histogram in two classes (hand vs background)
+//  - Percentile : the level with `percentile` of the pixels at or below it (0.85 ≈ keep the brightest 15%)
+//  - The candidate is smoothed (exponential average) and the output only moves once the smoothed value is
+//    more than `hysteresis` levels away from it, so it doesn't flicker between neighbouring levels
+//  - Values are in the histogram's units (raw Y for YUYV frames), see grayThresholdFromLuma()
+enum AutoThresholdMethod
+{
+    AUTO_THRESHOLD_OFF,
+    AUTO_THRESHOLD_OTSU,
+    AUTO_THRESHOLD_PERCENTILE
+};
+
+class AutoThreshold
+{
+public:
+    explicit AutoThreshold(AutoThresholdMethod method = AUTO_THRESHOLD_OTSU, double percentile = 0.85,
+                           int hysteresis = 3, double smoothing = 0.3);
+
+    // Whole frame, every step-th pixel / row into the histogram, nothing when the mode is off
+    void sample(const LumaView &frame, int step = 4);
+
+    // Or fill it yourself (blurThreshold() / PyramidSearch::search() histogram), null when the mode is off
+    LumaHistogram *histogram() { return enabled() ? &histogram_ : nullptr; }
+    void clearHistogram() { histogram_.fill(0); }
+
+    // End of frame : new candidate from the histogram, histogram cleared for the next frame
+    // Returns the threshold to use next
+    int update();
+
+    // start = value used until the first histogram is in
+    void reset(int start);
+    int value() const { return value_; }
+    int candidate() const { return candidate_; } // Raw pick of the last frame, before smoothing / hysteresis
+
+    bool enabled() const { return method_ != AUTO_THRESHOLD_OFF; }
+    AutoThresholdMethod method() const { return method_; }
+    void setMethod(AutoThresholdMethod method) { method_ = method; }
+
+    // "off", "otsu" or "percentile" (YAML profile values), false if the name is unknown
+    static bool parseMethod(const std::string &name, AutoThresholdMethod &method);
+    static const char *methodName(AutoThresholdMethod method);
+
+    // Threshold changes and how many frames a value was held on average
+    void printStats(std::ostream &out) const;
+
+private:
+    AutoThresholdMethod method_;
+    double percentile_;
+    int hysteresis_;
+    double smoothing_;
+
+    LumaHistogram histogram_{};
+    bool started_ = false;
+    double smoothed_ = 0;
+    int value_ = 0;
+    int candidate_ = 0;
+
+    uint64_t frames_ = 0;
+    uint64_t changes_ = 0;
+};
+
+// Otsu's threshold of a histogram (class 0 = levels <= returned value), -1 if the histogram is empty
+int otsuThreshold(const LumaHistogram &histogram);
+// Smallest level with at least `fraction` of the pixels at or below it, -1 if the histogram is empty
+int percentileThreshold(const LumaHistogram &histogram, double fraction);
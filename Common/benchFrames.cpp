@@ -0,0 +1,78 @@
+#include "benchFrames.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <cmath>
+#include <iostream>
+
+bool BenchFrames::load(const std::vector<std::string> &paths, int threshVal)
+{
+    std::vector<cv::Mat> images;
+    for (const std::string &path : paths)
+    {
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".hgf") == 0)
+        {
+            if (!reader_.isOpened() && reader_.open(path) && reader_.header().pixelFormat == V4L2_PIX_FMT_YUYV)
+            {
+                const FrameFileHeader &h = reader_.header();
+                for (uint64_t i = 0; i < reader_.frameCount(); i++)
+                    if (reader_.record(i).bytesUsed != 0)
+                        frames_.push_back({lumaFromYUYV(reader_.payload(i), h.width, h.height, h.stride), lumaThresholdFromGray(threshVal)});
+            }
+            else
+                std::cerr << "⚠️ Skipping " << path << " (one YUYV recording per run)" << std::endl;
+            continue;
+        }
+
+        cv::Mat image = cv::imread(path, cv::IMREAD_COLOR);
+        if (image.empty())
+        {
+            std::cerr << "❌ Could not read " << path << std::endl;
+            return false;
+        }
+        images.push_back(image);
+    }
+    add(images, threshVal);
+    return true;
+}
+
+void BenchFrames::add(const std::vector<cv::Mat> &images, int threshVal)
+{
+    // The views point into the Mats' pixels, kept alive in images_ (the Mat headers can move, the pixels don't)
+    for (const cv::Mat &image : images)
+    {
+        images_.push_back(image);
+        frames_.push_back({lumaFromBGR(image), threshVal});
+    }
+}
+
+std::vector<cv::Mat> syntheticHandFrames(int count, int fingerWidth, bool distractors)
+{
+    std::vector<cv::Mat> frames;
+    cv::RNG rng(4242);
+    for (int i = 0; i < count; i++)
+    {
+        cv::Mat gray(480, 640, CV_8UC1);
+        rng.fill(gray, cv::RNG::UNIFORM, cv::Scalar(0), cv::Scalar(90));
+
+        cv::Point palm(120 + (i * 3) % 400, 260 + (int)(40 * std::sin(i * 0.1)));
+        cv::circle(gray, palm, 70, cv::Scalar(200), cv::FILLED);
+        for (int f = 0; f < 4; f++)
+        {
+            double angle = -2.2 + f * 0.45 + 0.1 * std::sin(i * 0.2 + f);
+            cv::Point tip(palm.x + (int)(140 * std::cos(angle)), palm.y + (int)(140 * std::sin(angle)));
+            cv::line(gray, palm, tip, cv::Scalar(200), fingerWidth > 0 ? fingerWidth : 6 + i % 20);
+        }
+        if (distractors)
+        {
+            cv::circle(gray, cv::Point(560, 80), 25, cv::Scalar(180), cv::FILLED);
+            cv::rectangle(gray, cv::Rect(40 + i % 50, 400, 50, 30), cv::Scalar(170), cv::FILLED);
+        }
+
+        cv::Mat bgr;
+        cv::cvtColor(gray, bgr, cv::COLOR_GRAY2BGR);
+        frames.push_back(bgr);
+    }
+    return frames;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frameFile.hpp"
+#include "thresholdStage.hpp"
+
+// ----------------- BenchFrames ----------------- //
+// Input frames of the check / benchmark tools (HullBenchmark, PyramidCheck) : ./tool [recording.hgf | image ...]
+//  - One YUYV .hgf recording, its frames are read in place (raw Y, threshVal converted with lumaThresholdFromGray)
+//  - Images, decoded to BGR and read as gray (threshVal as is)
+//  - No input = a synthetic sequence (syntheticHandFrames), added by the tool with the shape it wants
+//  - Every frame is a LumaView + the threshold that applies to it, the pixels stay owned here : not copyable
+class BenchFrames
+{
+public:
+    BenchFrames() = default;
+    BenchFrames(const BenchFrames &) = delete;
+    BenchFrames &operator=(const BenchFrames &) = delete;
+
+    // Recording frames first, then the images. false (with the reason) when an image can't be read
+    bool load(const std::vector<std::string> &paths, int threshVal);
+
+    // BGR frames (the synthetic sequence), threshVal as is
+    void add(const std::vector<cv::Mat> &images, int threshVal);
+
+    const std::vector<std::pair<LumaView, int>> &frames() const { return frames_; }
+    size_t size() const { return frames_.size(); }
+    bool empty() const { return frames_.empty(); }
+
+private:
+    std::vector<cv::Mat> images_;
+    FrameReader reader_;
+    std::vector<std::pair<LumaView, int>> frames_;
+};
+
+// Hand-ish blob (palm + 4 fingers) moving left to right over noise, BGR
+//  - fingerWidth : in pixels, 0 = 6 .. 25 changing every frame (thin fingers → 1 pixel wide parts in the contour)
+//  - distractors : a few smaller blobs around the hand (which blob is the hand isn't a given)
+std::vector<cv::Mat> syntheticHandFrames(int count, int fingerWidth, bool distractors);
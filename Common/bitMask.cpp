@@ -0,0 +1,539 @@
+#include "bitMask.hpp"
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITMASK_HAVE_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BITMASK_HAVE_NEON 1
+#endif
+
+// ----------------- Word kernels ----------------- //
+// The whole mask is one contiguous run of words, so the logic ops are single loops over wordCount()
+struct WordKernels
+{
+    const char *name;
+    void (*andWords)(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n);
+    void (*orWords)(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n);
+    void (*andNotWords)(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n);
+    void (*notWords)(const uint64_t *src, uint64_t *dst, size_t n);
+    size_t (*popcount)(const uint64_t *src, size_t n);
+    void (*packRow)(const uint8_t *src, int width, int threshold, uint64_t *dst); // threshold 0..254
+};
+
+// ---------- Scalar ---------- //
+static void andScalar(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = a[i] & b[i];
+}
+
+static void orScalar(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = a[i] | b[i];
+}
+
+static void andNotScalar(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = a[i] & ~b[i];
+}
+
+static void notScalar(const uint64_t *src, uint64_t *dst, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = ~src[i];
+}
+
+static size_t popcountScalar(const uint64_t *src, size_t n)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++)
+        total += (size_t)__builtin_popcountll(src[i]);
+    return total;
+}
+
+static void packRowScalar(const uint8_t *src, int width, int threshold, uint64_t *dst, int from)
+{
+    for (int x0 = from; x0 < width; x0 += 64)
+    {
+        uint64_t word = 0;
+        int count = std::min(64, width - x0);
+        for (int k = 0; k < count; k++)
+            word |= (uint64_t)(src[x0 + k] > threshold) << k;
+        dst[x0 >> 6] = word;
+    }
+}
+
+static void packScalar(const uint8_t *src, int width, int threshold, uint64_t *dst)
+{
+    packRowScalar(src, width, threshold, dst, 0);
+}
+
+static const WordKernels SCALAR_KERNELS = {"scalar", andScalar, orScalar, andNotScalar, notScalar, popcountScalar, packScalar};
+
+// ---------- AVX2 (x86, picked at runtime) ---------- //
+#ifdef BITMASK_HAVE_AVX2
+__attribute__((target("avx2"))) static void andAvx2(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(a + i)), _mm256_loadu_si256((const __m256i *)(b + i))));
+    andScalar(a + i, b + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void orAvx2(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(a + i)), _mm256_loadu_si256((const __m256i *)(b + i))));
+    orScalar(a + i, b + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void andNotAvx2(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) // andnot(x, y) = ~x & y
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *)(b + i)), _mm256_loadu_si256((const __m256i *)(a + i))));
+    andNotScalar(a + i, b + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void notAvx2(const uint64_t *src, uint64_t *dst, size_t n)
+{
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(src + i)), ones));
+    notScalar(src + i, dst + i, n - i);
+}
+
+// Every AVX2 CPU has POPCNT, without the target the builtin is a libgcc call
+__attribute__((target("avx2,popcnt"))) static size_t popcountAvx2(const uint64_t *src, size_t n)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++)
+        total += (size_t)_mm_popcnt_u64(src[i]);
+    return total;
+}
+
+// 32 pixels → 32 bits : v > threshold  <=>  max(v, threshold + 1) == v, then movemask
+__attribute__((target("avx2"))) static void packAvx2(const uint8_t *src, int width, int threshold, uint64_t *dst)
+{
+    const __m256i above = _mm256_set1_epi8((char)(threshold + 1));
+    int x = 0;
+    for (; x + 64 <= width; x += 64)
+    {
+        __m256i lo = _mm256_loadu_si256((const __m256i *)(src + x));
+        __m256i hi = _mm256_loadu_si256((const __m256i *)(src + x + 32));
+        uint32_t loBits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(lo, above), lo));
+        uint32_t hiBits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(hi, above), hi));
+        dst[x >> 6] = ((uint64_t)hiBits << 32) | loBits;
+    }
+    packRowScalar(src, width, threshold, dst, x);
+}
+
+static const WordKernels AVX2_KERNELS = {"avx2", andAvx2, orAvx2, andNotAvx2, notAvx2, popcountAvx2, packAvx2};
+#endif
+
+// ---------- NEON (ARM) ---------- //
+#ifdef BITMASK_HAVE_NEON
+static void andNeon(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        vst1q_u64(dst + i, vandq_u64(vld1q_u64(a + i), vld1q_u64(b + i)));
+    andScalar(a + i, b + i, dst + i, n - i);
+}
+
+static void orNeon(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        vst1q_u64(dst + i, vorrq_u64(vld1q_u64(a + i), vld1q_u64(b + i)));
+    orScalar(a + i, b + i, dst + i, n - i);
+}
+
+static void andNotNeon(const uint64_t *a, const uint64_t *b, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) // bic(x, y) = x & ~y
+        vst1q_u64(dst + i, vbicq_u64(vld1q_u64(a + i), vld1q_u64(b + i)));
+    andNotScalar(a + i, b + i, dst + i, n - i);
+}
+
+static void notNeon(const uint64_t *src, uint64_t *dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        vst1q_u64(dst + i, vreinterpretq_u64_u8(vmvnq_u8(vreinterpretq_u8_u64(vld1q_u64(src + i)))));
+    notScalar(src + i, dst + i, n - i);
+}
+
+// __builtin_popcountll is already CNT on aarch64, packing stays scalar
+static const WordKernels NEON_KERNELS = {"neon", andNeon, orNeon, andNotNeon, notNeon, popcountScalar, packScalar};
+#endif
+
+static const WordKernels &kernels()
+{
+#ifdef BITMASK_HAVE_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+        return AVX2_KERNELS;
+#endif
+#ifdef BITMASK_HAVE_NEON
+    return NEON_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const char *bitMaskBackend()
+{
+    return kernels().name;
+}
+
+// ----------------- BitMask ----------------- //
+void BitMask::create(int width, int height)
+{
+    width_ = std::max(0, width);
+    height_ = std::max(0, height);
+    wordsPerRow_ = (width_ + 63) / 64;
+
+    int tail = width_ & 63;
+    lastWordMask_ = tail ? (1ull << tail) - 1 : ~0ull;
+
+    words_.resize((size_t)wordsPerRow_ * height_);
+}
+
+void BitMask::setTo(bool value)
+{
+    std::fill(words_.begin(), words_.end(), value ? ~0ull : 0ull);
+    if (value && wordsPerRow_ > 0)
+    {
+        for (int y = 0; y < height_; y++)
+            row(y)[wordsPerRow_ - 1] &= lastWordMask_;
+    }
+}
+
+size_t BitMask::count() const
+{
+    return kernels().popcount(words_.data(), words_.size());
+}
+
+void BitMask::fromMat(const cv::Mat &mask, int threshold)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+    create(mask.cols, mask.rows);
+
+    if (threshold >= 255)
+    {
+        setTo(false);
+        return;
+    }
+
+    threshold = std::max(threshold, 0);
+    const WordKernels &k = kernels();
+    for (int y = 0; y < height_; y++)
+        k.packRow(mask.ptr<uint8_t>(y), width_, threshold, row(y));
+}
+
+// 8 bits → 8 bytes of 0x00 / 0xFF
+struct ExpandTable
+{
+    uint64_t bytes[256];
+
+    ExpandTable()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            bytes[i] = 0;
+            for (int k = 0; k < 8; k++)
+                if (i & (1 << k))
+                    bytes[i] |= 0xFFull << (8 * k);
+        }
+    }
+};
+
+void BitMask::toMat(cv::Mat &mask) const
+{
+    static const ExpandTable table;
+
+    mask.create(height_, width_, CV_8UC1);
+    for (int y = 0; y < height_; y++)
+    {
+        const uint64_t *words = row(y);
+        uint8_t *out = mask.ptr<uint8_t>(y);
+
+        int x = 0;
+        for (; x + 8 <= width_; x += 8)
+        {
+            uint8_t bits = (uint8_t)(words[x >> 6] >> (x & 63));
+            std::memcpy(out + x, &table.bytes[bits], 8);
+        }
+        for (; x < width_; x++)
+            out[x] = ((words[x >> 6] >> (x & 63)) & 1) ? 255 : 0;
+    }
+}
+
+// ----------------- Logic ----------------- //
+static void createLike(const BitMask &a, BitMask &dst)
+{
+    if (&a != &dst)
+        dst.create(a.width(), a.height());
+}
+
+void maskAnd(const BitMask &a, const BitMask &b, BitMask &dst)
+{
+    CV_Assert(a.width() == b.width() && a.height() == b.height());
+    createLike(a, dst);
+    kernels().andWords(a.data(), b.data(), dst.data(), a.wordCount());
+}
+
+void maskOr(const BitMask &a, const BitMask &b, BitMask &dst)
+{
+    CV_Assert(a.width() == b.width() && a.height() == b.height());
+    createLike(a, dst);
+    kernels().orWords(a.data(), b.data(), dst.data(), a.wordCount());
+}
+
+void maskAndNot(const BitMask &a, const BitMask &b, BitMask &dst)
+{
+    CV_Assert(a.width() == b.width() && a.height() == b.height());
+    createLike(a, dst);
+    kernels().andNotWords(a.data(), b.data(), dst.data(), a.wordCount());
+}
+
+void maskNot(const BitMask &src, BitMask &dst)
+{
+    createLike(src, dst);
+    kernels().notWords(src.data(), dst.data(), src.wordCount());
+
+    // NOT also flips the bits past width, put them back to 0
+    if (dst.wordsPerRow() > 0)
+    {
+        for (int y = 0; y < dst.height(); y++)
+            dst.row(y)[dst.wordsPerRow() - 1] &= dst.lastWordMask();
+    }
+}
+
+// ----------------- Morphology ----------------- //
+// A 640 wide row is 10 words, strips shorter than this cost more to hand out than to compute
+static const int MIN_STRIP_ROWS = 64;
+
+// What pixels outside the image count as
+enum class Border
+{
+    ZEROS,    // dilate : outside never turns a pixel on
+    ONES,     // erode  : outside never turns a pixel off
+    REPLICATE // medianBlur
+};
+
+// Row copy with one guard word on each side and the bits past width filled for the border,
+// out[1 .. words] is the row, so shifted reads of up to 64 pixels never need a bounds check
+static void borderedRow(const BitMask &src, int y, Border border, uint64_t *out)
+{
+    const int words = src.wordsPerRow();
+    const uint64_t *in = src.row(y);
+
+    uint64_t left = 0, right = 0;
+    if (border == Border::ONES)
+        left = right = ~0ull;
+    else if (border == Border::REPLICATE)
+    {
+        left = (in[0] & 1) ? ~0ull : 0;
+        right = src.get(src.width() - 1, y) ? ~0ull : 0;
+    }
+
+    out[0] = left;
+    std::memcpy(out + 1, in, (size_t)words * sizeof(uint64_t));
+    out[words] = (out[words] & src.lastWordMask()) | (right & ~src.lastWordMask());
+    out[words + 1] = right;
+}
+
+// Word i of the row moved so that bit x holds pixel (x + dx), -64 < dx < 64, p = bordered row + 1
+static inline uint64_t shiftedWord(const uint64_t *p, int i, int dx)
+{
+    if (dx == 0)
+        return p[i];
+    if (dx > 0)
+        return (p[i] >> dx) | (p[i + 1] << (64 - dx));
+    return (p[i] << -dx) | (p[i - 1] >> (64 + dx));
+}
+
+// One rect erode (AND) / dilate (OR) pass : dst(x, y) = op over the kernel of src(x + dx, y + dy)
+// dx in [-anchorX, kernelWidth - 1 - anchorX], same for dy, anchor = kernel / 2 like OpenCV's default
+static void morphRect(const BitMask &src, BitMask &dst, int kernelWidth, int kernelHeight, bool erode)
+{
+    CV_Assert(kernelWidth >= 1 && kernelWidth <= 64 && kernelHeight >= 1);
+
+    const int w = src.width();
+    const int h = src.height();
+    const int words = src.wordsPerRow();
+    const int left = kernelWidth / 2, right = kernelWidth - 1 - left;
+    const int up = kernelHeight / 2, down = kernelHeight - 1 - up;
+
+    // The strips run on other threads, they see the caller's buffer through this reference
+    static thread_local BitMask horizontalStorage;
+    BitMask &horizontal = horizontalStorage;
+    horizontal.create(w, h);
+    ThreadPool &pool = ThreadPool::shared();
+
+    // Horizontal : shift the row words and combine, strips only read their own rows
+    pool.strips(h, 0, MIN_STRIP_ROWS, [&](const Strip &s)
+                {
+        static thread_local std::vector<uint64_t> bordered;
+        bordered.resize((size_t)words + 2);
+        for (int y = s.y0; y < s.y1; y++)
+        {
+            borderedRow(src, y, erode ? Border::ONES : Border::ZEROS, bordered.data());
+            const uint64_t *p = bordered.data() + 1;
+            uint64_t *out = horizontal.row(y);
+
+            for (int i = 0; i < words; i++)
+            {
+                uint64_t acc = p[i];
+                for (int dx = -left; dx <= right; dx++)
+                {
+                    if (dx != 0)
+                        acc = erode ? (acc & shiftedWord(p, i, dx)) : (acc | shiftedWord(p, i, dx));
+                }
+                out[i] = acc;
+            }
+            out[words - 1] &= src.lastWordMask();
+        } });
+
+    // Vertical : combine whole rows, rows outside the image are neutral so they're just skipped
+    // Only reads horizontal (up / down rows of halo) so dst can be src
+    const WordKernels &k = kernels();
+    dst.create(w, h);
+    pool.strips(h, std::max(up, down), MIN_STRIP_ROWS, [&](const Strip &s)
+                {
+        for (int y = s.y0; y < s.y1; y++)
+        {
+            uint64_t *out = dst.row(y);
+            std::memcpy(out, horizontal.row(y), (size_t)words * sizeof(uint64_t));
+            for (int yy = std::max(0, y - up); yy <= std::min(h - 1, y + down); yy++)
+            {
+                if (yy == y)
+                    continue;
+                if (erode)
+                    k.andWords(out, horizontal.row(yy), out, (size_t)words);
+                else
+                    k.orWords(out, horizontal.row(yy), out, (size_t)words);
+            }
+        } });
+}
+
+void maskErode(const BitMask &src, BitMask &dst, int kernelWidth, int kernelHeight, int iterations)
+{
+    if (src.empty())
+    {
+        dst.create(src.width(), src.height());
+        return;
+    }
+
+    morphRect(src, dst, kernelWidth, kernelHeight, true);
+    for (int i = 1; i < iterations; i++)
+        morphRect(dst, dst, kernelWidth, kernelHeight, true);
+}
+
+void maskDilate(const BitMask &src, BitMask &dst, int kernelWidth, int kernelHeight, int iterations)
+{
+    if (src.empty())
+    {
+        dst.create(src.width(), src.height());
+        return;
+    }
+
+    morphRect(src, dst, kernelWidth, kernelHeight, false);
+    for (int i = 1; i < iterations; i++)
+        morphRect(dst, dst, kernelWidth, kernelHeight, false);
+}
+
+void maskOpen(const BitMask &src, BitMask &dst, int kernelWidth, int kernelHeight)
+{
+    maskErode(src, dst, kernelWidth, kernelHeight);
+    maskDilate(dst, dst, kernelWidth, kernelHeight);
+}
+
+void maskClose(const BitMask &src, BitMask &dst, int kernelWidth, int kernelHeight)
+{
+    maskDilate(src, dst, kernelWidth, kernelHeight);
+    maskErode(dst, dst, kernelWidth, kernelHeight);
+}
+
+// ----------------- Median 3x3 ----------------- //
+// Each of the 9 neighbours is one word (64 pixels), adding them up bit-sliced gives every pixel's count at once
+static inline uint64_t majority3(uint64_t a, uint64_t b, uint64_t c)
+{
+    return (a & b) | (a & c) | (b & c);
+}
+
+void maskMedian3(const BitMask &src, BitMask &dst)
+{
+    const int w = src.width();
+    const int h = src.height();
+    const int words = src.wordsPerRow();
+    if (src.empty())
+    {
+        dst.create(w, h);
+        return;
+    }
+
+    // Written to result first, strips read the row above / below theirs so src can't be overwritten (dst can be src)
+    static thread_local BitMask resultStorage;
+    BitMask &result = resultStorage;
+    result.create(w, h);
+
+    ThreadPool::shared().strips(h, 1, MIN_STRIP_ROWS, [&](const Strip &s)
+                                {
+        // 3 bordered rows, row y - 1 / y / y + 1 (clamped = replicated top / bottom)
+        static thread_local std::vector<uint64_t> rows;
+        rows.resize(3 * ((size_t)words + 2));
+
+        uint64_t *above = rows.data() + 1;
+        uint64_t *centre = above + words + 2;
+        uint64_t *below = centre + words + 2;
+
+        for (int y = s.y0; y < s.y1; y++)
+        {
+            borderedRow(src, std::max(0, y - 1), Border::REPLICATE, above - 1);
+            borderedRow(src, y, Border::REPLICATE, centre - 1);
+            borderedRow(src, std::min(h - 1, y + 1), Border::REPLICATE, below - 1);
+
+            uint64_t *out = result.row(y);
+            for (int i = 0; i < words; i++)
+            {
+                // Each row of 3 → 2-bit count (ones, twos)
+                uint64_t ones[3], twos[3];
+                const uint64_t *r[3] = {above, centre, below};
+                for (int k = 0; k < 3; k++)
+                {
+                    uint64_t l = shiftedWord(r[k], i, -1), c = r[k][i], rr = shiftedWord(r[k], i, 1);
+                    ones[k] = l ^ c ^ rr;
+                    twos[k] = majority3(l, c, rr);
+                }
+
+                // total = odd + 2 * m, m = how many of (twos[0..2], carry) are set
+                uint64_t odd = ones[0] ^ ones[1] ^ ones[2];
+                uint64_t carry = majority3(ones[0], ones[1], ones[2]);
+                uint64_t x = twos[0], yv = twos[1], z = twos[2], c = carry;
+
+                uint64_t atLeast2 = ((x | yv) & (z | c)) | (x & yv) | (z & c);
+                uint64_t atLeast3 = (x & yv & (z | c)) | (z & c & (x | yv));
+
+                // total >= 5  <=>  m >= 3, or m == 2 and odd
+                out[i] = atLeast3 | (atLeast2 & odd);
+            }
+            out[words - 1] &= src.lastWordMask();
+        } });
+
+    dst.create(w, h);
+    std::memcpy(dst.data(), result.data(), result.wordCount() * sizeof(uint64_t));
+}
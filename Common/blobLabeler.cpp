@@ -0,0 +1,178 @@
+#include "blobLabeler.hpp"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+// ----------------- Run scan ----------------- //
+// 8 pixels at a time over the long stretches of background / hand, byte by byte at their ends
+static inline uint64_t load8(const uint8_t *p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline int skipZeros(const uint8_t *row, int x, int end)
+{
+    while (x + 8 <= end && load8(row + x) == 0)
+        x += 8;
+    while (x < end && row[x] == 0)
+        x++;
+    return x;
+}
+
+static inline int skipSet(const uint8_t *row, int x, int end)
+{
+    while (x + 8 <= end && load8(row + x) == ~0ull)
+        x += 8;
+    while (x < end && row[x] != 0)
+        x++;
+    return x;
+}
+
+// Sum of k^2 for k = 0 .. n
+static inline int64_t sumSquares(int64_t n)
+{
+    return n < 0 ? 0 : n * (n + 1) * (2 * n + 1) / 6;
+}
+
+// ----------------- BlobLabeler ----------------- //
+int BlobLabeler::find(int run)
+{
+    while (parent_[run] != run)
+    {
+        parent_[run] = parent_[parent_[run]]; // Path halving
+        run = parent_[run];
+    }
+    return run;
+}
+
+int BlobLabeler::label(const cv::Mat &mask, const cv::Rect &roiIn)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+
+    runs_.clear();
+    parent_.clear();
+    blobs_.clear();
+    blobRoot_.clear();
+
+    const cv::Rect roi = roiIn & cv::Rect(0, 0, mask.cols, mask.rows);
+    if (roi.width <= 0 || roi.height <= 0)
+        return -1;
+
+    // ---------- Runs + union-find ---------- //
+    const int end = roi.x + roi.width;
+    size_t prevBegin = 0, prevEnd = 0; // Runs of the row above
+    for (int y = roi.y; y < roi.y + roi.height; y++)
+    {
+        const uint8_t *row = mask.ptr<uint8_t>(y);
+        const size_t rowBegin = runs_.size();
+        size_t j = prevBegin;
+
+        for (int x = skipZeros(row, roi.x, end); x < end; x = skipZeros(row, x, end))
+        {
+            const int x0 = x;
+            x = skipSet(row, x, end);
+
+            const int run = (int)runs_.size();
+            runs_.push_back({x0, x, y});
+            parent_.push_back(run);
+
+            // Runs above that touch [x0 - 1, x] (diagonal neighbours count), the root is always the earliest run
+            while (j < prevEnd && runs_[j].x1 < x0)
+                j++;
+            for (size_t k = j; k < prevEnd && runs_[k].x0 <= x; k++)
+            {
+                const int a = find(run), b = find((int)k);
+                if (a != b)
+                    parent_[std::max(a, b)] = std::min(a, b);
+            }
+        }
+
+        prevBegin = rowBegin;
+        prevEnd = runs_.size();
+    }
+
+    // ---------- Runs → blobs ---------- //
+    // A root comes before every other run of its blob, so blobs come out in raster order of their seed
+    blobOf_.resize(runs_.size());
+    int largest = -1;
+    for (size_t i = 0; i < runs_.size(); i++)
+    {
+        const Run &r = runs_[i];
+        const int root = find((int)i);
+        if (root == (int)i)
+        {
+            blobOf_[i] = (int)blobs_.size();
+            blobRoot_.push_back(root);
+            blobs_.emplace_back();
+            blobs_.back().seed = cv::Point(r.x0, r.y);
+            blobs_.back().box = cv::Rect(r.x0, r.y, r.x1 - r.x0, 1);
+        }
+        else
+            blobOf_[i] = blobOf_[root];
+
+        Blob &b = blobs_[blobOf_[i]];
+        const int64_t len = r.x1 - r.x0;
+        const int64_t sx = (int64_t)(r.x0 + r.x1 - 1) * len / 2;
+        const int64_t sxx = sumSquares(r.x1 - 1) - sumSquares(r.x0 - 1);
+        b.area += (int)len;
+        b.m10 += (double)sx;
+        b.m01 += (double)r.y * len;
+        b.m20 += (double)sxx;
+        b.m11 += (double)r.y * sx;
+        b.m02 += (double)r.y * r.y * len;
+
+        const int left = std::min(b.box.x, r.x0);
+        const int right = std::max(b.box.x + b.box.width, r.x1);
+        b.box = cv::Rect(left, b.box.y, right - left, r.y + 1 - b.box.y);
+    }
+
+    for (size_t i = 0; i < blobs_.size(); i++)
+    {
+        if (largest == -1 || blobs_[i].area > blobs_[largest].area)
+            largest = (int)i;
+    }
+    return largest;
+}
+
+void BlobLabeler::trace(int index, std::vector<cv::Point> &contour)
+{
+    const Blob &b = blobs_[index];
+    scratch_.create(b.box.height, b.box.width, CV_8UC1);
+    scratch_.setTo(0);
+
+    // Only this blob's runs, anything else inside its box (noise, other blobs) stays background
+    for (size_t i = (size_t)blobRoot_[index]; i < runs_.size() && runs_[i].y < b.box.y + b.box.height; i++)
+    {
+        const Run &r = runs_[i];
+        if (blobOf_[i] == index)
+            std::memset(scratch_.ptr<uint8_t>(r.y - b.box.y) + (r.x0 - b.box.x), 255, (size_t)(r.x1 - r.x0));
+    }
+
+    cv::findContours(scratch_, traced_, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, b.box.tl());
+    contour.clear();
+    if (!traced_.empty())
+        contour.swap(traced_[0]);
+}
+
+// ----------------- largestContour ----------------- //
+int largestContour(const cv::Mat &mask, const cv::Rect &roi, std::vector<std::vector<cv::Point>> &contours, Blob *blob)
+{
+    static thread_local BlobLabeler labeler;
+
+    const int largest = labeler.label(mask, roi);
+    if (largest == -1)
+    {
+        contours.clear();
+        return -1;
+    }
+
+    contours.resize(1);
+    labeler.trace(largest, contours[0]);
+    if (blob)
+        *blob = labeler.blobs()[largest];
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// ----------------- BlobLabeler ----------------- //
+// Connected components of a mask in one raster scan, without tracing any of them
+//  - Each row is cut into runs of non zero pixels, a run joins the runs of the row above it touches
+//    (8-connectivity, same as findContours) through a union-find on run indices
+//  - Area, bounding box and moments are added up per run, then folded into their blob at the end
+//    → a speck of noise costs one run, not a std::vector<cv::Point> + a contourArea
+//  - trace() turns one blob back into its outer contour : only that blob is painted into a scratch mask the size
+//    of its box and handed to findContours, so the points are the ones findContours(RETR_EXTERNAL) gives on the mask
+//  - Buffers are kept between frames, nothing is allocated once they've grown to the usual blob count
+struct Blob
+{
+    int area = 0;   // Pixels
+    cv::Rect box;   // Full frame coordinates
+    cv::Point seed; // First pixel in raster order (top row, leftmost)
+    // Raw moments of the pixels (m00 = area) : centroid = (m10 / m00, m01 / m00)
+    double m10 = 0, m01 = 0, m20 = 0, m11 = 0, m02 = 0;
+
+    cv::Point2d centroid() const { return area > 0 ? cv::Point2d(m10 / area, m01 / area) : cv::Point2d(); }
+};
+
+class BlobLabeler
+{
+public:
+    // Labels mask(roi), any non zero pixel is foreground
+    // Returns the index of the largest blob by area, -1 when the ROI is empty
+    int label(const cv::Mat &mask, const cv::Rect &roi);
+
+    const std::vector<Blob> &blobs() const { return blobs_; }
+
+    // Outer contour of blobs()[index] (CHAIN_APPROX_SIMPLE), full frame coordinates
+    void trace(int index, std::vector<cv::Point> &contour);
+
+private:
+    struct Run
+    {
+        int x0, x1; // [x0, x1) in full frame coordinates
+        int y;
+    };
+
+    int find(int run);
+
+    std::vector<Run> runs_;
+    std::vector<int> parent_;  // Union-find over runs, a root is the first run of its blob
+    std::vector<int> blobOf_;  // Root run → index in blobs_
+    std::vector<Blob> blobs_;
+    std::vector<int> blobRoot_; // Index in blobs_ → root run
+    cv::Mat scratch_;           // One blob painted back for trace()
+    std::vector<std::vector<cv::Point>> traced_;
+};
+
+// Largest blob of mask(roi) traced into contours[0], points in full frame coordinates
+// Returns 0, or -1 when there's no blob (contours is then empty), blob (optional) gets its area / box / moments
+// Largest = most pixels (a blob's holes don't count, unlike cv::contourArea on its contour)
+int largestContour(const cv::Mat &mask, const cv::Rect &roi, std::vector<std::vector<cv::Point>> &contours,
+                   Blob *blob = nullptr);
@@ -0,0 +1,310 @@
+#include "cameraControl.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// ----------------- Names ----------------- //
+std::string controlName(uint32_t id)
+{
+    switch (id)
+    {
+    case V4L2_CID_BRIGHTNESS:
+        return "brightness";
+    case V4L2_CID_CONTRAST:
+        return "contrast";
+    case V4L2_CID_SATURATION:
+        return "saturation";
+    case V4L2_CID_GAIN:
+        return "gain";
+    case V4L2_CID_SHARPNESS:
+        return "sharpness";
+    case V4L2_CID_BACKLIGHT_COMPENSATION:
+        return "backlight_compensation";
+    case V4L2_CID_AUTO_WHITE_BALANCE:
+        return "white_balance_automatic";
+    case V4L2_CID_WHITE_BALANCE_TEMPERATURE:
+        return "white_balance_temperature";
+    case V4L2_CID_POWER_LINE_FREQUENCY:
+        return "power_line_frequency";
+    case V4L2_CID_EXPOSURE_AUTO:
+        return "auto_exposure";
+    case V4L2_CID_EXPOSURE_ABSOLUTE:
+        return "exposure_time_absolute";
+    case V4L2_CID_EXPOSURE_AUTO_PRIORITY:
+        return "exposure_dynamic_framerate";
+    case V4L2_CID_FOCUS_ABSOLUTE:
+        return "focus_absolute";
+    case V4L2_CID_FOCUS_AUTO:
+        return "focus_automatic_continuous";
+    case V4L2_CID_PAN_ABSOLUTE:
+        return "pan_absolute";
+    case V4L2_CID_TILT_ABSOLUTE:
+        return "tilt_absolute";
+    case V4L2_CID_ZOOM_ABSOLUTE:
+        return "zoom_absolute";
+    default:
+    {
+        char hex[16];
+        std::snprintf(hex, sizeof(hex), "0x%08x", id);
+        return hex;
+    }
+    }
+}
+
+std::string ControlResult::message() const
+{
+    std::string text = controlName(id);
+    if (error == 0)
+    {
+        text += " = " + std::to_string(applied);
+        if (applied != requested)
+            text += " (asked for " + std::to_string(requested) + ")";
+        return text;
+    }
+
+    text += " = " + std::to_string(requested) + ": " + std::strerror(error);
+    if (error == EACCES || error == EBUSY)
+        text += " (control is inactive, turn off its 'auto' setting first)";
+    else if (error == EINVAL)
+        text += " (not supported by this camera or bad value)";
+    else if (error == ERANGE)
+        text += " (out of range)";
+    return text;
+}
+
+int printControlResults(const std::vector<ControlResult> &results)
+{
+    int failed = 0;
+    for (const auto &result : results)
+    {
+        if (result.ok())
+            std::cout << "✅ " << result.message() << "\n";
+        else
+        {
+            std::cout << "⚠️ " << result.message() << "\n";
+            failed++;
+        }
+    }
+    return failed;
+}
+
+// ----------------- CameraControl ----------------- //
+CameraControl::~CameraControl()
+{
+    close();
+}
+
+bool CameraControl::open(const std::string &device)
+{
+    close();
+    device_ = device;
+
+    fd_ = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd_ < 0)
+    {
+        std::cerr << "❌ Could not open " << device << " for camera controls: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CameraControl::close()
+{
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+int CameraControl::setBatch(v4l2_ext_control *controls, uint32_t count, uint32_t &errorIndex)
+{
+    v4l2_ext_controls ext{};
+    ext.which = V4L2_CTRL_WHICH_CUR_VAL; // Lets one call mix user + camera class controls
+    ext.count = count;
+    ext.controls = controls;
+
+    int result;
+    do
+    {
+        result = ioctl(fd_, VIDIOC_S_EXT_CTRLS, &ext);
+    } while (result == -1 && errno == EINTR);
+
+    errorIndex = ext.error_idx;
+    return result == -1 ? errno : 0;
+}
+
+ControlResult CameraControl::set(uint32_t id, int32_t value)
+{
+    ControlResult result;
+    result.id = id;
+    result.requested = value;
+
+    if (fd_ < 0)
+    {
+        result.error = EBADF;
+        return result;
+    }
+
+    v4l2_ext_control control{};
+    control.id = id;
+    control.value = value;
+
+    uint32_t errorIndex = 0;
+    result.error = setBatch(&control, 1, errorIndex);
+    result.applied = result.error == 0 ? control.value : value;
+    return result;
+}
+
+std::vector<ControlResult> CameraControl::set(const std::vector<ControlValue> &controls)
+{
+    std::vector<ControlResult> results(controls.size());
+    for (size_t i = 0; i < controls.size(); i++)
+    {
+        results[i].id = controls[i].id;
+        results[i].requested = controls[i].value;
+        results[i].applied = controls[i].value;
+    }
+
+    if (controls.empty())
+        return results;
+
+    if (fd_ < 0)
+    {
+        for (auto &result : results)
+            result.error = EBADF;
+        return results;
+    }
+
+    scratch_.assign(controls.size(), v4l2_ext_control{});
+    for (size_t i = 0; i < controls.size(); i++)
+    {
+        scratch_[i].id = controls[i].id;
+        scratch_[i].value = controls[i].value;
+    }
+
+    // Whole profile in one ioctl, the driver writes back what it actually applied
+    uint32_t errorIndex = 0;
+    int error = setBatch(scratch_.data(), (uint32_t)scratch_.size(), errorIndex);
+    if (error == 0)
+    {
+        for (size_t i = 0; i < controls.size(); i++)
+            results[i].applied = scratch_[i].value;
+        return results;
+    }
+
+    // Batch rejected (error_idx only points at the first bad one and the rest may not have been applied),
+    // go one by one so every control is applied if it can be and gets its own error
+    for (size_t i = 0; i < controls.size(); i++)
+        results[i] = set(controls[i].id, controls[i].value);
+
+    return results;
+}
+
+ControlResult CameraControl::get(uint32_t id)
+{
+    std::vector<ControlResult> results = get(std::vector<uint32_t>{id});
+    return results.front();
+}
+
+std::vector<ControlResult> CameraControl::get(const std::vector<uint32_t> &ids)
+{
+    std::vector<ControlResult> results(ids.size());
+    for (size_t i = 0; i < ids.size(); i++)
+        results[i].id = ids[i];
+
+    if (ids.empty())
+        return results;
+
+    if (fd_ < 0)
+    {
+        for (auto &result : results)
+            result.error = EBADF;
+        return results;
+    }
+
+    scratch_.assign(ids.size(), v4l2_ext_control{});
+    for (size_t i = 0; i < ids.size(); i++)
+        scratch_[i].id = ids[i];
+
+    auto getBatch = [&](v4l2_ext_control *controls, uint32_t count)
+    {
+        v4l2_ext_controls ext{};
+        ext.which = V4L2_CTRL_WHICH_CUR_VAL;
+        ext.count = count;
+        ext.controls = controls;
+
+        int result;
+        do
+        {
+            result = ioctl(fd_, VIDIOC_G_EXT_CTRLS, &ext);
+        } while (result == -1 && errno == EINTR);
+        return result == -1 ? errno : 0;
+    };
+
+    int error = getBatch(scratch_.data(), (uint32_t)scratch_.size());
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        // Same fallback as set(), if the batch fails find out which ones are actually readable
+        if (error != 0)
+            results[i].error = getBatch(&scratch_[i], 1);
+
+        results[i].requested = scratch_[i].value;
+        results[i].applied = scratch_[i].value;
+    }
+    return results;
+}
+
+bool CameraControl::query(uint32_t id, v4l2_query_ext_ctrl &info) const
+{
+    if (fd_ < 0)
+        return false;
+
+    info = v4l2_query_ext_ctrl{};
+    info.id = id;
+    return ioctl(fd_, VIDIOC_QUERY_EXT_CTRL, &info) == 0;
+}
+
+void CameraControl::printControls() const
+{
+    if (fd_ < 0)
+        return;
+
+    v4l2_query_ext_ctrl info{};
+    info.id = V4L2_CTRL_FLAG_NEXT_CTRL;
+
+    while (ioctl(fd_, VIDIOC_QUERY_EXT_CTRL, &info) == 0)
+    {
+        if (info.type == V4L2_CTRL_TYPE_CTRL_CLASS)
+        {
+            std::printf("\n%s\n\n", info.name);
+        }
+        else if (!(info.flags & V4L2_CTRL_FLAG_DISABLED))
+        {
+            v4l2_ext_control control{};
+            control.id = info.id;
+            v4l2_ext_controls ext{};
+            ext.which = V4L2_CTRL_WHICH_CUR_VAL;
+            ext.count = 1;
+            ext.controls = &control;
+            bool haveValue = ioctl(fd_, VIDIOC_G_EXT_CTRLS, &ext) == 0;
+
+            std::printf("%31s 0x%08x : min=%lld max=%lld step=%llu default=%lld",
+                        info.name, info.id, (long long)info.minimum, (long long)info.maximum,
+                        (unsigned long long)info.step, (long long)info.default_value);
+            if (haveValue)
+                std::printf(" value=%d", control.value);
+            if (info.flags & V4L2_CTRL_FLAG_INACTIVE)
+                std::printf(" flags=inactive");
+            std::printf("\n");
+        }
+
+        info.id |= V4L2_CTRL_FLAG_NEXT_CTRL;
+    }
+    std::fflush(stdout);
+}
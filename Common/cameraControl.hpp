@@ -0,0 +1,71 @@
+#pragma once
+
+#include <linux/videodev2.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ----------------- Control values / results ----------------- //
+struct ControlValue
+{
+    uint32_t id = 0; // V4L2_CID_*
+    int32_t value = 0;
+};
+
+// Outcome of setting (or getting) one control
+struct ControlResult
+{
+    uint32_t id = 0;
+    int32_t requested = 0;
+    int32_t applied = 0; // What the driver actually holds (it may clamp / round to step)
+    int error = 0;       // errno, 0 = ok
+
+    bool ok() const { return error == 0; }
+    std::string message() const; // "brightness = 106" / "exposure_time_absolute: Permission denied (control is inactive, ...)"
+};
+
+// ----------------- CameraControl ----------------- //
+// Sets / gets camera controls with VIDIOC_S_EXT_CTRLS / VIDIOC_G_EXT_CTRLS instead of forking v4l2-ctl
+//  - A whole list of controls goes down in ONE ioctl, order is kept (put auto modes before the manual values they unlock)
+//  - If the batch is rejected we fall back to one control at a time so every control gets its own result
+//  - Opens its own fd, V4L2 allows that next to a streaming V4L2Capture
+class CameraControl
+{
+public:
+    CameraControl() = default;
+    ~CameraControl();
+
+    CameraControl(const CameraControl &) = delete;
+    CameraControl &operator=(const CameraControl &) = delete;
+
+    bool open(const std::string &device);
+    void close();
+    bool isOpened() const { return fd_ >= 0; }
+    const std::string &device() const { return device_; }
+
+    // Single control
+    ControlResult set(uint32_t id, int32_t value);
+    ControlResult get(uint32_t id);
+
+    // Batched, one result per control in the same order
+    std::vector<ControlResult> set(const std::vector<ControlValue> &controls);
+    std::vector<ControlResult> get(const std::vector<uint32_t> &ids);
+
+    bool query(uint32_t id, v4l2_query_ext_ctrl &info) const;
+
+    // Same idea as `v4l2-ctl --list-ctrls`
+    void printControls() const;
+
+private:
+    int setBatch(v4l2_ext_control *controls, uint32_t count, uint32_t &errorIndex);
+
+    int fd_ = -1;
+    std::string device_;
+    std::vector<v4l2_ext_control> scratch_; // Reused between calls
+};
+
+// Name v4l2-ctl uses for a control ("brightness", "auto_exposure", ...), falls back to the hex id
+std::string controlName(uint32_t id);
+
+// Prints one line per result, returns how many failed
+int printControlResults(const std::vector<ControlResult> &results);
@@ -0,0 +1,34 @@
+#include "cameraProfile.hpp"
+
+std::vector<ControlValue> controlsFromProfile(const YAML::Node &profile)
+{
+    std::vector<ControlValue> controls;
+
+    auto add = [&](const char *key, uint32_t id)
+    {
+        if (profile[key])
+            controls.push_back({id, profile[key].as<int32_t>()});
+    };
+
+    // Auto modes first
+    if (profile["setAutoExposureValue"])
+    {
+        int value = profile["setAutoExposureValue"].as<int>();
+        controls.push_back({V4L2_CID_EXPOSURE_AUTO, value == 0 ? V4L2_EXPOSURE_MANUAL : V4L2_EXPOSURE_APERTURE_PRIORITY});
+    }
+    add("autofocusEnabled", V4L2_CID_FOCUS_AUTO);
+    add("whiteBalanceAuto", V4L2_CID_AUTO_WHITE_BALANCE);
+
+    // Then the values
+    add("exposureValue", V4L2_CID_EXPOSURE_ABSOLUTE);
+    add("focusValue", V4L2_CID_FOCUS_ABSOLUTE);
+    add("whiteBalanceTemperature", V4L2_CID_WHITE_BALANCE_TEMPERATURE);
+    add("brightness", V4L2_CID_BRIGHTNESS);
+    add("contrast", V4L2_CID_CONTRAST);
+    add("saturation", V4L2_CID_SATURATION);
+    add("gain", V4L2_CID_GAIN);
+    add("sharpness", V4L2_CID_SHARPNESS);
+    add("backlightCompensation", V4L2_CID_BACKLIGHT_COMPENSATION);
+
+    return controls;
+}
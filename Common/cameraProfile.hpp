@@ -0,0 +1,13 @@
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+#include <vector>
+
+#include "cameraControl.hpp"
+
+// ----------------- Camera profile ----------------- //
+// Turns a Camera_Settings_*.yaml (written by SetCameraSettings) into one ordered control batch
+//  - Auto modes go first so the manual values they unlock are accepted in the same ioctl
+//  - Keys that are missing from the file are skipped
+//  - setAutoExposureValue keeps the trackbar meaning : 0 = Manual Mode (1), anything else = Aperture Priority Mode (3)
+std::vector<ControlValue> controlsFromProfile(const YAML::Node &profile);
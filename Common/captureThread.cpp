@@ -0,0 +1,94 @@
+#include "captureThread.hpp"
+
+#include <iostream>
+
+CaptureThread::CaptureThread(FrameSource &source, int ringSlots)
+    : source_(source),
+      ring_(ringSlots, source.frameBytes())
+{
+    if (source_.lossless())
+        directSlot_.data.resize(source.frameBytes());
+}
+
+CaptureThread::~CaptureThread()
+{
+    stop();
+}
+
+void CaptureThread::start()
+{
+    if (thread_.joinable() || running())
+        return;
+
+    stopRequested_.store(false);
+    running_.store(true, std::memory_order_release);
+    if (!source_.lossless())
+        thread_ = std::thread(&CaptureThread::run, this);
+}
+
+void CaptureThread::stop()
+{
+    stopRequested_.store(true);
+    if (thread_.joinable())
+        thread_.join();
+    running_.store(false, std::memory_order_release);
+}
+
+const FrameSlot *CaptureThread::waitNewest(int timeoutMs)
+{
+    if (source_.lossless())
+    {
+        if (!running() || !source_.read(directSlot_, timeoutMs))
+        {
+            running_.store(false, std::memory_order_release);
+            return nullptr;
+        }
+
+        directFrames_++;
+        directSlot_.frameNumber = directFrames_;
+        if (recorder_)
+            recorder_->append(directSlot_);
+        return &directSlot_;
+    }
+
+    // A camera that stalls is waited out (warned once per stall), nullptr only once the capture thread has stopped
+    bool warned = false;
+    while (true)
+    {
+        const FrameSlot *slot = ring_.waitNewest(timeoutMs);
+        if (slot)
+            return slot;
+        if (!running())
+            return ring_.takeNewest(); // Last frame published right before the thread ended, else nullptr
+
+        if (!warned)
+        {
+            std::cerr << "⚠️ No frame from the camera for " << timeoutMs << " ms, still waiting" << std::endl;
+            warned = true;
+        }
+    }
+}
+
+void CaptureThread::run()
+{
+    while (!stopRequested_.load(std::memory_order_relaxed))
+    {
+        FrameSlot &slot = ring_.beginWrite();
+
+        // Short timeout so stop() never waits long on a camera that went quiet
+        if (!source_.read(slot, 200))
+        {
+            ring_.abandonWrite();
+            if (!source_.isOpened())
+                break;
+            continue;
+        }
+
+        if (recorder_)
+            recorder_->append(slot);
+        ring_.publish();
+    }
+
+    running_.store(false, std::memory_order_release);
+    ring_.wakeConsumer();
+}
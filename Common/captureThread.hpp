@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "frameFile.hpp"
+#include "frameRing.hpp"
+#include "frameSource.hpp"
+
+// ----------------- CaptureThread ----------------- //
+// Keeps the driver queue drained on its own thread so a slow frame in the processing loop
+// (findContours on a noisy mask, ORT hiccup, imshow) never backs frames up in the driver
+//  - Each frame is copied into a preallocated ring slot and the driver buffer is handed straight back
+//  - The processing loop calls waitNewest() and always gets the most recent frame, older ones are dropped and counted
+//  - Lossless sources (fast replay) skip the thread, waitNewest() reads the next frame on the caller's thread so none are dropped
+//  - Optional recorder : every frame read is also appended to a FrameRecorder file
+class CaptureThread
+{
+public:
+    // source must already be open (camera started), ringSlots >= 3
+    CaptureThread(FrameSource &source, int ringSlots = 4);
+    ~CaptureThread();
+
+    CaptureThread(const CaptureThread &) = delete;
+    CaptureThread &operator=(const CaptureThread &) = delete;
+
+    // Set before start(), recorder must outlive the thread
+    void setRecorder(FrameRecorder *recorder) { recorder_ = recorder; }
+
+    void start();
+    void stop();
+
+    // Newest frame, valid until the next call. nullptr only once the source is finished / the thread stopped,
+    // a camera that goes quiet is waited on (timeoutMs = how long before warning about it)
+    const FrameSlot *waitNewest(int timeoutMs = 1000);
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    uint64_t captured() const { return source_.lossless() ? directFrames_ : ring_.published(); }
+    uint64_t dropped() const { return ring_.dropped(); }
+
+private:
+    void run();
+
+    FrameSource &source_;
+    FrameRing ring_;
+    FrameRecorder *recorder_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<bool> running_{false};
+
+    // Lossless mode only
+    FrameSlot directSlot_;
+    uint64_t directFrames_ = 0;
+};
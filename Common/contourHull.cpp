@@ -0,0 +1,239 @@
+#include "contourHull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// ----------------- Counting sort ----------------- //
+// order = point indices sorted by (x, y, index), the order cv::convexHull's pointer sort gives.
+// Stable by y then stable by x, both keyed on offsets inside the contour's box
+static void sortPoints(const std::vector<cv::Point> &contour, const cv::Rect &box, std::vector<int> &order)
+{
+    static thread_local std::vector<int> counts, byY;
+    const int n = (int)contour.size();
+
+    counts.assign(box.height + 1, 0);
+    for (const cv::Point &p : contour)
+        counts[p.y - box.y + 1]++;
+    for (int i = 1; i <= box.height; i++)
+        counts[i] += counts[i - 1];
+    byY.resize(n);
+    for (int i = 0; i < n; i++)
+        byY[counts[contour[i].y - box.y]++] = i;
+
+    counts.assign(box.width + 1, 0);
+    for (const cv::Point &p : contour)
+        counts[p.x - box.x + 1]++;
+    for (int i = 1; i <= box.width; i++)
+        counts[i] += counts[i - 1];
+    order.resize(n);
+    for (int i : byY)
+        order[counts[contour[i].x - box.x]++] = i;
+}
+
+// ----------------- Sklansky ----------------- //
+// One quarter of the hull over the sorted points, start → end (either direction), kept step for step like
+// OpenCV's so the same duplicate / collinear point wins. Returns the stack size, stack holds positions in order
+static int sklansky(const std::vector<cv::Point> &contour, const std::vector<int> &order, int start, int end,
+                    int *stack, int nsign, int sign2)
+{
+    auto at = [&](int position) -> const cv::Point & { return contour[order[position]]; };
+    auto sign = [](int64_t v) { return (v > 0) - (v < 0); };
+
+    if (start == end || at(start) == at(end))
+    {
+        stack[0] = start;
+        return 1;
+    }
+
+    const int incr = end > start ? 1 : -1;
+    int pprev = start, pcur = pprev + incr, pnext = pcur + incr;
+    int size = 3;
+    stack[0] = pprev;
+    stack[1] = pcur;
+    stack[2] = pnext;
+
+    end += incr; // One past the end
+    while (pnext != end)
+    {
+        const int cury = at(pcur).y;
+        const int by = at(pnext).y - cury;
+
+        if (sign(by) != nsign)
+        {
+            const int ax = at(pcur).x - at(pprev).x;
+            const int bx = at(pnext).x - at(pcur).x;
+            const int ay = cury - at(pprev).y;
+            const int64_t convexity = (int64_t)ay * bx - (int64_t)ax * by; // > 0 = convex angle
+
+            if (sign(convexity) == sign2 && (ax != 0 || ay != 0))
+            {
+                pprev = pcur;
+                pcur = pnext;
+                pnext += incr;
+                stack[size++] = pnext;
+            }
+            else if (pprev == start)
+            {
+                pcur = pnext;
+                stack[1] = pcur;
+                pnext += incr;
+                stack[2] = pnext;
+            }
+            else
+            {
+                stack[size - 2] = pnext;
+                pcur = pprev;
+                pprev = stack[size - 4];
+                size--;
+            }
+        }
+        else
+        {
+            pnext += incr;
+            stack[size - 1] = pnext;
+        }
+    }
+    return size - 1;
+}
+
+// ----------------- contourHull ----------------- //
+void contourHull(const std::vector<cv::Point> &contour, std::pmr::vector<int> &indices,
+                 std::pmr::vector<cv::Point> *hull)
+{
+    static thread_local std::vector<int> order, stackStorage;
+
+    indices.clear();
+    if (hull)
+        hull->clear();
+    const int n = (int)contour.size();
+    if (n == 0)
+        return;
+
+    cv::Point lo = contour[0], hi = contour[0];
+    for (const cv::Point &p : contour)
+    {
+        lo.x = std::min(lo.x, p.x);
+        lo.y = std::min(lo.y, p.y);
+        hi.x = std::max(hi.x, p.x);
+        hi.y = std::max(hi.y, p.y);
+    }
+    sortPoints(contour, cv::Rect(lo.x, lo.y, hi.x - lo.x + 1, hi.y - lo.y + 1), order);
+
+    // First lowest / highest y in sorted order, like the scan after cv::convexHull's sort
+    int minYPos = 0, maxYPos = 0;
+    for (int i = 1; i < n; i++)
+    {
+        const int y = contour[order[i]].y;
+        if (contour[order[minYPos]].y > y)
+            minYPos = i;
+        if (contour[order[maxYPos]].y < y)
+            maxYPos = i;
+    }
+
+    if (contour[order[0]] == contour[order[n - 1]])
+        indices.push_back(order[0]); // Every point is the same
+    else
+    {
+        // Two quarters share a stack, each one is at most n + 2 long
+        stackStorage.resize(2 * (size_t)n + 4);
+        int *stack = stackStorage.data();
+
+        // ---------- Upper half ---------- //
+        int *tlStack = stack;
+        int tlCount = sklansky(contour, order, 0, maxYPos, tlStack, -1, 1);
+        int *trStack = stack + tlCount;
+        int trCount = sklansky(contour, order, n - 1, maxYPos, trStack, -1, -1);
+
+        // Counter clockwise output (convexHull(..., clockwise = false)) walks the right quarter first
+        std::swap(tlStack, trStack);
+        std::swap(tlCount, trCount);
+
+        for (int i = 0; i < tlCount - 1; i++)
+            indices.push_back(order[tlStack[i]]);
+        for (int i = trCount - 1; i > 0; i--)
+            indices.push_back(order[trStack[i]]);
+        const int stopPos = trCount > 2 ? trStack[1] : tlCount > 2 ? tlStack[tlCount - 2] : -1;
+
+        // ---------- Lower half ---------- //
+        int *blStack = stack;
+        int blCount = sklansky(contour, order, 0, minYPos, blStack, 1, -1);
+        int *brStack = stack + blCount;
+        int brCount = sklansky(contour, order, n - 1, minYPos, brStack, 1, 1);
+
+        // Both halves went through the same point next to an end (flat hull), don't list it twice
+        if (stopPos >= 0)
+        {
+            const int checkPos = blCount > 2 ? blStack[1] : blCount + brCount > 2 ? brStack[2 - blCount] : -1;
+            if (checkPos == stopPos || (checkPos >= 0 && contour[order[checkPos]] == contour[order[stopPos]]))
+            {
+                blCount = std::min(blCount, 2);
+                brCount = std::min(brCount, 2);
+            }
+        }
+
+        for (int i = 0; i < blCount - 1; i++)
+            indices.push_back(order[blStack[i]]);
+        for (int i = brCount - 1; i > 0; i--)
+            indices.push_back(order[brStack[i]]);
+    }
+
+    // ---------- Contour order ---------- //
+    std::sort(indices.begin(), indices.end()); // Hull size, a few dozen at most
+    if (hull)
+    {
+        hull->reserve(indices.size());
+        for (int index : indices)
+            hull->push_back(contour[index]);
+    }
+}
+
+// ----------------- hullDefects ----------------- //
+// convexityDefects' loop : walk the contour between each pair of hull points, keep the farthest point off the edge
+bool hullDefects(const std::vector<cv::Point> &contour, const std::pmr::vector<int> &indices,
+                 std::pmr::vector<cv::Vec4i> &defects)
+{
+    defects.clear();
+    const int n = (int)contour.size();
+    const int hullPoints = (int)indices.size();
+    if (n <= 3 || hullPoints < 3)
+        return true; // 1 or 2 hull points : always convex
+
+    // Hull listed the other way round from the contour → walk it backwards
+    const bool reversed = ((indices[1] > indices[0]) + (indices[2] > indices[1]) + (indices[0] > indices[2])) != 2;
+
+    int current = indices[reversed ? 0 : hullPoints - 1];
+    for (int i = 0; i < hullPoints; i++)
+    {
+        const int next = indices[reversed ? hullPoints - i - 1 : i];
+        if (i > 0 && next < current)
+        {
+            defects.clear();
+            return false; // Only the step closing the hull may go back to the contour's start
+        }
+
+        const cv::Point p0 = contour[current], p1 = contour[next];
+        const double dx0 = p1.x - p0.x;
+        const double dy0 = p1.y - p0.y;
+        const double scale = dx0 == 0 && dy0 == 0 ? 0. : 1. / std::sqrt(dx0 * dx0 + dy0 * dy0);
+
+        int deepest = -1;
+        double depth = 0;
+        for (int j = current + 1 == n ? 0 : current + 1; j != next; j = j + 1 == n ? 0 : j + 1)
+        {
+            const double dx = contour[j].x - p0.x;
+            const double dy = contour[j].y - p0.y;
+            const double dist = std::fabs(-dy0 * dx + dx0 * dy) * scale;
+            if (dist > depth)
+            {
+                depth = dist;
+                deepest = j;
+            }
+        }
+
+        if (deepest != -1)
+            defects.push_back(cv::Vec4i(current, next, deepest, (int)std::lrint(depth * 256)));
+        current = next;
+    }
+    return true;
+}
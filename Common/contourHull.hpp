@@ -0,0 +1,28 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <memory_resource>
+#include <vector>
+
+// ----------------- Contour hull ----------------- //
+// cv::convexHull(contour, indices, false, false) + sort in O(n + width + height) instead of O(n log n)
+//  - Contour points are integer pixels inside a small box : a counting sort by (x, y, index) replaces the pointer sort
+//  - Then OpenCV's own Sklansky scan over the 4 quarters, step for step → the same indices, down to which copy of a
+//    repeated point is kept (findContours traces 1 pixel wide parts out and back, points repeat) and so the same
+//    convexityDefects and numDefects the SVM was trained on
+//  - Not Melkman : its O(n) hull needs a simple polygon and findContours' contours aren't one
+//
+// indices : hull vertices as contour indices, ascending → ready for hullDefects (no extra sort)
+// hull (optional) : contour[indices[i]], in contour order so it's a closed polygon for polylines
+// Output is std::pmr so it can live in a FrameArena (a plain pmr::vector uses the heap like std::vector)
+void contourHull(const std::vector<cv::Point> &contour, std::pmr::vector<int> &indices,
+                 std::pmr::vector<cv::Point> *hull = nullptr);
+
+// ----------------- Hull defects ----------------- //
+// cv::convexityDefects(contour, indices, defects), same values, written into the caller's container
+//  - convexityDefects builds a std::vector of its own on every call and copies it out, this writes in place
+//  - defects : start, end, farthest point (contour indices), depth * 256 rounded, for every hull edge with a point
+//    off it. Empty for 3 contour points or fewer, or fewer than 3 hull points
+//  - false (defects empty) where convexityDefects throws : indices not monotonous (self intersecting contour)
+bool hullDefects(const std::vector<cv::Point> &contour, const std::pmr::vector<int> &indices,
+                 std::pmr::vector<cv::Vec4i> &defects);
@@ -0,0 +1,206 @@
+#include "contourTracker.hpp"
+
+#include <cmath>
+
+#include "blobLabeler.hpp"
+
+// ----------------- Border following ----------------- //
+// findContours' chain codes (y down) : 0 = right, then counter clockwise on screen, 4 = left
+static const cv::Point DELTAS[8] = {{1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+static inline bool isSet(const cv::Mat &mask, const cv::Rect &roi, const cv::Point &p)
+{
+    return roi.contains(p) && mask.ptr<uint8_t>(p.y)[p.x] != 0;
+}
+
+// Border between start's blob and the background pixel next to it in direction zeroDir, the way findContours'
+// icvFetchContour follows it : start with zeroDir = 4 (left) at a blob's first pixel gives its outer contour,
+// point for point. simple = CHAIN_APPROX_SIMPLE (only the points where the direction changes), else every pixel
+static void followBorder(const cv::Mat &mask, const cv::Rect &roi, const cv::Point &start, int zeroDir, bool simple,
+                         std::vector<cv::Point> &out)
+{
+    out.clear();
+
+    // First set neighbour going clockwise from the background one
+    int s = zeroDir;
+    cv::Point i1;
+    do
+    {
+        s = (s - 1) & 7;
+        i1 = start + DELTAS[s];
+    } while (!isSet(mask, roi, i1) && s != zeroDir);
+
+    if (s == zeroDir) // Single pixel blob
+    {
+        out.push_back(start);
+        return;
+    }
+
+    cv::Point i3 = start, i4;
+    int prevS = s ^ 4;
+    for (;;)
+    {
+        // Next set neighbour going counter clockwise
+        while (s < 15)
+        {
+            i4 = i3 + DELTAS[++s & 7];
+            if (isSet(mask, roi, i4))
+                break;
+        }
+        s &= 7;
+
+        if (!simple || s != prevS)
+        {
+            out.push_back(i3);
+            prevS = s;
+        }
+        if (i4 == start && i3 == i1)
+            break;
+
+        i3 = i4;
+        s = (s + 4) & 7;
+    }
+}
+
+// Same arithmetic as HandFeatureExtractor (contourArea / arcLength closed)
+static void areaPerimeter(const std::vector<cv::Point> &contour, double &area, double &perimeter)
+{
+    int64_t twiceArea = 0;
+    perimeter = 0;
+    cv::Point prev = contour.empty() ? cv::Point() : contour.back();
+    for (const cv::Point &p : contour)
+    {
+        twiceArea += (int64_t)prev.x * p.y - (int64_t)prev.y * p.x;
+        const float dx = (float)p.x - (float)prev.x, dy = (float)p.y - (float)prev.y;
+        perimeter += std::sqrt(dx * dx + dy * dy);
+        prev = p;
+    }
+    area = std::fabs((double)twiceArea * 0.5);
+    if (contour.size() < 2)
+        perimeter = 0;
+}
+
+// ----------------- ContourTracker ----------------- //
+ContourTracker::ContourTracker(double areaTolerance, double perimeterTolerance)
+    : areaTolerance_(areaTolerance),
+      perimeterTolerance_(perimeterTolerance)
+{
+}
+
+int ContourTracker::find(const cv::Mat &mask, const cv::Rect &roiIn, std::vector<std::vector<cv::Point>> &contours)
+{
+    if (!enabled_)
+        return largestContour(mask, roiIn, contours);
+
+    searches_++;
+    const cv::Rect roi = roiIn & cv::Rect(0, 0, mask.cols, mask.rows);
+
+    if (last_.empty())
+        noTrack_++;
+    else
+    {
+        contours.resize(1);
+        if (warmStart(mask, roi, contours[0]))
+        {
+            warm_++;
+            return 0;
+        }
+    }
+
+    // ---------- Full trace ---------- //
+    if (largestContour(mask, roi, contours) == -1)
+    {
+        last_.clear();
+        return -1;
+    }
+    remember(contours[0]);
+    return 0;
+}
+
+bool ContourTracker::warmStart(const cv::Mat &mask, const cv::Rect &roi, std::vector<cv::Point> &contour)
+{
+    // ---------- Seed ---------- //
+    // Points of the last contour still set, the first one is the top of the hand : walking up from it is the
+    // shortest way out of the blob, and the edge reached is almost always the outside one
+    cv::Point seed(-1, -1);
+    for (const cv::Point &p : last_)
+    {
+        if (isSet(mask, roi, p))
+        {
+            seed = p;
+            break;
+        }
+    }
+    if (seed.x < 0)
+    {
+        noSeed_++;
+        return false;
+    }
+    while (isSet(mask, roi, seed + DELTAS[2]))
+        seed.y--;
+
+    // ---------- Edge → first pixel ---------- //
+    // Every pixel of that border : the outer one contains the blob's first pixel (smallest y, then x) and goes
+    // counter clockwise on screen (negative shoelace with y down), a hole's goes the other way round
+    followBorder(mask, roi, seed, 2, false, probe_);
+    cv::Point first = probe_[0];
+    int64_t twiceArea = 0;
+    cv::Point prev = probe_.back();
+    for (const cv::Point &p : probe_)
+    {
+        if (p.y < first.y || (p.y == first.y && p.x < first.x))
+            first = p;
+        twiceArea += (int64_t)prev.x * p.y - (int64_t)prev.y * p.x;
+        prev = p;
+    }
+    if (twiceArea > 0)
+    {
+        holes_++;
+        return false;
+    }
+
+    // ---------- Trace ---------- //
+    followBorder(mask, roi, first, 4, true, contour);
+
+    double area, perimeter;
+    areaPerimeter(contour, area, perimeter);
+    if (std::fabs(area - lastArea_) > areaTolerance_ * lastArea_ ||
+        std::fabs(perimeter - lastPerimeter_) > perimeterTolerance_ * lastPerimeter_)
+    {
+        jumps_++;
+        return false;
+    }
+
+    last_ = contour;
+    lastArea_ = area;
+    lastPerimeter_ = perimeter;
+    return true;
+}
+
+void ContourTracker::remember(const std::vector<cv::Point> &contour)
+{
+    last_ = contour;
+    areaPerimeter(contour, lastArea_, lastPerimeter_);
+}
+
+void ContourTracker::reset()
+{
+    last_.clear();
+    lastArea_ = lastPerimeter_ = 0;
+}
+
+void ContourTracker::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+    reset();
+}
+
+void ContourTracker::printStats(std::ostream &out) const
+{
+    if (searches_ == 0)
+        return;
+
+    out << "Contour tracker: " << searches_ << " searches, " << warm_ << " warm started ("
+        << 100.0 * warm_ / searches_ << "%), full traces : " << noTrack_ << " no last contour, " << noSeed_
+        << " no seed, " << holes_ << " seed on a hole, " << jumps_ << " area / perimeter jumps\n";
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// ----------------- ContourTracker ----------------- //
+// Hand contour warm started from the last frame's instead of labelling the whole ROI every frame
+//  - Seed : a point of the last contour that is still set in the new mask, walked up to the blob's edge
+//  - The border through the seed is followed to the blob's first pixel (top row, leftmost), then traced from there
+//    with findContours' own border following (CHAIN_APPROX_SIMPLE) → the same points largestContour() gives for that blob
+//  - Cost is the length of the contour, not the area of the ROI
+//  - Full trace (largestContour, largest blob of the ROI) when there is no last contour, no seed lands in the mask,
+//    the seed's edge is a hole of the blob, or area / perimeter moved more than the tolerance since the last frame
+class ContourTracker
+{
+public:
+    explicit ContourTracker(double areaTolerance = 0.25, double perimeterTolerance = 0.25);
+
+    // Drop in for largestContour(mask, roi, contours) : contours[0] = hand, returns 0 (or -1 = none)
+    //  - Only mask(roi) is read, anything outside it counts as background
+    int find(const cv::Mat &mask, const cv::Rect &roi, std::vector<std::vector<cv::Point>> &contours);
+
+    void reset();
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_; }
+
+    // Searches, how many were warm started, and why the others needed a full trace
+    void printStats(std::ostream &out) const;
+
+private:
+    bool warmStart(const cv::Mat &mask, const cv::Rect &roi, std::vector<cv::Point> &contour);
+    void remember(const std::vector<cv::Point> &contour);
+
+    double areaTolerance_;
+    double perimeterTolerance_;
+    bool enabled_ = true;
+
+    std::vector<cv::Point> last_; // Last frame's hand, empty = none
+    double lastArea_ = 0;
+    double lastPerimeter_ = 0;
+    std::vector<cv::Point> probe_;
+
+    uint64_t searches_ = 0;
+    uint64_t warm_ = 0;
+    uint64_t noTrack_ = 0;
+    uint64_t noSeed_ = 0;
+    uint64_t holes_ = 0;
+    uint64_t jumps_ = 0;
+};
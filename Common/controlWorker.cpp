@@ -0,0 +1,124 @@
+#include "controlWorker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// Auto modes have to land before the manual values they unlock
+static bool isAutoControl(uint32_t id)
+{
+    return id == V4L2_CID_EXPOSURE_AUTO || id == V4L2_CID_FOCUS_AUTO || id == V4L2_CID_AUTO_WHITE_BALANCE;
+}
+
+ControlWorker::ControlWorker(CameraControl &camera, int maxRateHz)
+    : camera_(camera),
+      periodMs_(maxRateHz > 0 ? 1000 / maxRateHz : 0)
+{
+    batch_.reserve(MAX_CONTROLS);
+}
+
+ControlWorker::~ControlWorker()
+{
+    stop();
+}
+
+void ControlWorker::start()
+{
+    if (thread_.joinable())
+        return;
+
+    stopRequested_.store(false);
+    thread_ = std::thread(&ControlWorker::run, this);
+}
+
+void ControlWorker::stop()
+{
+    if (!thread_.joinable())
+        return;
+
+    stopRequested_.store(true);
+    waitCv_.notify_one();
+    thread_.join();
+}
+
+bool ControlWorker::post(uint32_t id, int32_t value)
+{
+    if (id == 0)
+        return false;
+
+    for (Slot &slot : slots_)
+    {
+        uint32_t current = slot.id.load(std::memory_order_acquire);
+        if (current == 0)
+        {
+            // Free slot, claim it (another thread may beat us to it with the same or another id)
+            if (!slot.id.compare_exchange_strong(current, id, std::memory_order_acq_rel) && current != id)
+                continue;
+        }
+        else if (current != id)
+            continue;
+
+        slot.value.store(value, std::memory_order_relaxed);
+        slot.dirty.store(true, std::memory_order_release);
+        posted_.fetch_add(1, std::memory_order_relaxed);
+
+        pending_.store(true, std::memory_order_release);
+        waitCv_.notify_one(); // No lock, worst case the worker picks it up on its next timeout
+        return true;
+    }
+
+    std::cerr << "⚠️ ControlWorker has no free slot for " << controlName(id) << std::endl;
+    return false;
+}
+
+void ControlWorker::flush()
+{
+    pending_.store(false, std::memory_order_release);
+
+    batch_.clear();
+    for (Slot &slot : slots_)
+    {
+        uint32_t id = slot.id.load(std::memory_order_acquire);
+        if (id == 0)
+            break; // Slots are claimed in order, nothing after this one
+        if (!slot.dirty.exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        // A post() landing right after the exchange re-marks the slot, so it's sent again next round
+        batch_.push_back({id, slot.value.load(std::memory_order_relaxed)});
+    }
+
+    if (batch_.empty())
+        return;
+
+    std::stable_partition(batch_.begin(), batch_.end(), [](const ControlValue &control)
+                          { return isAutoControl(control.id); });
+
+    std::vector<ControlResult> results = camera_.set(batch_);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    applied_.fetch_add(results.size(), std::memory_order_relaxed);
+    failed_.fetch_add(printControlResults(results), std::memory_order_relaxed);
+}
+
+void ControlWorker::run()
+{
+    auto nextAllowed = std::chrono::steady_clock::now();
+
+    while (!stopRequested_.load(std::memory_order_acquire))
+    {
+        {
+            std::unique_lock<std::mutex> lock(waitMutex_);
+            waitCv_.wait_for(lock, std::chrono::milliseconds(100), [&]
+                             { return pending_.load(std::memory_order_acquire) || stopRequested_.load(std::memory_order_acquire); });
+        }
+        if (!pending_.load(std::memory_order_acquire))
+            continue;
+
+        // Rate limit : anything posted while we sleep here just overwrites its slot
+        std::this_thread::sleep_until(nextAllowed);
+        flush();
+        nextAllowed = std::chrono::steady_clock::now() + std::chrono::milliseconds(periodMs_);
+    }
+
+    flush(); // Don't lose the last slider position on exit
+}
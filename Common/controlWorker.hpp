@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cameraControl.hpp"
+
+// ----------------- ControlWorker ----------------- //
+// Applies camera controls on a background thread so trackbar callbacks never touch the camera
+//  - post() only stores the value in that control's slot, it never blocks on camera I/O
+//  - "Latest value wins" : dragging a slider overwrites the slot, the worker only sends the newest value
+//  - The worker wakes up at most maxRateHz times a second and sends everything that changed in one batch
+//  - Auto modes are put first in the batch so a manual value posted together with its auto switch is accepted
+class ControlWorker
+{
+public:
+    static const int MAX_CONTROLS = 32;
+
+    ControlWorker(CameraControl &camera, int maxRateHz = 30);
+    ~ControlWorker();
+
+    ControlWorker(const ControlWorker &) = delete;
+    ControlWorker &operator=(const ControlWorker &) = delete;
+
+    void start();
+    void stop(); // Sends whatever is still pending, then joins
+
+    // Safe to call from any thread (trackbar callbacks). false if all slots are taken by other controls
+    bool post(uint32_t id, int32_t value);
+
+    uint64_t posted() const { return posted_.load(std::memory_order_relaxed); }
+    uint64_t applied() const { return applied_.load(std::memory_order_relaxed); } // Values actually sent to the driver
+    uint64_t batches() const { return batches_.load(std::memory_order_relaxed); } // ioctls issued
+    uint64_t failed() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> id{0}; // 0 = unused, claimed once with CAS and never released
+        std::atomic<int32_t> value{0};
+        std::atomic<bool> dirty{false};
+    };
+
+    void run();
+    void flush();
+
+    CameraControl &camera_;
+    int periodMs_;
+
+    Slot slots_[MAX_CONTROLS];
+    std::atomic<bool> pending_{false};
+
+    std::vector<ControlValue> batch_; // Worker thread only
+
+    std::thread thread_;
+    std::atomic<bool> stopRequested_{false};
+    std::mutex waitMutex_; // Only parks the idle worker, post() never takes it
+    std::condition_variable waitCv_;
+
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> failed_{0};
+};
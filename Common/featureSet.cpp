@@ -0,0 +1,80 @@
+#include "featureSet.hpp"
+
+#include <algorithm>
+
+int featureWidth(int version)
+{
+    switch (version)
+    {
+    case FEATURES_V1:
+        return HAND_FEATURE_COUNT;
+    case FEATURES_V2:
+        return HAND_FEATURE_COUNT + FINGER_FEATURE_COUNT;
+    case FEATURES_V3:
+        return HAND_FEATURE_COUNT + FINGER_FEATURE_COUNT + SHAPE_FEATURE_COUNT;
+    default:
+        return 0;
+    }
+}
+
+int featureVersionForWidth(int width)
+{
+    for (int version = FEATURES_V1; version <= FEATURE_VERSION_LATEST; version++)
+    {
+        if (featureWidth(version) == width)
+            return version;
+    }
+    return 0;
+}
+
+std::string featureCsvHeader(int version)
+{
+    if (featureWidth(version) == 0)
+        return std::string();
+
+    std::string header = HAND_FEATURE_CSV_HEADER;
+    if (version >= FEATURES_V2)
+        header += std::string(",") + FINGER_FEATURE_CSV_HEADER;
+    if (version >= FEATURES_V3)
+        header += std::string(",") + SHAPE_FEATURE_CSV_HEADER;
+    return header;
+}
+
+FeatureSet::FeatureSet(int version)
+    : version_(version),
+      width_(featureWidth(version))
+{
+}
+
+void FeatureSet::extract(const std::vector<cv::Point> &contour, int threshVal, int depthLevel, HandGeometry &geometry)
+{
+    // ---------- Blocks, each from the hull / defects of the first ---------- //
+    hand_.extract(contour, threshVal, depthLevel, geometry, handFeatures_);
+    if (version_ >= FEATURES_V2)
+        finger_.extract(contour, geometry.defects, geometry.box, (float)depthLevel, fingers_, fingerFeatures_);
+    if (version_ >= FEATURES_V3)
+        shape_.extract(contour, geometry, shapeFeatures_);
+
+    // ---------- Row ---------- //
+    // Same order as featureCsvHeader(version_)
+    float *row = std::copy(handFeatures_.begin(), handFeatures_.end(), row_.data());
+    if (version_ >= FEATURES_V2)
+        row = std::copy(fingerFeatures_.begin(), fingerFeatures_.end(), row);
+    if (version_ >= FEATURES_V3)
+        std::copy(shapeFeatures_.begin(), shapeFeatures_.end(), row);
+}
+
+void FeatureSet::writeCsv(std::ostream &out) const
+{
+    HandFeatureExtractor::writeCsv(out, handFeatures_);
+    if (version_ >= FEATURES_V2)
+    {
+        out << ",";
+        FingerExtractor::writeCsv(out, fingerFeatures_);
+    }
+    if (version_ >= FEATURES_V3)
+    {
+        out << ",";
+        ShapeDescriptorExtractor::writeCsv(out, shapeFeatures_);
+    }
+}
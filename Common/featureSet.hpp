@@ -0,0 +1,78 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "fingerGeometry.hpp"
+#include "handFeatures.hpp"
+#include "shapeDescriptors.hpp"
+
+// ----------------- FeatureSet ----------------- //
+// Which features a CSV holds and a model takes, by version number : a model trained on version N gets version N rows
+//  - Version 1 : the 9 hand features (every CSV and model up to now)
+//  - Version 2 : + the finger block (7, FingerExtractor)
+//  - Version 3 : + the shape block (15, ShapeDescriptorExtractor)
+//  - Blocks are only ever appended, each version has its own width (9 / 16 / 31) and CSV header : testGestures picks
+//    the version from the model's input width, gatherData won't append rows of one version to a CSV of another
+//  - extract() runs the blocks of its version and lays them out in one float row (the ONNX input, the CSV row)
+enum FeatureVersion
+{
+    FEATURES_V1 = 1,
+    FEATURES_V2,
+    FEATURES_V3,
+    FEATURE_VERSION_LATEST = FEATURES_V3
+};
+
+constexpr int MAX_FEATURE_WIDTH = HAND_FEATURE_COUNT + FINGER_FEATURE_COUNT + SHAPE_FEATURE_COUNT;
+
+// Features in a version's row, 0 for a version that doesn't exist
+int featureWidth(int version);
+
+// The version with that many features, 0 for none (a model trained on something else)
+int featureVersionForWidth(int width);
+
+// CSV column names of a version's row (gatherData adds gesture_label), empty for a version that doesn't exist
+std::string featureCsvHeader(int version);
+
+class FeatureSet
+{
+public:
+    // version : FEATURES_V1 .. FEATURE_VERSION_LATEST
+    explicit FeatureSet(int version = FEATURES_V1);
+
+    // contour : the hand (largestContour), threshVal / depthLevel : what the frame was processed with
+    // geometry : filled with the hull / defects / box the blocks came from (drawing)
+    void extract(const std::vector<cv::Point> &contour, int threshVal, int depthLevel, HandGeometry &geometry);
+
+    int version() const { return version_; }
+    int width() const { return width_; }
+
+    // The last row, width() floats
+    float *data() { return row_.data(); }
+    const float *data() const { return row_.data(); }
+
+    const HandFeatureVector &handFeatures() const { return handFeatures_; }
+    const FingerGeometry &fingers() const { return fingers_; } // Version 2 on, tipCount 0 before
+
+    // The row, without the label ("60,20,31,9,...")
+    void writeCsv(std::ostream &out) const;
+
+private:
+    int version_;
+    int width_;
+
+    HandFeatureExtractor hand_;
+    FingerExtractor finger_;
+    ShapeDescriptorExtractor shape_;
+
+    HandFeatureVector handFeatures_{};
+    FingerFeatureVector fingerFeatures_{};
+    ShapeFeatureVector shapeFeatures_{};
+    FingerGeometry fingers_;
+
+    std::array<float, MAX_FEATURE_WIDTH> row_{};
+};
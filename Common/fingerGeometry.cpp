@@ -0,0 +1,135 @@
+#include "fingerGeometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const char *const FINGER_FEATURE_CSV_HEADER =
+    "fingers,finger_gaps,gap_angle,gap_depth_ratio,palm_x,palm_y,palm_radius_ratio";
+
+FingerExtractor::FingerExtractor(float maxAngle, float tipMerge)
+    : cosMax_((float)std::cos(maxAngle * CV_PI / 180.0)),
+      tipMerge_(tipMerge)
+{
+}
+
+void FingerExtractor::extract(const std::vector<cv::Point> &contour, const cv::Vec4i *defects, size_t count,
+                              const cv::Rect &box, float minDepth, FingerGeometry &fingers, FingerFeatureVector &features)
+{
+    // ---------- Unpack (SoA) ---------- //
+    startX_.resize(count);
+    startY_.resize(count);
+    endX_.resize(count);
+    endY_.resize(count);
+    farX_.resize(count);
+    farY_.resize(count);
+    depth_.resize(count);
+    keep_.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const cv::Point &start = contour[defects[i][0]], &end = contour[defects[i][1]], &far = contour[defects[i][2]];
+        startX_[i] = (float)start.x;
+        startY_[i] = (float)start.y;
+        endX_[i] = (float)end.x;
+        endY_[i] = (float)end.y;
+        farX_[i] = (float)far.x;
+        farY_[i] = (float)far.y;
+        depth_[i] = defects[i][3] / 256.0f;
+    }
+
+    // ---------- Keep mask, every defect at once ---------- //
+    // angle < maxAngle ⇔ cos > cosMax, cos = dot / sqrt(lengths). x * |x| only ever grows with x, so compared that way
+    // on both sides : dot * |dot| > cosMax * |cosMax| * lengths, no sqrt and no branch on which side of 90° it is
+    const float cosMax2 = cosMax_ * std::fabs(cosMax_);
+    const float *sx = startX_.data(), *sy = startY_.data(), *ex = endX_.data(), *ey = endY_.data();
+    const float *fx = farX_.data(), *fy = farY_.data(), *depth = depth_.data();
+    unsigned char *keep = keep_.data();
+    for (size_t i = 0; i < count; i++)
+    {
+        const float ax = sx[i] - fx[i], ay = sy[i] - fy[i];
+        const float bx = ex[i] - fx[i], by = ey[i] - fy[i];
+        const float dot = ax * bx + ay * by;
+        const float lengths = (ax * ax + ay * ay) * (bx * bx + by * by);
+        keep[i] = (depth[i] > minDepth) & (dot * std::fabs(dot) > cosMax2 * lengths);
+    }
+
+    // ---------- Gaps → tips, palm ---------- //
+    // Only the kept few from here on
+    const float merge = tipMerge_ * (float)std::max(box.width, box.height);
+    const float merge2 = merge * merge;
+    auto addTip = [&](float x, float y)
+    {
+        if (fingers.tipCount > 0)
+        {
+            const cv::Point &last = fingers.tips[fingers.tipCount - 1];
+            const float dx = x - last.x, dy = y - last.y;
+            if (dx * dx + dy * dy < merge2)
+                return;
+        }
+        if (fingers.tipCount < MAX_FINGERTIPS)
+            fingers.tips[fingers.tipCount++] = cv::Point((int)x, (int)y);
+    };
+
+    fingers.gaps = 0;
+    fingers.tipCount = 0;
+    double angleSum = 0, depthSum = 0, palmX = 0, palmY = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!keep[i])
+            continue;
+
+        fingers.gaps++;
+        const float ax = sx[i] - fx[i], ay = sy[i] - fy[i];
+        const float bx = ex[i] - fx[i], by = ey[i] - fy[i];
+        const float lengths = std::sqrt((ax * ax + ay * ay) * (bx * bx + by * by));
+        angleSum += std::acos(std::clamp((ax * bx + ay * by) / lengths, -1.0f, 1.0f)) * 180.0 / CV_PI;
+        depthSum += depth[i];
+        palmX += fx[i];
+        palmY += fy[i];
+        addTip(sx[i], sy[i]);
+        addTip(ex[i], ey[i]);
+    }
+
+    // Around the hand and back : the last gap's end can be the first one's start
+    if (fingers.tipCount > 2)
+    {
+        const cv::Point &first = fingers.tips[0], &last = fingers.tips[fingers.tipCount - 1];
+        const float dx = (float)(last.x - first.x), dy = (float)(last.y - first.y);
+        if (dx * dx + dy * dy < merge2)
+            fingers.tipCount--;
+    }
+
+    fingers.palmRadius = 0;
+    if (fingers.gaps > 0)
+    {
+        fingers.palmCentre = cv::Point2f((float)(palmX / fingers.gaps), (float)(palmY / fingers.gaps));
+        double radius = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (keep[i])
+                radius += std::hypot(fx[i] - fingers.palmCentre.x, fy[i] - fingers.palmCentre.y);
+        }
+        fingers.palmRadius = (float)(radius / fingers.gaps);
+    }
+    else
+        fingers.palmCentre = cv::Point2f(box.x + box.width * 0.5f, box.y + box.height * 0.5f);
+
+    // ---------- Feature block ---------- //
+    const float width = box.width > 0 ? (float)box.width : 1.0f, height = box.height > 0 ? (float)box.height : 1.0f;
+    features[FEATURE_FINGERS] = (float)(fingers.gaps > 0 ? fingers.tipCount : 0);
+    features[FEATURE_FINGER_GAPS] = (float)fingers.gaps;
+    features[FEATURE_GAP_ANGLE] = fingers.gaps > 0 ? (float)(angleSum / fingers.gaps) : 0.0f;
+    features[FEATURE_GAP_DEPTH_RATIO] = fingers.gaps > 0 ? (float)(depthSum / fingers.gaps) / height : 0.0f;
+    features[FEATURE_PALM_X] = (fingers.palmCentre.x - box.x) / width;
+    features[FEATURE_PALM_Y] = (fingers.palmCentre.y - box.y) / height;
+    features[FEATURE_PALM_RADIUS_RATIO] = fingers.palmRadius / height;
+}
+
+void FingerExtractor::writeCsv(std::ostream &out, const FingerFeatureVector &features)
+{
+    // Enough digits to read back the exact float, like the hand features
+    const std::streamsize precision = out.precision(std::numeric_limits<float>::max_digits10);
+    for (int i = 0; i < FINGER_FEATURE_COUNT; i++)
+        out << (i ? "," : "") << features[i];
+    out.precision(precision);
+}
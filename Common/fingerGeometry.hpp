@@ -0,0 +1,85 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <ostream>
+#include <vector>
+
+// ----------------- FingerExtractor ----------------- //
+// Fingers from the hull's convexity defects : a defect is a gap between two fingers when it's deep enough and the
+// angle at its far point (start - far - end) is narrow enough
+//  - Depth alone (DetectNumberOfFingers' depth > 10) also takes the wide dips along the palm and the wrist, between
+//    two fingers the angle is well under 90°
+//  - All the defects are scored at once : start / end / far / depth unpacked into one array per coordinate (SoA),
+//    then one branch free loop over them for the keep mask (squared cosines, no sqrt / acos, vectorised at -O3)
+//  - Fingertips = start / end of the kept gaps, the two ends of neighbouring gaps on the same finger are merged
+//  - Palm centre = mean of the kept gaps' far points, radius = their mean distance to it. Those are the finger roots :
+//    the estimate sits at the top of the palm, not its middle, steady enough for a feature. Box centre with no gap
+//  - Arrays are kept between frames, nothing is allocated once they've grown to the usual defect count
+enum FingerFeature
+{
+    FEATURE_FINGERS,           // Fingertips found, 0 when there's no gap (a fist and one finger look the same)
+    FEATURE_FINGER_GAPS,       // Defects kept as gaps between fingers
+    FEATURE_GAP_ANGLE,         // Mean angle at the kept gaps' far points, degrees (0 = no gap)
+    FEATURE_GAP_DEPTH_RATIO,   // Mean depth of the kept gaps / box height
+    FEATURE_PALM_X,            // Palm centre in the bounding box, 0 .. 1
+    FEATURE_PALM_Y,
+    FEATURE_PALM_RADIUS_RATIO, // Palm radius / box height
+    FINGER_FEATURE_COUNT
+};
+
+using FingerFeatureVector = std::array<float, FINGER_FEATURE_COUNT>;
+
+// CSV column names of the finger block, in FingerFeature order (written after the hand features when logged)
+extern const char *const FINGER_FEATURE_CSV_HEADER;
+
+constexpr int MAX_FINGERTIPS = 10;
+
+struct FingerGeometry
+{
+    int gaps = 0;
+    int tipCount = 0;
+    std::array<cv::Point, MAX_FINGERTIPS> tips; // Contour order
+    cv::Point2f palmCentre;
+    float palmRadius = 0;
+};
+
+class FingerExtractor
+{
+public:
+    // maxAngle : widest far point angle still taken as a gap, degrees
+    // tipMerge : gap ends closer than tipMerge * the box's longer side are the same fingertip
+    explicit FingerExtractor(float maxAngle = 90.0f, float tipMerge = 0.1f);
+
+    // defects : convexityDefects / hullDefects of contour, box : its bounding box
+    // minDepth : shallowest gap in pixels (the depthLevel trackbar)
+    void extract(const std::vector<cv::Point> &contour, const std::pmr::vector<cv::Vec4i> &defects, const cv::Rect &box,
+                 float minDepth, FingerGeometry &fingers, FingerFeatureVector &features)
+    {
+        extract(contour, defects.data(), defects.size(), box, minDepth, fingers, features);
+    }
+    void extract(const std::vector<cv::Point> &contour, const std::vector<cv::Vec4i> &defects, const cv::Rect &box,
+                 float minDepth, FingerGeometry &fingers, FingerFeatureVector &features)
+    {
+        extract(contour, defects.data(), defects.size(), box, minDepth, fingers, features);
+    }
+
+    // Which of the last extract()'s defects were kept as gaps (for drawing)
+    bool kept(size_t defect) const { return defect < keep_.size() && keep_[defect]; }
+
+    // Same block, one CSV row fragment ("3,2,41.5,...")
+    static void writeCsv(std::ostream &out, const FingerFeatureVector &features);
+
+private:
+    void extract(const std::vector<cv::Point> &contour, const cv::Vec4i *defects, size_t count, const cv::Rect &box,
+                 float minDepth, FingerGeometry &fingers, FingerFeatureVector &features);
+
+    float cosMax_;
+    float tipMerge_;
+
+    // One array per coordinate, index = defect
+    std::vector<float> startX_, startY_, endX_, endY_, farX_, farY_, depth_;
+    std::vector<unsigned char> keep_;
+};
@@ -0,0 +1,58 @@
+#include "frameArena.hpp"
+
+#include <algorithm>
+
+FrameArena::FrameArena(size_t bytes)
+    : buffer_(new std::byte[std::max<size_t>(bytes, 1024)]),
+      capacity_(std::max<size_t>(bytes, 1024))
+{
+    monotonic_.emplace(buffer_.get(), capacity_, &spill_);
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    used_ += bytes;
+    return monotonic_->allocate(bytes, alignment);
+}
+
+void FrameArena::reset()
+{
+    frames_++;
+    peak_ = std::max(peak_, used_);
+
+    if (spill_.count == 0)
+        monotonic_->release(); // Back to the start of the buffer
+    else
+    {
+        // Didn't fit : a buffer with room for this frame twice over, the old one and the spilled blocks go
+        spilledFrames_++;
+        const size_t bytes = std::max(capacity_ * 2, used_ * 2);
+        monotonic_.reset();
+        buffer_.reset(new std::byte[bytes]);
+        capacity_ = bytes;
+        monotonic_.emplace(buffer_.get(), capacity_, &spill_);
+        spill_.count = 0;
+    }
+    used_ = 0;
+}
+
+void FrameArena::printStats(std::ostream &out) const
+{
+    if (frames_ == 0)
+        return;
+
+    out << "Frame arena: " << frames_ << " frames, peak " << peak_ / 1024.0 << " KB of " << capacity_ / 1024
+        << " KB, " << spilledFrames_ << " frames spilled onto the heap (buffer grown after each)\n";
+}
+
+// ----------------- Spill ----------------- //
+void *FrameArena::Spill::do_allocate(size_t bytes, size_t alignment)
+{
+    count++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void FrameArena::Spill::do_deallocate(void *p, size_t bytes, size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+
+// ----------------- FrameArena ----------------- //
+// Memory for the geometry a frame builds and throws away (hull, hull indices, defects), out of one buffer
+//  - std::pmr containers built on resource() take their memory from a monotonic_buffer_resource over that buffer :
+//    a pointer bump, no malloc, and no free (deallocate does nothing)
+//  - reset() once per frame hands everything back at once, containers built on it must be gone by then
+//  - A frame needing more than the buffer spills onto the heap (counted), the next reset() grows the buffer to twice
+//    that frame's peak → only the first frames ever allocate
+//  - One per processing loop, not thread safe
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    explicit FrameArena(size_t bytes = 64 * 1024);
+
+    std::pmr::memory_resource *resource() { return this; }
+
+    // End of a frame : everything handed out since the last reset() is released
+    void reset();
+
+    // Bytes handed out this frame (requested sizes, alignment padding not counted)
+    size_t used() const { return used_; }
+    size_t capacity() const { return capacity_; }
+
+    // Frames, peak bytes per frame, frames that spilled onto the heap, buffer size
+    void printStats(std::ostream &out) const;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+    // Heap behind the buffer, only reached when a frame doesn't fit
+    class Spill : public std::pmr::memory_resource
+    {
+    public:
+        uint64_t count = 0;
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t capacity_;
+    Spill spill_;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+
+    size_t used_ = 0;
+    size_t peak_ = 0;
+    uint64_t frames_ = 0;
+    uint64_t spilledFrames_ = 0;
+};
@@ -0,0 +1,200 @@
+#include "frameFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char FRAME_FILE_MAGIC[8] = {'H', 'G', 'F', 'R', 'A', 'M', 'E', '1'};
+
+// ----------------- FrameRecorder ----------------- //
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const std::string &path, int width, int height, size_t stride, uint32_t pixelFormat)
+{
+    close();
+    path_ = path;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+    {
+        std::cerr << "❌ Could not create recording " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    header_ = FrameFileHeader{};
+    std::memcpy(header_.magic, FRAME_FILE_MAGIC, sizeof(header_.magic));
+    header_.version = FRAME_FILE_VERSION;
+    header_.headerBytes = sizeof(FrameFileHeader);
+    header_.width = (uint32_t)width;
+    header_.height = (uint32_t)height;
+    header_.stride = (uint32_t)stride;
+    header_.pixelFormat = pixelFormat;
+    header_.frameBytes = (uint32_t)(stride * (size_t)height);
+    header_.recordBytes = (uint32_t)((sizeof(FrameRecordHeader) + header_.frameBytes + 63) & ~(size_t)63);
+    header_.frameCount = 0;
+
+    frames_ = 0;
+    capacity_ = 0;
+    if (!reserve(GROW_RECORDS))
+    {
+        close();
+        return false;
+    }
+
+    std::memcpy(map_, &header_, sizeof(header_));
+    return true;
+}
+
+bool FrameRecorder::reserve(uint64_t records)
+{
+    size_t bytes = sizeof(FrameFileHeader) + (size_t)records * header_.recordBytes;
+    if (ftruncate(fd_, (off_t)bytes) != 0)
+    {
+        std::cerr << "❌ Could not grow recording " << path_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    void *map = map_ ? mremap(map_, mapBytes_, bytes, MREMAP_MAYMOVE)
+                     : mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED)
+    {
+        std::cerr << "❌ Could not map recording " << path_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    map_ = (uint8_t *)map;
+    mapBytes_ = bytes;
+    capacity_ = records;
+    return true;
+}
+
+bool FrameRecorder::append(const FrameSlot &slot)
+{
+    if (fd_ < 0)
+        return false;
+
+    if (frames_ == capacity_ && !reserve(capacity_ + GROW_RECORDS))
+        return false;
+
+    uint8_t *record = map_ + sizeof(FrameFileHeader) + (size_t)frames_ * header_.recordBytes;
+    size_t bytes = slot.bytesUsed < header_.frameBytes ? slot.bytesUsed : header_.frameBytes;
+
+    FrameRecordHeader recordHeader;
+    recordHeader.timestampNs = slot.timestampNs;
+    recordHeader.sequence = slot.sequence;
+    recordHeader.bytesUsed = (uint32_t)bytes;
+
+    std::memcpy(record + sizeof(FrameRecordHeader), slot.data.data(), bytes);
+    std::memcpy(record, &recordHeader, sizeof(recordHeader));
+    frames_++;
+    return true;
+}
+
+void FrameRecorder::close()
+{
+    if (fd_ < 0)
+        return;
+
+    if (map_)
+    {
+        header_.frameCount = frames_;
+        std::memcpy(map_, &header_, sizeof(header_));
+        munmap(map_, mapBytes_);
+        map_ = nullptr;
+        mapBytes_ = 0;
+    }
+
+    // Drop the unused tail of the last grow step
+    if (ftruncate(fd_, (off_t)(sizeof(FrameFileHeader) + (size_t)frames_ * header_.recordBytes)) != 0)
+        std::cerr << "⚠️ Could not trim recording " << path_ << ": " << std::strerror(errno) << std::endl;
+
+    ::close(fd_);
+    fd_ = -1;
+}
+
+// ----------------- FrameReader ----------------- //
+FrameReader::~FrameReader()
+{
+    close();
+}
+
+bool FrameReader::open(const std::string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "❌ Could not open recording " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(FrameFileHeader))
+    {
+        std::cerr << "❌ " << path << " is too small to be a recording" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (map == MAP_FAILED)
+    {
+        std::cerr << "❌ Could not map recording " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    map_ = (const uint8_t *)map;
+    mapBytes_ = (size_t)st.st_size;
+    std::memcpy(&header_, map_, sizeof(header_));
+
+    if (std::memcmp(header_.magic, FRAME_FILE_MAGIC, sizeof(header_.magic)) != 0 || header_.version != FRAME_FILE_VERSION ||
+        header_.headerBytes != sizeof(FrameFileHeader) || header_.recordBytes < sizeof(FrameRecordHeader) + header_.frameBytes)
+    {
+        std::cerr << "❌ " << path << " is not a version " << FRAME_FILE_VERSION << " frame recording" << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t recordsInFile = (mapBytes_ - header_.headerBytes) / header_.recordBytes;
+    if (header_.frameCount != 0 && header_.frameCount <= recordsInFile)
+        frameCount_ = header_.frameCount;
+    else
+    {
+        // Recorder didn't close cleanly, keep every record that was actually written
+        frameCount_ = 0;
+        while (frameCount_ < recordsInFile && record(frameCount_).bytesUsed != 0)
+            frameCount_++;
+        std::cerr << "⚠️ " << path << " was not closed cleanly, recovered " << frameCount_ << " frames" << std::endl;
+    }
+    return true;
+}
+
+void FrameReader::close()
+{
+    if (map_)
+    {
+        munmap((void *)map_, mapBytes_);
+        map_ = nullptr;
+        mapBytes_ = 0;
+    }
+    frameCount_ = 0;
+}
+
+const FrameRecordHeader &FrameReader::record(uint64_t index) const
+{
+    return *(const FrameRecordHeader *)(map_ + header_.headerBytes + (size_t)index * header_.recordBytes);
+}
+
+const uint8_t *FrameReader::payload(uint64_t index) const
+{
+    return map_ + header_.headerBytes + (size_t)index * header_.recordBytes + sizeof(FrameRecordHeader);
+}
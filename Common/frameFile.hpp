@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "frameRing.hpp"
+
+// ----------------- Frame file layout ----------------- //
+// Raw camera frames in one memory-mapped file, so a session can be replayed without the camera
+//
+//  [FrameFileHeader 64 B][record 0][record 1]...
+//  record = [FrameRecordHeader 16 B][payload, frameBytes reserved] padded to recordBytes (multiple of 64)
+//
+// Every record is the same size so frame i lives at headerBytes + i * recordBytes
+struct FrameFileHeader
+{
+    char magic[8];        // "HGFRAME1"
+    uint32_t version;     // FRAME_FILE_VERSION
+    uint32_t headerBytes; // sizeof(FrameFileHeader)
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;      // Bytes per row
+    uint32_t pixelFormat; // V4L2_PIX_FMT_*
+    uint32_t frameBytes;  // Payload bytes reserved per record (stride * height)
+    uint32_t recordBytes;
+    uint64_t frameCount;  // Written on close, 0 = recorder never closed (the reader then counts the records itself)
+    uint8_t reserved[16];
+};
+static_assert(sizeof(FrameFileHeader) == 64, "FrameFileHeader must stay 64 bytes");
+
+struct FrameRecordHeader
+{
+    int64_t timestampNs; // Kernel buffer timestamp (CLOCK_MONOTONIC)
+    uint32_t sequence;   // Driver sequence number
+    uint32_t bytesUsed;  // 0 = never written
+};
+static_assert(sizeof(FrameRecordHeader) == 16, "FrameRecordHeader must stay 16 bytes");
+
+constexpr uint32_t FRAME_FILE_VERSION = 1;
+
+// ----------------- FrameRecorder ----------------- //
+// Appends frames straight into the mmap'd file, the file grows GROW_RECORDS records at a time
+class FrameRecorder
+{
+public:
+    FrameRecorder() = default;
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    bool open(const std::string &path, int width, int height, size_t stride, uint32_t pixelFormat);
+    bool append(const FrameSlot &slot);
+    void close(); // Trims the file to the frames written and stores frameCount in the header
+
+    bool isOpened() const { return fd_ >= 0; }
+    uint64_t frames() const { return frames_; }
+
+private:
+    static const uint64_t GROW_RECORDS = 64;
+
+    bool reserve(uint64_t records);
+
+    int fd_ = -1;
+    uint8_t *map_ = nullptr;
+    size_t mapBytes_ = 0;
+    uint64_t capacity_ = 0; // Records that fit in the mapping
+    uint64_t frames_ = 0;
+    FrameFileHeader header_{};
+    std::string path_;
+};
+
+// ----------------- FrameReader ----------------- //
+// Read only mapping of a recording, frames are read in place (no copy until the caller wants one)
+class FrameReader
+{
+public:
+    FrameReader() = default;
+    ~FrameReader();
+
+    FrameReader(const FrameReader &) = delete;
+    FrameReader &operator=(const FrameReader &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpened() const { return map_ != nullptr; }
+    const FrameFileHeader &header() const { return header_; }
+    uint64_t frameCount() const { return frameCount_; }
+
+    const FrameRecordHeader &record(uint64_t index) const;
+    const uint8_t *payload(uint64_t index) const;
+
+private:
+    const uint8_t *map_ = nullptr;
+    size_t mapBytes_ = 0;
+    FrameFileHeader header_{};
+    uint64_t frameCount_ = 0;
+};
@@ -0,0 +1,137 @@
+#include "frameRing.hpp"
+
+#include <chrono>
+
+// 3 is the minimum (one being written, one ready, one being read), 256 the most latest_ can address
+static int clampSlotCount(int slotCount)
+{
+    return slotCount < 3 ? 3 : (slotCount > 256 ? 256 : slotCount);
+}
+
+FrameRing::FrameRing(int slotCount, size_t slotBytes)
+    : slots_(clampSlotCount(slotCount)),
+      states_(new std::atomic<uint32_t>[clampSlotCount(slotCount)])
+{
+    for (size_t i = 0; i < slots_.size(); i++)
+    {
+        slots_[i].data.resize(slotBytes);
+        states_[i].store(FREE, std::memory_order_relaxed);
+    }
+}
+
+FrameSlot &FrameRing::beginWrite()
+{
+    const int n = (int)slots_.size();
+
+    // Walk the ring from the slot after the last one we wrote, the first FREE / READY slot we
+    // hit is the oldest, so an unread READY slot here is the drop-oldest case
+    while (true)
+    {
+        for (int k = 0; k < n; k++)
+        {
+            int i = (cursor_ + k) % n;
+            uint32_t state = states_[i].load(std::memory_order_acquire);
+            if (state != FREE && state != READY)
+                continue;
+
+            if (states_[i].compare_exchange_strong(state, WRITING, std::memory_order_acq_rel))
+            {
+                writeIndex_ = i;
+                cursor_ = (i + 1) % n;
+                return slots_[i];
+            }
+        }
+        // Only reachable if the consumer grabbed a slot between our load and CAS, just go round again
+    }
+}
+
+void FrameRing::publish()
+{
+    if (writeIndex_ < 0)
+        return;
+
+    FrameSlot &slot = slots_[writeIndex_];
+    slot.frameNumber = nextFrameNumber_++;
+
+    states_[writeIndex_].store(READY, std::memory_order_release);
+    // seq_cst store / load pair with the consumer's parked_ store / latest_ load : either it sees this frame
+    // before it sleeps, or we see it parked and wake it
+    latest_.store((slot.frameNumber << 8) | (uint64_t)writeIndex_, std::memory_order_seq_cst);
+    publishedCount_.fetch_add(1, std::memory_order_relaxed);
+    writeIndex_ = -1;
+
+    // Consumer busy with the last frame (the usual case) : no lock, no notify
+    if (!parked_.load(std::memory_order_seq_cst))
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    waitCv_.notify_one();
+}
+
+void FrameRing::abandonWrite()
+{
+    if (writeIndex_ < 0)
+        return;
+
+    // Next beginWrite() starts at this slot again, so the walk stays oldest first and never reaches the newest READY slot
+    states_[writeIndex_].store(FREE, std::memory_order_release);
+    cursor_ = writeIndex_;
+    writeIndex_ = -1;
+}
+
+const FrameSlot *FrameRing::takeNewest()
+{
+    while (true)
+    {
+        uint64_t latest = latest_.load(std::memory_order_acquire);
+        uint64_t frameNumber = latest >> 8;
+        if (frameNumber == 0 || frameNumber <= lastTaken_)
+            return nullptr;
+
+        int index = (int)(latest & 0xFF);
+        uint32_t expected = READY;
+        if (!states_[index].compare_exchange_strong(expected, READING, std::memory_order_acq_rel))
+            continue; // Producer is recycling it, latest_ is about to move on
+
+        // The slot may already hold an even newer frame than latest_ said, that's fine
+        const FrameSlot &slot = slots_[index];
+
+        if (readIndex_ >= 0)
+            states_[readIndex_].store(FREE, std::memory_order_release);
+        readIndex_ = index;
+
+        // Everything published between the last take and this one was never processed
+        if (slot.frameNumber > lastTaken_ + 1)
+            droppedCount_.fetch_add(slot.frameNumber - lastTaken_ - 1, std::memory_order_relaxed);
+        lastTaken_ = slot.frameNumber;
+        return &slot;
+    }
+}
+
+const FrameSlot *FrameRing::waitNewest(int timeoutMs)
+{
+    const FrameSlot *slot = takeNewest();
+    if (slot)
+        return slot;
+
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    parked_.store(true, std::memory_order_seq_cst);
+    waitCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&]
+                     { return (latest_.load(std::memory_order_seq_cst) >> 8) > lastTaken_ || wakeRequested_; });
+    parked_.store(false, std::memory_order_relaxed);
+    wakeRequested_ = false;
+    lock.unlock();
+
+    return takeNewest();
+}
+
+void FrameRing::wakeConsumer()
+{
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        wakeRequested_ = true;
+    }
+    waitCv_.notify_all();
+}
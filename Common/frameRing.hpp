@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ----------------- FrameSlot ----------------- //
+// One preallocated frame buffer in the ring plus the metadata of the frame it holds
+struct FrameSlot
+{
+    std::vector<uint8_t> data; // Sized once up front, never reallocated
+    size_t bytesUsed = 0;
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;
+    uint32_t pixelFormat = 0;
+    uint32_t sequence = 0;   // Driver sequence number
+    int64_t timestampNs = 0; // Capture timestamp (CLOCK_MONOTONIC)
+    uint64_t frameNumber = 0; // Ring publish counter, starts at 1
+};
+
+// ----------------- FrameRing ----------------- //
+// Lock-free single-producer / single-consumer ring of preallocated frame slots
+//  - Producer (capture thread) : beginWrite() → fill the slot → publish()
+//  - Consumer (processing loop): takeNewest() / waitNewest() always returns the newest frame
+//  - Drop-oldest : when the consumer falls behind the producer reuses the oldest unread slot
+//    instead of blocking, frames that were never processed are counted in dropped()
+//  - The slot returned to the consumer stays valid until its next take, the producer never touches it
+//
+// Each slot has a state (FREE → WRITING → READY → READING → FREE) that both sides move with CAS,
+// so neither side ever waits on the other. publish() only locks to wake a consumer parked in waitNewest()
+class FrameRing
+{
+public:
+    FrameRing(int slotCount, size_t slotBytes);
+
+    FrameRing(const FrameRing &) = delete;
+    FrameRing &operator=(const FrameRing &) = delete;
+
+    // ---------- Producer ---------- //
+    FrameSlot &beginWrite();
+    void publish();
+    void abandonWrite(); // Nothing was written (read timed out), slot goes back to FREE
+
+    // ---------- Consumer ---------- //
+    // nullptr when nothing newer than the last taken frame has been published
+    const FrameSlot *takeNewest();
+    // Same as takeNewest() but parks the caller (up to timeoutMs) until something arrives
+    const FrameSlot *waitNewest(int timeoutMs);
+    // Wake up a consumer parked in waitNewest() (used on shutdown)
+    void wakeConsumer();
+
+    uint64_t published() const { return publishedCount_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return droppedCount_.load(std::memory_order_relaxed); }
+    int size() const { return (int)slots_.size(); }
+
+private:
+    enum SlotState : uint32_t
+    {
+        FREE,
+        WRITING,
+        READY,
+        READING
+    };
+
+    std::vector<FrameSlot> slots_;
+    std::unique_ptr<std::atomic<uint32_t>[]> states_;
+
+    // Producer side
+    int writeIndex_ = -1;
+    int cursor_ = 0;
+    uint64_t nextFrameNumber_ = 1;
+
+    // Newest published frame : (frameNumber << 8) | slot index
+    std::atomic<uint64_t> latest_{0};
+
+    // Consumer side
+    int readIndex_ = -1;
+    uint64_t lastTaken_ = 0;
+
+    std::atomic<uint64_t> publishedCount_{0};
+    std::atomic<uint64_t> droppedCount_{0};
+
+    // Only used to park an idle consumer, publish() takes it only while the consumer is parked in waitNewest()
+    std::mutex waitMutex_;
+    std::condition_variable waitCv_;
+    std::atomic<bool> parked_{false};
+    bool wakeRequested_ = false; // Guarded by waitMutex_
+};
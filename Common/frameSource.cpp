@@ -0,0 +1,86 @@
+#include "frameSource.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <time.h>
+
+// ----------------- V4L2Source ----------------- //
+bool V4L2Source::read(FrameSlot &slot, int timeoutMs)
+{
+    if (!capture_.grab(view_, timeoutMs))
+        return false;
+
+    size_t bytes = view_.bytesUsed < slot.data.size() ? view_.bytesUsed : slot.data.size();
+    std::memcpy(slot.data.data(), view_.data, bytes);
+    slot.bytesUsed = bytes;
+    slot.width = view_.width;
+    slot.height = view_.height;
+    slot.stride = view_.stride;
+    slot.pixelFormat = view_.pixelFormat;
+    slot.sequence = view_.sequence;
+    slot.timestampNs = view_.timestampNs;
+
+    // Buffer back to the driver right after the copy, the driver is never more than one copy behind
+    view_.release();
+    return true;
+}
+
+// ----------------- ReplaySource ----------------- //
+bool ReplaySource::open(const std::string &path, bool fast)
+{
+    if (!reader_.open(path))
+        return false;
+
+    if (reader_.frameCount() == 0)
+    {
+        std::cerr << "❌ Recording " << path << " has no frames" << std::endl;
+        reader_.close();
+        return false;
+    }
+
+    fast_ = fast;
+    next_ = 0;
+    firstRecordedNs_ = reader_.record(0).timestampNs;
+
+    std::cout << "✅ Replaying " << reader_.frameCount() << " frames (" << width() << "x" << height() << ") from "
+              << path << (fast ? " as fast as possible" : " at the recorded pace") << std::endl;
+    return true;
+}
+
+bool ReplaySource::read(FrameSlot &slot, int timeoutMs)
+{
+    (void)timeoutMs; // Paced waits are at most one recorded frame interval
+    if (!isOpened())
+        return false;
+
+    const FrameRecordHeader &record = reader_.record(next_);
+    int64_t offsetNs = record.timestampNs - firstRecordedNs_;
+
+    if (next_ == 0)
+        startNs_ = monotonicNowNs();
+
+    int64_t dueNs = startNs_ + offsetNs;
+    if (!fast_)
+    {
+        timespec due;
+        due.tv_sec = (time_t)(dueNs / 1000000000LL);
+        due.tv_nsec = (long)(dueNs % 1000000000LL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, nullptr) == EINTR)
+        {
+        }
+    }
+
+    size_t bytes = record.bytesUsed < slot.data.size() ? record.bytesUsed : slot.data.size();
+    std::memcpy(slot.data.data(), reader_.payload(next_), bytes);
+    slot.bytesUsed = bytes;
+    slot.width = width();
+    slot.height = height();
+    slot.stride = stride();
+    slot.pixelFormat = pixelFormat();
+    slot.sequence = record.sequence;
+    slot.timestampNs = fast_ ? monotonicNowNs() : dueNs;
+
+    next_++;
+    return true;
+}
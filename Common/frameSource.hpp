@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "frameFile.hpp"
+#include "frameRing.hpp"
+#include "monotonicClock.hpp"
+#include "v4l2Capture.hpp"
+
+// ----------------- FrameSource ----------------- //
+// Where CaptureThread gets its frames from : the camera (V4L2Source) or a recording (ReplaySource)
+//  - read() copies the next frame into a ring slot (slot.data is already frameBytes() long)
+//  - isOpened() goes false once there will never be another frame (camera gone, end of recording)
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+
+    // false on timeout or end of stream
+    virtual bool read(FrameSlot &slot, int timeoutMs) = 0;
+    virtual bool isOpened() const = 0;
+
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+    virtual size_t stride() const = 0;
+    virtual uint32_t pixelFormat() const = 0;
+
+    // true when every frame has to be processed (fast replay), CaptureThread then reads on the caller's thread instead of dropping
+    virtual bool lossless() const { return false; }
+
+    size_t frameBytes() const { return stride() * (size_t)height(); }
+};
+
+// ----------------- V4L2Source ----------------- //
+// Live camera, capture must already be open + started
+class V4L2Source : public FrameSource
+{
+public:
+    explicit V4L2Source(V4L2Capture &capture) : capture_(capture) {}
+
+    bool read(FrameSlot &slot, int timeoutMs) override;
+    bool isOpened() const override { return capture_.isOpened(); }
+
+    int width() const override { return capture_.width(); }
+    int height() const override { return capture_.height(); }
+    size_t stride() const override { return capture_.stride(); }
+    uint32_t pixelFormat() const override { return capture_.pixelFormat(); }
+
+private:
+    V4L2Capture &capture_;
+    FrameView view_;
+};
+
+// ----------------- ReplaySource ----------------- //
+// Plays a FrameRecorder file back
+//  - Paced : frames come out with the same spacing they were recorded with
+//  - Fast  : as fast as the consumer takes them, nothing is dropped (lossless) so two runs see the exact same frames
+//  - Timestamps are rebased onto the current CLOCK_MONOTONIC so latency numbers stay meaningful, sequence numbers are kept
+class ReplaySource : public FrameSource
+{
+public:
+    bool open(const std::string &path, bool fast);
+    void close() { reader_.close(); }
+
+    bool read(FrameSlot &slot, int timeoutMs) override;
+    bool isOpened() const override { return reader_.isOpened() && next_ < reader_.frameCount(); }
+
+    int width() const override { return (int)reader_.header().width; }
+    int height() const override { return (int)reader_.header().height; }
+    size_t stride() const override { return reader_.header().stride; }
+    uint32_t pixelFormat() const override { return reader_.header().pixelFormat; }
+    bool lossless() const override { return fast_; }
+
+    uint64_t frameCount() const { return reader_.frameCount(); }
+
+private:
+    FrameReader reader_;
+    bool fast_ = false;
+    uint64_t next_ = 0;
+    int64_t firstRecordedNs_ = 0;
+    int64_t startNs_ = 0; // When frame 0 was played
+};
@@ -0,0 +1,544 @@
+#include "gaussianNoise.hpp"
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NOISE_HAVE_AVX2 1
+#endif
+
+// vsqrtq_f32 / vcvtnq_s32_f32 are AArch64 only, 32-bit ARM stays on the scalar kernel
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NOISE_HAVE_NEON 1
+#endif
+
+// ----------------- Philox4x32-10 ----------------- //
+// Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" : 10 rounds of 2 32x32 → 64 bit multiplies + xors
+// on a 128 bit counter with a 64 bit key, every counter value gives 4 independent 32 bit words
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+static const int PHILOX_ROUNDS = 10;
+
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        const uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        const uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)p1;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// ----------------- Layout ----------------- //
+// Bytes of a row go by groups of 32 : group g uses the 8 counters (8 g + j, row, stream lo, stream hi), j = 0..7
+// Words (w0, w1) of counter j → Box-Muller → bytes j and 8 + j, words (w2, w3) → bytes 16 + j and 24 + j
+// (= lane j of 4 AVX2 registers, no shuffling between the generator and the add)
+struct NoiseRow
+{
+    uint32_t key[2];
+    uint32_t stream[2];
+    uint32_t row;
+    float sigma;
+    float mean;
+};
+
+// Box-Muller inputs : u1 in (0, 1] (log never sees 0), u2 in [0, 1), 24 bits each so the int → float conversion is exact
+static const float NOISE_2POW_M24 = 5.9604644775390625e-8f;
+
+// Cephes logf / sinf / cosf polynomials, every backend evaluates them with the same operations in the same order
+static const float NOISE_SQRTHF = 0.707106781186547524f;
+static const float NOISE_LOG_P[9] = {7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+                                     -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f};
+static const float NOISE_LOG_Q1 = -2.12194440e-4f;
+static const float NOISE_LOG_Q2 = 0.693359375f;
+static const float NOISE_PIO2 = 1.57079632679489661923f;
+static const float NOISE_SIN_P[3] = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+static const float NOISE_COS_P[3] = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+
+// ----------------- Row kernels ----------------- //
+struct NoiseKernels
+{
+    const char *name;
+    void (*row)(const uint8_t *src, uint8_t *dst, int n, const NoiseRow &r);
+};
+
+// ---------- Scalar ---------- //
+static inline float bitsToFloat(uint32_t bits)
+{
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline uint32_t floatToBits(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// u in [2^-24, 1]
+static inline float logScalar(float u)
+{
+    const uint32_t bits = floatToBits(u);
+    int e = (int)(bits >> 23) - 126;
+    const float m = bitsToFloat((bits & 0x007FFFFF) | 0x3F000000); // [0.5, 1)
+    float x = m - 1.0f;
+    if (m < NOISE_SQRTHF)
+    {
+        e--;
+        x = x + m;
+    }
+    const float fe = (float)e;
+    const float z = x * x;
+
+    float y = NOISE_LOG_P[0];
+    for (int i = 1; i < 9; i++)
+        y = y * x + NOISE_LOG_P[i];
+    y = y * x;
+    y = y * z;
+    y = y + fe * NOISE_LOG_Q1;
+    y = y - 0.5f * z;
+    x = x + y;
+    return x + fe * NOISE_LOG_Q2;
+}
+
+// cos / sin of 2 pi u, u in [0, 1) : nearest quarter turn + polynomials on [-pi/4, pi/4]
+static inline void sinCosTurnScalar(float u, float &sinOut, float &cosOut)
+{
+    const float v = u * 4.0f;
+    const int q = (int)std::nearbyint(v);
+    const float x = (v - (float)q) * NOISE_PIO2;
+    const float z = x * x;
+
+    float s = (NOISE_SIN_P[0] * z + NOISE_SIN_P[1]) * z + NOISE_SIN_P[2];
+    s = s * z;
+    s = s * x;
+    s = s + x;
+
+    float c = (NOISE_COS_P[0] * z + NOISE_COS_P[1]) * z + NOISE_COS_P[2];
+    c = c * z;
+    c = c * z;
+    c = c - 0.5f * z;
+    c = c + 1.0f;
+
+    cosOut = (q & 1) ? s : c;
+    sinOut = (q & 1) ? c : s;
+    if ((q + 1) & 2)
+        cosOut = -cosOut;
+    if (q & 2)
+        sinOut = -sinOut;
+}
+
+static inline int16_t noiseValueScalar(float z, const NoiseRow &r)
+{
+    const int v = (int)std::nearbyint(z * r.sigma + r.mean);
+    return (int16_t)std::min(std::max(v, -32768), 32767);
+}
+
+static inline void boxMullerScalar(uint32_t a, uint32_t b, const NoiseRow &r, int16_t &n0, int16_t &n1)
+{
+    const float u1 = (float)((a >> 8) + 1) * NOISE_2POW_M24;
+    const float u2 = (float)(b >> 8) * NOISE_2POW_M24;
+    const float radius = std::sqrt(logScalar(u1) * -2.0f);
+    float s, c;
+    sinCosTurnScalar(u2, s, c);
+    n0 = noiseValueScalar(radius * c, r);
+    n1 = noiseValueScalar(radius * s, r);
+}
+
+static void noiseGroupScalar(uint32_t group, const NoiseRow &r, int16_t noise[32])
+{
+    for (int j = 0; j < 8; j++)
+    {
+        const uint32_t counter[4] = {group * 8 + j, r.row, r.stream[0], r.stream[1]};
+        uint32_t w[4];
+        philox4x32(counter, r.key, w);
+        boxMullerScalar(w[0], w[1], r, noise[j], noise[8 + j]);
+        boxMullerScalar(w[2], w[3], r, noise[16 + j], noise[24 + j]);
+    }
+}
+
+static void noiseRowScalarFrom(const uint8_t *src, uint8_t *dst, int n, const NoiseRow &r, int from)
+{
+    int16_t noise[32];
+    for (int x = from; x < n; x += 32)
+    {
+        noiseGroupScalar((uint32_t)(x / 32), r, noise);
+        const int count = std::min(32, n - x);
+        for (int i = 0; i < count; i++)
+            dst[x + i] = (uint8_t)std::min(std::max((int)src[x + i] + noise[i], 0), 255);
+    }
+}
+
+static void noiseRowScalar(const uint8_t *src, uint8_t *dst, int n, const NoiseRow &r)
+{
+    noiseRowScalarFrom(src, dst, n, r, 0);
+}
+
+static const NoiseKernels SCALAR_KERNELS = {"scalar", noiseRowScalar};
+
+// ---------- AVX2 (x86, picked at runtime) ---------- //
+// avx2 only (no fma) : the compiler can't fuse the multiplies and adds, results match the scalar kernel bit for bit
+#ifdef NOISE_HAVE_AVX2
+// 8 lanes of a * m → high and low 32 bits, even / odd lanes through the 2 _mm256_mul_epu32
+__attribute__((target("avx2"))) static inline void mulHiLoAvx2(__m256i a, __m256i m, __m256i &hi, __m256i &lo)
+{
+    const __m256i even = _mm256_mul_epu32(a, m);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+// Two groups at once : one Philox round is a chain of dependent multiplies, two independent chains keep the ports busy
+__attribute__((target("avx2"))) static inline void philoxAvx2(uint32_t group, const NoiseRow &r, __m256i w[2][4])
+{
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i c[2][4];
+    for (int g = 0; g < 2; g++)
+    {
+        c[g][0] = _mm256_add_epi32(_mm256_set1_epi32((int)((group + g) * 8)), lanes);
+        c[g][1] = _mm256_set1_epi32((int)r.row);
+        c[g][2] = _mm256_set1_epi32((int)r.stream[0]);
+        c[g][3] = _mm256_set1_epi32((int)r.stream[1]);
+    }
+    const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi32((int)PHILOX_M1);
+    uint32_t k0 = r.key[0], k1 = r.key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        const __m256i key0 = _mm256_set1_epi32((int)k0);
+        const __m256i key1 = _mm256_set1_epi32((int)k1);
+        for (int g = 0; g < 2; g++)
+        {
+            __m256i hi0, lo0, hi1, lo1;
+            mulHiLoAvx2(c[g][0], m0, hi0, lo0);
+            mulHiLoAvx2(c[g][2], m1, hi1, lo1);
+            c[g][0] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[g][1]), key0);
+            c[g][1] = lo1;
+            c[g][2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[g][3]), key1);
+            c[g][3] = lo0;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    for (int g = 0; g < 2; g++)
+        for (int i = 0; i < 4; i++)
+            w[g][i] = c[g][i];
+}
+
+__attribute__((target("avx2"))) static inline __m256 polyStepAvx2(__m256 y, __m256 x, float c)
+{
+    return _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(c));
+}
+
+__attribute__((target("avx2"))) static inline __m256 logAvx2(__m256 u)
+{
+    const __m256i bits = _mm256_castps_si256(u);
+    __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+    const __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                         _mm256_set1_epi32(0x3F000000)));
+    __m256 x = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+    const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(NOISE_SQRTHF), _CMP_LT_OQ);
+    e = _mm256_add_epi32(e, _mm256_castps_si256(small)); // Mask is -1
+    x = _mm256_add_ps(x, _mm256_and_ps(small, m));
+    const __m256 fe = _mm256_cvtepi32_ps(e);
+    const __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 y = _mm256_set1_ps(NOISE_LOG_P[0]);
+    for (int i = 1; i < 9; i++)
+        y = polyStepAvx2(y, x, NOISE_LOG_P[i]);
+    y = _mm256_mul_ps(y, x);
+    y = _mm256_mul_ps(y, z);
+    y = _mm256_add_ps(y, _mm256_mul_ps(fe, _mm256_set1_ps(NOISE_LOG_Q1)));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+    x = _mm256_add_ps(x, y);
+    return _mm256_add_ps(x, _mm256_mul_ps(fe, _mm256_set1_ps(NOISE_LOG_Q2)));
+}
+
+__attribute__((target("avx2"))) static inline void sinCosTurnAvx2(__m256 u, __m256 &sinOut, __m256 &cosOut)
+{
+    const __m256 v = _mm256_mul_ps(u, _mm256_set1_ps(4.0f));
+    const __m256i q = _mm256_cvtps_epi32(v); // Round to nearest even, like nearbyint
+    const __m256 x = _mm256_mul_ps(_mm256_sub_ps(v, _mm256_cvtepi32_ps(q)), _mm256_set1_ps(NOISE_PIO2));
+    const __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 s = polyStepAvx2(polyStepAvx2(_mm256_set1_ps(NOISE_SIN_P[0]), z, NOISE_SIN_P[1]), z, NOISE_SIN_P[2]);
+    s = _mm256_mul_ps(s, z);
+    s = _mm256_mul_ps(s, x);
+    s = _mm256_add_ps(s, x);
+
+    __m256 c = polyStepAvx2(polyStepAvx2(_mm256_set1_ps(NOISE_COS_P[0]), z, NOISE_COS_P[1]), z, NOISE_COS_P[2]);
+    c = _mm256_mul_ps(c, z);
+    c = _mm256_mul_ps(c, z);
+    c = _mm256_sub_ps(c, _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+    c = _mm256_add_ps(c, _mm256_set1_ps(1.0f));
+
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+    const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    const __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+    const __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    cosOut = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+    sinOut = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+}
+
+__attribute__((target("avx2"))) static inline void boxMullerAvx2(__m256i a, __m256i b, const NoiseRow &r, __m256i &n0, __m256i &n1)
+{
+    const __m256 scale = _mm256_set1_ps(NOISE_2POW_M24);
+    const __m256 u1 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_srli_epi32(a, 8), _mm256_set1_epi32(1))), scale);
+    const __m256 u2 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(b, 8)), scale);
+    const __m256 radius = _mm256_sqrt_ps(_mm256_mul_ps(logAvx2(u1), _mm256_set1_ps(-2.0f)));
+    __m256 s, c;
+    sinCosTurnAvx2(u2, s, c);
+    const __m256 sigma = _mm256_set1_ps(r.sigma);
+    const __m256 mean = _mm256_set1_ps(r.mean);
+    n0 = _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(radius, c), sigma), mean));
+    n1 = _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(radius, s), sigma), mean));
+}
+
+__attribute__((target("avx2"))) static inline void addNoiseAvx2(const uint8_t *src, uint8_t *dst, const __m256i w[4], const NoiseRow &r)
+{
+    __m256i a, b, c, d;
+    boxMullerAvx2(w[0], w[1], r, a, b);
+    boxMullerAvx2(w[2], w[3], r, c, d);
+
+    // int32 → saturated int16 in byte order (packs works per 128-bit lane, the permute puts the quarters back)
+    const __m256i noiseLo = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+    const __m256i noiseHi = _mm256_permute4x64_epi64(_mm256_packs_epi32(c, d), 0xD8);
+
+    const __m256i pixels = _mm256_loadu_si256((const __m256i *)src);
+    const __m256i lo = _mm256_adds_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(pixels)), noiseLo);
+    const __m256i hi = _mm256_adds_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(pixels, 1)), noiseHi);
+    _mm256_storeu_si256((__m256i *)dst, _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8));
+}
+
+__attribute__((target("avx2"))) static void noiseRowAvx2(const uint8_t *src, uint8_t *dst, int n, const NoiseRow &r)
+{
+    int x = 0;
+    for (; x + 64 <= n; x += 64)
+    {
+        __m256i w[2][4];
+        philoxAvx2((uint32_t)(x / 32), r, w);
+        addNoiseAvx2(src + x, dst + x, w[0], r);
+        addNoiseAvx2(src + x + 32, dst + x + 32, w[1], r);
+    }
+    noiseRowScalarFrom(src, dst, n, r, x);
+}
+
+static const NoiseKernels AVX2_KERNELS = {"avx2", noiseRowAvx2};
+#endif
+
+// ---------- NEON (AArch64) ---------- //
+// Same operations as the scalar kernel, 4 counters at a time (a group of 32 bytes = 2 halves)
+#ifdef NOISE_HAVE_NEON
+static inline void mulHiLoNeon(uint32x4_t a, uint32_t m, uint32x4_t &hi, uint32x4_t &lo)
+{
+    const uint32x4_t p0 = vreinterpretq_u32_u64(vmull_n_u32(vget_low_u32(a), m));
+    const uint32x4_t p1 = vreinterpretq_u32_u64(vmull_high_n_u32(a, m));
+    hi = vuzp2q_u32(p0, p1);
+    lo = vuzp1q_u32(p0, p1);
+}
+
+static inline void philoxNeon(uint32_t firstCounter, const NoiseRow &r, uint32x4_t w[4])
+{
+    static const uint32_t lanes[4] = {0, 1, 2, 3};
+    uint32x4_t c0 = vaddq_u32(vdupq_n_u32(firstCounter), vld1q_u32(lanes));
+    uint32x4_t c1 = vdupq_n_u32(r.row);
+    uint32x4_t c2 = vdupq_n_u32(r.stream[0]);
+    uint32x4_t c3 = vdupq_n_u32(r.stream[1]);
+    uint32_t k0 = r.key[0], k1 = r.key[1];
+    for (int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        uint32x4_t hi0, lo0, hi1, lo1;
+        mulHiLoNeon(c0, PHILOX_M0, hi0, lo0);
+        mulHiLoNeon(c2, PHILOX_M1, hi1, lo1);
+        c0 = veorq_u32(veorq_u32(hi1, c1), vdupq_n_u32(k0));
+        c1 = lo1;
+        c2 = veorq_u32(veorq_u32(hi0, c3), vdupq_n_u32(k1));
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    w[0] = c0;
+    w[1] = c1;
+    w[2] = c2;
+    w[3] = c3;
+}
+
+static inline float32x4_t polyStepNeon(float32x4_t y, float32x4_t x, float c)
+{
+    return vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(c));
+}
+
+static inline float32x4_t logNeon(float32x4_t u)
+{
+    const uint32x4_t bits = vreinterpretq_u32_f32(u);
+    int32x4_t e = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(126));
+    const float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F000000)));
+    float32x4_t x = vsubq_f32(m, vdupq_n_f32(1.0f));
+    const uint32x4_t small = vcltq_f32(m, vdupq_n_f32(NOISE_SQRTHF));
+    e = vaddq_s32(e, vreinterpretq_s32_u32(small)); // Mask is -1
+    x = vaddq_f32(x, vreinterpretq_f32_u32(vandq_u32(small, vreinterpretq_u32_f32(m))));
+    const float32x4_t fe = vcvtq_f32_s32(e);
+    const float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t y = vdupq_n_f32(NOISE_LOG_P[0]);
+    for (int i = 1; i < 9; i++)
+        y = polyStepNeon(y, x, NOISE_LOG_P[i]);
+    y = vmulq_f32(y, x);
+    y = vmulq_f32(y, z);
+    y = vaddq_f32(y, vmulq_f32(fe, vdupq_n_f32(NOISE_LOG_Q1)));
+    y = vsubq_f32(y, vmulq_f32(vdupq_n_f32(0.5f), z));
+    x = vaddq_f32(x, y);
+    return vaddq_f32(x, vmulq_f32(fe, vdupq_n_f32(NOISE_LOG_Q2)));
+}
+
+static inline void sinCosTurnNeon(float32x4_t u, float32x4_t &sinOut, float32x4_t &cosOut)
+{
+    const float32x4_t v = vmulq_f32(u, vdupq_n_f32(4.0f));
+    const int32x4_t q = vcvtnq_s32_f32(v); // Round to nearest even, like nearbyint
+    const float32x4_t x = vmulq_f32(vsubq_f32(v, vcvtq_f32_s32(q)), vdupq_n_f32(NOISE_PIO2));
+    const float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t s = polyStepNeon(polyStepNeon(vdupq_n_f32(NOISE_SIN_P[0]), z, NOISE_SIN_P[1]), z, NOISE_SIN_P[2]);
+    s = vmulq_f32(s, z);
+    s = vmulq_f32(s, x);
+    s = vaddq_f32(s, x);
+
+    float32x4_t c = polyStepNeon(polyStepNeon(vdupq_n_f32(NOISE_COS_P[0]), z, NOISE_COS_P[1]), z, NOISE_COS_P[2]);
+    c = vmulq_f32(c, z);
+    c = vmulq_f32(c, z);
+    c = vsubq_f32(c, vmulq_f32(vdupq_n_f32(0.5f), z));
+    c = vaddq_f32(c, vdupq_n_f32(1.0f));
+
+    const uint32x4_t qu = vreinterpretq_u32_s32(q);
+    const uint32x4_t one = vdupq_n_u32(1);
+    const uint32x4_t two = vdupq_n_u32(2);
+    const uint32x4_t swap = vceqq_u32(vandq_u32(qu, one), one);
+    const uint32x4_t cosSign = vshlq_n_u32(vandq_u32(vaddq_u32(qu, one), two), 30);
+    const uint32x4_t sinSign = vshlq_n_u32(vandq_u32(qu, two), 30);
+    cosOut = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, s, c)), cosSign));
+    sinOut = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, c, s)), sinSign));
+}
+
+static inline void boxMullerNeon(uint32x4_t a, uint32x4_t b, const NoiseRow &r, int16x4_t &n0, int16x4_t &n1)
+{
+    const float32x4_t scale = vdupq_n_f32(NOISE_2POW_M24);
+    const float32x4_t u1 = vmulq_f32(vcvtq_f32_u32(vaddq_u32(vshrq_n_u32(a, 8), vdupq_n_u32(1))), scale);
+    const float32x4_t u2 = vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(b, 8)), scale);
+    const float32x4_t radius = vsqrtq_f32(vmulq_f32(logNeon(u1), vdupq_n_f32(-2.0f)));
+    float32x4_t s, c;
+    sinCosTurnNeon(u2, s, c);
+    const float32x4_t sigma = vdupq_n_f32(r.sigma);
+    const float32x4_t mean = vdupq_n_f32(r.mean);
+    n0 = vqmovn_s32(vcvtnq_s32_f32(vaddq_f32(vmulq_f32(vmulq_f32(radius, c), sigma), mean)));
+    n1 = vqmovn_s32(vcvtnq_s32_f32(vaddq_f32(vmulq_f32(vmulq_f32(radius, s), sigma), mean)));
+}
+
+static void noiseRowNeon(const uint8_t *src, uint8_t *dst, int n, const NoiseRow &r)
+{
+    int x = 0;
+    int16_t noise[32];
+    for (; x + 32 <= n; x += 32)
+    {
+        for (int half = 0; half < 2; half++)
+        {
+            uint32x4_t w[4];
+            philoxNeon((uint32_t)(x / 32) * 8 + half * 4, r, w);
+            int16x4_t a, b, c, d;
+            boxMullerNeon(w[0], w[1], r, a, b);
+            boxMullerNeon(w[2], w[3], r, c, d);
+            vst1_s16(noise + half * 4, a);
+            vst1_s16(noise + 8 + half * 4, b);
+            vst1_s16(noise + 16 + half * 4, c);
+            vst1_s16(noise + 24 + half * 4, d);
+        }
+        for (int i = 0; i < 32; i += 8)
+        {
+            const int16x8_t pixels = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + x + i)));
+            vst1_u8(dst + x + i, vqmovun_s16(vqaddq_s16(pixels, vld1q_s16(noise + i))));
+        }
+    }
+    noiseRowScalarFrom(src, dst, n, r, x);
+}
+
+static const NoiseKernels NEON_KERNELS = {"neon", noiseRowNeon};
+#endif
+
+static const NoiseKernels &pickKernels()
+{
+#ifdef NOISE_HAVE_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+        return AVX2_KERNELS;
+#endif
+#ifdef NOISE_HAVE_NEON
+    return NEON_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const char *gaussianNoiseBackend()
+{
+    return pickKernels().name;
+}
+
+// ----------------- Gaussian noise ----------------- //
+static void noiseBand(const cv::Mat &src, cv::Mat &dst, const NoiseRow &base, int y0, int y1)
+{
+    const NoiseKernels &k = pickKernels();
+    const int n = src.cols * src.channels();
+    NoiseRow r = base;
+    for (int y = y0; y < y1; y++)
+    {
+        r.row = (uint32_t)y;
+        k.row(src.ptr<uint8_t>(y), dst.ptr<uint8_t>(y), n, r);
+    }
+}
+
+void addGaussianNoise(const cv::Mat &src, cv::Mat &dst, float sigma, float mean, uint64_t seed, uint64_t stream, int threads)
+{
+    CV_Assert(src.depth() == CV_8U);
+    // |z| <= 5.8 with 24 bit uniforms, these bounds keep mean + sigma * z inside an int32
+    CV_Assert(sigma >= 0 && sigma <= GAUSSIAN_NOISE_MAX && std::abs(mean) <= GAUSSIAN_NOISE_MAX);
+
+    dst.create(src.size(), src.type());
+    if (src.empty())
+        return;
+
+    NoiseRow base;
+    base.key[0] = (uint32_t)seed;
+    base.key[1] = (uint32_t)(seed >> 32);
+    base.stream[0] = (uint32_t)stream;
+    base.stream[1] = (uint32_t)(stream >> 32);
+    base.row = 0;
+    base.sigma = sigma;
+    base.mean = mean;
+
+    // Rows are independent (the counter says which row), bands of rows over threads
+    const int h = src.rows;
+    int bands = threads > 0 ? threads : ThreadPool::shared().size();
+    bands = std::max(1, std::min(bands, h / 16));
+
+    ThreadPool::shared().run(bands, [&](int i)
+                             { noiseBand(src, dst, base, h * i / bands, h * (i + 1) / bands); });
+}
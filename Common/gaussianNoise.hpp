@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+
+// ----------------- Gaussian noise ----------------- //
+// dst = saturate(src + round(mean + sigma * z)) per byte, z ~ N(0, 1), for dataset augmentation
+//  - Random bits come from Philox4x32-10, a counter based generator : the bits of a byte only depend on
+//    (seed, stream, row, column), nothing carries over from the previous byte
+//    → any row can be generated on its own, rows are split over threads, 8 counters per AVX2 register
+//  - Box-Muller turns 2 uniforms into 2 normals, log / sin / cos are polynomials (no libm calls) so they vectorize
+//  - Saturating adds in 16 bits, AVX2 / NEON kernels like thresholdStage
+//  - Same seed + stream → same image, whatever the thread count or the backend (scalar / AVX2 / NEON compute the
+//    same float operations in the same order, build with -ffp-contract=off so the compiler doesn't fuse them on ARM)
+//
+// src : 8-bit, any number of channels, dst can be src (in place)
+// stream : picks an independent sequence for the same seed (image index, copy number, ...)
+// threads 0 = one band per thread of the shared ThreadPool
+// sigma in [0, GAUSSIAN_NOISE_MAX], |mean| <= GAUSSIAN_NOISE_MAX, anything else fails a CV_Assert
+constexpr float GAUSSIAN_NOISE_MAX = 1e5f;
+void addGaussianNoise(const cv::Mat &src, cv::Mat &dst, float sigma, float mean = 0, uint64_t seed = 0,
+                      uint64_t stream = 0, int threads = 0);
+
+// One Philox4x32-10 block (exposed for the known answer check of the Batch tool)
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+// "avx2", "neon" or "scalar"
+const char *gaussianNoiseBackend();
@@ -0,0 +1,73 @@
+#include "handFeatures.hpp"
+#include "contourHull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+const char *const HAND_FEATURE_CSV_HEADER =
+    "threshVal,depthLevel,numHullPoints,numDefects,bbox.width,bbox.height,aspect_ratio,area,perimeter";
+
+void HandFeatureExtractor::extract(const std::vector<cv::Point> &contour, int threshVal, int depthLevel,
+                                   HandGeometry &geometry, HandFeatureVector &features)
+{
+    const int n = (int)contour.size();
+
+    // ---------- One pass : box, area, perimeter ---------- //
+    // Same arithmetic as contourArea (exact integer cross products) and arcLength (float steps added in a double)
+    int minX = 0, minY = 0, maxX = -1, maxY = -1;
+    int64_t twiceArea = 0;
+    double perimeter = 0;
+    if (n > 0)
+    {
+        minX = maxX = contour[0].x;
+        minY = maxY = contour[0].y;
+        cv::Point prev = contour[n - 1];
+        for (int i = 0; i < n; i++)
+        {
+            const cv::Point p = contour[i];
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+
+            twiceArea += (int64_t)prev.x * p.y - (int64_t)prev.y * p.x;
+            const float dx = (float)p.x - (float)prev.x, dy = (float)p.y - (float)prev.y;
+            perimeter += std::sqrt(dx * dx + dy * dy);
+            prev = p;
+        }
+    }
+    geometry.box = cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+    geometry.area = std::fabs((double)twiceArea * 0.5);
+    geometry.perimeter = n > 1 ? perimeter : 0;
+
+    // ---------- One hull ---------- //
+    // Indices come back ascending with their points, straight into hullDefects
+    contourHull(contour, geometry.hullIndices, &geometry.hull);
+    geometry.defects.clear();
+
+    // Need at least 4 points to compute defects. contourHull's indices are always sorted, hullDefects can't refuse them
+    if (geometry.hullIndices.size() > 3)
+        hullDefects(contour, geometry.hullIndices, geometry.defects);
+
+    // ---------- Feature vector ---------- //
+    features[FEATURE_THRESH_VAL] = (float)threshVal;
+    features[FEATURE_DEPTH_LEVEL] = (float)depthLevel;
+    features[FEATURE_HULL_POINTS] = (float)geometry.hullIndices.size();
+    features[FEATURE_DEFECTS] = (float)geometry.defects.size();
+    features[FEATURE_BOX_WIDTH] = (float)geometry.box.width;
+    features[FEATURE_BOX_HEIGHT] = (float)geometry.box.height;
+    features[FEATURE_ASPECT_RATIO] = (float)((double)geometry.box.width / geometry.box.height);
+    features[FEATURE_AREA] = (float)geometry.area;
+    features[FEATURE_PERIMETER] = (float)geometry.perimeter;
+}
+
+void HandFeatureExtractor::writeCsv(std::ostream &out, const HandFeatureVector &features)
+{
+    // Enough digits to read back the exact float the model gets live
+    const std::streamsize precision = out.precision(std::numeric_limits<float>::max_digits10);
+    for (int i = 0; i < HAND_FEATURE_COUNT; i++)
+        out << (i ? "," : "") << features[i];
+    out.precision(precision);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <memory_resource>
+#include <ostream>
+#include <vector>
+
+// ----------------- HandFeatureExtractor ----------------- //
+// The feature vector gatherData writes to the CSV and testGestures feeds the ONNX model, built by one piece of code
+// so the features the model was trained on and the ones it sees live can't drift apart
+//  - One pass over the contour : bounding box, area (shoelace, = cv::contourArea) and perimeter (= cv::arcLength
+//    closed, same float steps so the values are bit for bit the same)
+//  - One contourHull (O(n), sorted indices + the hull points used for drawing)
+//  - hullDefects (= convexityDefects, in place) on those indices
+//  - Everything goes into caller owned storage (HandGeometry + the feature array), HandGeometry's containers take
+//    their memory from the resource it's built on (a FrameArena in the capture loops)
+enum HandFeature
+{
+    FEATURE_THRESH_VAL,
+    FEATURE_DEPTH_LEVEL,
+    FEATURE_HULL_POINTS,
+    FEATURE_DEFECTS,
+    FEATURE_BOX_WIDTH,
+    FEATURE_BOX_HEIGHT,
+    FEATURE_ASPECT_RATIO,
+    FEATURE_AREA,
+    FEATURE_PERIMETER,
+    HAND_FEATURE_COUNT
+};
+
+using HandFeatureVector = std::array<float, HAND_FEATURE_COUNT>;
+
+// CSV column names of the features, in HandFeature order (gatherData adds gesture_label after them)
+extern const char *const HAND_FEATURE_CSV_HEADER;
+
+struct HandGeometry
+{
+    explicit HandGeometry(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : hullIndices(resource), hull(resource), defects(resource)
+    {
+    }
+
+    std::pmr::vector<int> hullIndices;   // Hull vertices as contour indices, ascending (what hullDefects wants)
+    std::pmr::vector<cv::Point> hull;    // contour[hullIndices[i]], in contour order so it's a closed polygon
+    std::pmr::vector<cv::Vec4i> defects; // start, end, far index + depth * 256, empty when the hull has 3 points or fewer
+    cv::Rect box;
+    double area = 0;
+    double perimeter = 0;
+};
+
+class HandFeatureExtractor
+{
+public:
+    // contour : the hand (largestContour), threshVal / depthLevel : what the frame was processed with
+    void extract(const std::vector<cv::Point> &contour, int threshVal, int depthLevel, HandGeometry &geometry,
+                 HandFeatureVector &features);
+
+    // Same features, one CSV row without the label ("60,20,31,9,...")
+    static void writeCsv(std::ostream &out, const HandFeatureVector &features);
+};
@@ -0,0 +1,461 @@
+#include "integralThreshold.hpp"
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INTEGRAL_HAVE_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define INTEGRAL_HAVE_NEON 1
+#endif
+
+// ----------------- Box mean rounding ----------------- //
+// cv::boxFilter on 8-bit images sums in 16 bits when the box has <= 256 pixels and divides with a 16 bit
+// fixed point reciprocal : mean = ((sum + delta) * scale) >> 16 (not always round(sum / n))
+// Bigger boxes sum in 32 bits and round the exact quotient
+struct BoxDiv
+{
+    int n;
+    bool fixed;
+    uint32_t delta;
+    uint32_t scale;
+};
+
+static BoxDiv boxDiv(int n)
+{
+    BoxDiv d;
+    d.n = n;
+    d.fixed = n <= 256;
+    d.delta = 0;
+    d.scale = 1 << 16; // 1x1 box : no scaling at all
+    if (d.fixed && n > 1)
+    {
+        double scalef = 65536.0 / n;
+        d.scale = (uint32_t)std::floor(scalef);
+        scalef -= d.scale;
+        d.delta = (uint32_t)(n / 2);
+        if (scalef < 0.5)
+            d.delta++;
+        else
+            d.scale++;
+    }
+    return d;
+}
+
+static inline int boxMean(uint32_t sum, const BoxDiv &d)
+{
+    if (d.fixed)
+        return (int)(((sum + d.delta) * d.scale) >> 16);
+    return (int)((2 * (uint64_t)sum + d.n) / (2 * (uint64_t)d.n));
+}
+
+// ----------------- Row kernels ----------------- //
+// P is the prefix sum of the column sums (P[0] = 0), box sum at x = P[x + k] - P[x]
+// threshRow : dst = 255 where gray > mean - idelta, i.e. mean < gray + idelta (what adaptiveThreshold's table does)
+struct BoxKernels
+{
+    const char *name;
+    void (*colAdd)(uint32_t *col, const uint8_t *add, const uint8_t *sub, int n);
+    void (*prefix)(const uint32_t *col, uint32_t *P, int n);
+    void (*meanRow)(const uint32_t *P, int k, int width, const BoxDiv &div, uint8_t *dst);
+    void (*threshRow)(const uint32_t *P, int k, int width, const BoxDiv &div, const uint8_t *gray, int idelta, uint8_t *dst);
+};
+
+// ---------- Scalar ---------- //
+static void colAddRowScalar(uint32_t *col, const uint8_t *add, const uint8_t *sub, int n, int from)
+{
+    for (int x = from; x < n; x++)
+        col[x] += (uint32_t)add[x] - (uint32_t)sub[x];
+}
+
+static void colAddScalar(uint32_t *col, const uint8_t *add, const uint8_t *sub, int n)
+{
+    colAddRowScalar(col, add, sub, n, 0);
+}
+
+static void prefixScalar(const uint32_t *col, uint32_t *P, int n)
+{
+    uint32_t sum = 0;
+    P[0] = 0;
+    for (int x = 0; x < n; x++)
+    {
+        sum += col[x];
+        P[x + 1] = sum;
+    }
+}
+
+static void meanRowScalarFrom(const uint32_t *P, int k, int width, const BoxDiv &div, uint8_t *dst, int from)
+{
+    for (int x = from; x < width; x++)
+        dst[x] = (uint8_t)boxMean(P[x + k] - P[x], div);
+}
+
+static void meanRowScalar(const uint32_t *P, int k, int width, const BoxDiv &div, uint8_t *dst)
+{
+    meanRowScalarFrom(P, k, width, div, dst, 0);
+}
+
+static void threshRowScalarFrom(const uint32_t *P, int k, int width, const BoxDiv &div, const uint8_t *gray, int idelta,
+                                uint8_t *dst, int from)
+{
+    for (int x = from; x < width; x++)
+        dst[x] = boxMean(P[x + k] - P[x], div) < gray[x] + idelta ? 255 : 0;
+}
+
+static void threshRowScalar(const uint32_t *P, int k, int width, const BoxDiv &div, const uint8_t *gray, int idelta, uint8_t *dst)
+{
+    threshRowScalarFrom(P, k, width, div, gray, idelta, dst, 0);
+}
+
+static const BoxKernels SCALAR_KERNELS = {"scalar", colAddScalar, prefixScalar, meanRowScalar, threshRowScalar};
+
+// ---------- AVX2 (x86, picked at runtime) ---------- //
+#ifdef INTEGRAL_HAVE_AVX2
+__attribute__((target("avx2"))) static void colAddAvx2(uint32_t *col, const uint8_t *add, const uint8_t *sub, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8)
+    {
+        __m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(add + x)));
+        __m256i s = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(sub + x)));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(col + x));
+        _mm256_storeu_si256((__m256i *)(col + x), _mm256_sub_epi32(_mm256_add_epi32(c, a), s));
+    }
+    colAddRowScalar(col, add, sub, n, x);
+}
+
+// In register scan : 2 shifted adds per 128-bit lane, then the low lane's total is carried into the high lane
+__attribute__((target("avx2"))) static void prefixAvx2(const uint32_t *col, uint32_t *P, int n)
+{
+    P[0] = 0;
+    __m256i carry = _mm256_setzero_si256();
+    const __m256i last = _mm256_set1_epi32(7);
+    int x = 0;
+    for (; x + 8 <= n; x += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(col + x));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        __m256i lowTotal = _mm256_permute2x128_si256(_mm256_shuffle_epi32(v, 0xFF), v, 0x08);
+        v = _mm256_add_epi32(_mm256_add_epi32(v, lowTotal), carry);
+        _mm256_storeu_si256((__m256i *)(P + x + 1), v);
+        carry = _mm256_permutevar8x32_epi32(v, last);
+    }
+    uint32_t sum = P[x];
+    for (; x < n; x++)
+    {
+        sum += col[x];
+        P[x + 1] = sum;
+    }
+}
+
+// 8 box means as int32 (only called for the 16 bit fixed point case)
+__attribute__((target("avx2"))) static inline __m256i boxMeanAvx2(const uint32_t *P, int k, int x, const BoxDiv &div)
+{
+    __m256i sum = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(P + x + k)), _mm256_loadu_si256((const __m256i *)(P + x)));
+    __m256i scaled = _mm256_mullo_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32((int)div.delta)), _mm256_set1_epi32((int)div.scale));
+    return _mm256_srli_epi32(scaled, 16);
+}
+
+__attribute__((target("avx2"))) static inline void storeEightAvx2(uint8_t *dst, __m256i v)
+{
+    __m128i w16 = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(w16, w16));
+}
+
+__attribute__((target("avx2"))) static void meanRowAvx2(const uint32_t *P, int k, int width, const BoxDiv &div, uint8_t *dst)
+{
+    int x = 0;
+    if (div.fixed)
+    {
+        for (; x + 8 <= width; x += 8)
+            storeEightAvx2(dst + x, boxMeanAvx2(P, k, x, div));
+    }
+    meanRowScalarFrom(P, k, width, div, dst, x);
+}
+
+__attribute__((target("avx2"))) static void threshRowAvx2(const uint32_t *P, int k, int width, const BoxDiv &div,
+                                                          const uint8_t *gray, int idelta, uint8_t *dst)
+{
+    int x = 0;
+    const __m256i delta = _mm256_set1_epi32(idelta);
+    if (div.fixed)
+    {
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i g = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(gray + x))), delta);
+            __m256i on = _mm256_cmpgt_epi32(g, boxMeanAvx2(P, k, x, div)); // -1 / 0 → 255 / 0 below
+            storeEightAvx2(dst + x, _mm256_and_si256(on, _mm256_set1_epi32(255)));
+        }
+    }
+    else
+    {
+        // round(sum / n) < g + idelta  <=>  2 sum + n < 2 n (g + idelta), no division (idelta is clamped so this fits 32 bits)
+        const __m256i n = _mm256_set1_epi32(div.n);
+        const __m256i twoN = _mm256_set1_epi32(2 * div.n);
+        for (; x + 8 <= width; x += 8)
+        {
+            __m256i sum = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(P + x + k)), _mm256_loadu_si256((const __m256i *)(P + x)));
+            __m256i lhs = _mm256_add_epi32(_mm256_add_epi32(sum, sum), n);
+            __m256i g = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(gray + x))), delta);
+            __m256i on = _mm256_cmpgt_epi32(_mm256_mullo_epi32(g, twoN), lhs);
+            storeEightAvx2(dst + x, _mm256_and_si256(on, _mm256_set1_epi32(255)));
+        }
+    }
+    threshRowScalarFrom(P, k, width, div, gray, idelta, dst, x);
+}
+
+static const BoxKernels AVX2_KERNELS = {"avx2", colAddAvx2, prefixAvx2, meanRowAvx2, threshRowAvx2};
+#endif
+
+// ---------- NEON (ARM) ---------- //
+#ifdef INTEGRAL_HAVE_NEON
+static void colAddNeon(uint32_t *col, const uint8_t *add, const uint8_t *sub, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8)
+    {
+        int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(add + x), vld1_u8(sub + x)));
+        vst1q_u32(col + x, vreinterpretq_u32_s32(vaddw_s16(vreinterpretq_s32_u32(vld1q_u32(col + x)), vget_low_s16(d))));
+        vst1q_u32(col + x + 4, vreinterpretq_u32_s32(vaddw_s16(vreinterpretq_s32_u32(vld1q_u32(col + x + 4)), vget_high_s16(d))));
+    }
+    colAddRowScalar(col, add, sub, n, x);
+}
+
+static inline uint32x4_t boxMeanNeon(const uint32_t *P, int k, int x, const BoxDiv &div)
+{
+    uint32x4_t sum = vsubq_u32(vld1q_u32(P + x + k), vld1q_u32(P + x));
+    return vshrq_n_u32(vmulq_n_u32(vaddq_u32(sum, vdupq_n_u32(div.delta)), div.scale), 16);
+}
+
+static void meanRowNeon(const uint32_t *P, int k, int width, const BoxDiv &div, uint8_t *dst)
+{
+    int x = 0;
+    if (div.fixed)
+    {
+        for (; x + 8 <= width; x += 8)
+        {
+            uint16x8_t m = vcombine_u16(vmovn_u32(boxMeanNeon(P, k, x, div)), vmovn_u32(boxMeanNeon(P, k, x + 4, div)));
+            vst1_u8(dst + x, vmovn_u16(m));
+        }
+    }
+    meanRowScalarFrom(P, k, width, div, dst, x);
+}
+
+static void threshRowNeon(const uint32_t *P, int k, int width, const BoxDiv &div, const uint8_t *gray, int idelta, uint8_t *dst)
+{
+    int x = 0;
+    if (div.fixed)
+    {
+        const int32x4_t delta = vdupq_n_s32(idelta);
+        for (; x + 8 <= width; x += 8)
+        {
+            int16x8_t g16 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(gray + x)));
+            int32x4_t gLo = vaddq_s32(vmovl_s16(vget_low_s16(g16)), delta);
+            int32x4_t gHi = vaddq_s32(vmovl_s16(vget_high_s16(g16)), delta);
+            uint32x4_t onLo = vcgtq_s32(gLo, vreinterpretq_s32_u32(boxMeanNeon(P, k, x, div)));
+            uint32x4_t onHi = vcgtq_s32(gHi, vreinterpretq_s32_u32(boxMeanNeon(P, k, x + 4, div)));
+            vst1_u8(dst + x, vmovn_u16(vcombine_u16(vmovn_u32(onLo), vmovn_u32(onHi))));
+        }
+    }
+    threshRowScalarFrom(P, k, width, div, gray, idelta, dst, x);
+}
+
+static const BoxKernels NEON_KERNELS = {"neon", colAddNeon, prefixScalar, meanRowNeon, threshRowNeon};
+#endif
+
+static const BoxKernels &pickKernels()
+{
+#ifdef INTEGRAL_HAVE_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+        return AVX2_KERNELS;
+#endif
+#ifdef INTEGRAL_HAVE_NEON
+    return NEON_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const char *integralThresholdBackend()
+{
+    return pickKernels().name;
+}
+
+// ----------------- One box pass over a band of rows ----------------- //
+// Sums src over a (2 radius + 1)^2 box with BORDER_REPLICATE, then either
+//  - mean != null : writes the box mean (same rounding as cv::boxFilter)
+//  - mask != null : writes 255 where compare > mean - idelta (compare = src's own gray when null)
+// grayOut != null also keeps the gray rows of the band on the way (the Gaussian mode compares against them at the end)
+struct BoxPass
+{
+    LumaView src;
+    int radius = 0;
+    uint8_t *mean = nullptr;
+    size_t meanStride = 0;
+    uint8_t *mask = nullptr;
+    size_t maskStride = 0;
+    const uint8_t *compare = nullptr;
+    size_t compareStride = 0;
+    int idelta = 0;
+    uint8_t *grayOut = nullptr;
+    size_t grayOutStride = 0;
+};
+
+static void boxPassBand(const BoxPass &pass, int y0, int y1)
+{
+    const BoxKernels &k = pickKernels();
+    const int w = pass.src.width;
+    const int h = pass.src.height;
+    const int r = pass.radius;
+    const int size = 2 * r + 1;
+    const int paddedWidth = w + 2 * r;
+    const BoxDiv div = boxDiv(size * size);
+
+    // size + 1 padded gray rows : the block plus the row coming in before the oldest one is subtracted
+    static thread_local std::vector<uint8_t> ring;
+    static thread_local std::vector<uint8_t> zeros;
+    static thread_local std::vector<uint32_t> col;
+    static thread_local std::vector<uint32_t> P;
+    ring.resize((size_t)(size + 1) * paddedWidth);
+    zeros.assign((size_t)paddedWidth, 0);
+    col.assign((size_t)paddedWidth, 0);
+    P.resize((size_t)paddedWidth + 1);
+
+    const int first = y0 - r; // Logical index of the first row that enters the window
+    auto ringRow = [&](int y)
+    { return ring.data() + (size_t)((y - first) % (size + 1)) * paddedWidth; };
+
+    auto load = [&](int y)
+    {
+        uint8_t *row = ringRow(y);
+        const int sy = std::min(std::max(y, 0), h - 1);
+        lumaRow(pass.src, sy, row + r);
+        std::memset(row, row[r], (size_t)r);
+        std::memset(row + r + w, row[r + w - 1], (size_t)r);
+        if (pass.grayOut && y >= y0 && y < y1)
+            std::memcpy(pass.grayOut + (size_t)y * pass.grayOutStride, row + r, (size_t)w);
+        return row;
+    };
+
+    for (int y = y0 - r; y <= y0 + r; y++)
+        k.colAdd(col.data(), load(y), zeros.data(), paddedWidth);
+
+    for (int y = y0; y < y1; y++)
+    {
+        k.prefix(col.data(), P.data(), paddedWidth);
+
+        if (pass.mean)
+            k.meanRow(P.data(), size, w, div, pass.mean + (size_t)y * pass.meanStride);
+        else
+        {
+            const uint8_t *gray = pass.compare ? pass.compare + (size_t)y * pass.compareStride : ringRow(y) + r;
+            k.threshRow(P.data(), size, w, div, gray, pass.idelta, pass.mask + (size_t)y * pass.maskStride);
+        }
+
+        if (y + 1 < y1)
+        {
+            const uint8_t *incoming = load(y + r + 1);
+            k.colAdd(col.data(), incoming, ringRow(y - r), paddedWidth);
+        }
+    }
+}
+
+static int threadsFor(int requested, int height)
+{
+    int threads = requested > 0 ? requested : ThreadPool::shared().size();
+    // Every band re-reads its 2 radius rows of warm up, bands shorter than ~32 rows aren't worth a thread
+    return std::max(1, std::min(threads, height / 32));
+}
+
+static void runBoxPass(const BoxPass &pass, int threads)
+{
+    const int h = pass.src.height;
+    ThreadPool::shared().run(threads, [&](int i)
+                             { boxPassBand(pass, h * i / threads, h * (i + 1) / threads); });
+}
+
+// ----------------- Gaussian → boxes ----------------- //
+// n boxes of width wl or wu = wl + 2 whose variances ((w^2 - 1) / 12 each) add up as close as possible to sigma^2
+void gaussianBoxWidths(int blockSize, int widths[3])
+{
+    const int n = 3;
+    const double sigma = 0.3 * ((blockSize - 1) * 0.5 - 1) + 0.8;
+    const double ideal = std::sqrt(12.0 * sigma * sigma / n + 1);
+    int wl = (int)std::floor(ideal);
+    if (wl % 2 == 0)
+        wl--;
+    wl = std::max(wl, 1);
+    const int wu = wl + 2;
+    const int m = (int)std::lround((12.0 * sigma * sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0));
+    for (int i = 0; i < n; i++)
+        widths[i] = i < m ? wl : wu;
+}
+
+// ----------------- Integral threshold ----------------- //
+void integralThreshold(const LumaView &src, cv::Mat &mask, int blockSize, double C, AdaptiveBoxMethod method, int threads)
+{
+    CV_Assert(blockSize % 2 == 1 && blockSize > 1 && blockSize <= 1023);
+
+    mask.create(src.height, src.width, CV_8UC1);
+    if (src.width == 0 || src.height == 0)
+        return;
+
+    // adaptiveThreshold compares against ceil(C) for THRESH_BINARY, past ±256 every pixel is on / off anyway
+    const int idelta = std::min(std::max((int)std::ceil(C), -256), 256);
+    const int bandThreads = threadsFor(threads, src.height);
+
+    if (method == ADAPTIVE_BOX_MEAN)
+    {
+        BoxPass pass;
+        pass.src = src;
+        pass.radius = blockSize / 2;
+        pass.mask = mask.data;
+        pass.maskStride = mask.step;
+        pass.idelta = idelta;
+        runBoxPass(pass, bandThreads);
+        return;
+    }
+
+    // Gaussian : gray → box → box → box + compare against the gray kept from the first pass
+    static thread_local cv::Mat gray, passA, passB;
+    gray.create(src.height, src.width, CV_8UC1);
+    passA.create(src.height, src.width, CV_8UC1);
+    passB.create(src.height, src.width, CV_8UC1);
+
+    int widths[3];
+    gaussianBoxWidths(blockSize, widths);
+
+    BoxPass first;
+    first.src = src;
+    first.radius = widths[0] / 2;
+    first.mean = passA.data;
+    first.meanStride = passA.step;
+    first.grayOut = gray.data;
+    first.grayOutStride = gray.step;
+    runBoxPass(first, bandThreads);
+
+    BoxPass second;
+    second.src = lumaFromGray(passA);
+    second.radius = widths[1] / 2;
+    second.mean = passB.data;
+    second.meanStride = passB.step;
+    runBoxPass(second, bandThreads);
+
+    BoxPass last;
+    last.src = lumaFromGray(passB);
+    last.radius = widths[2] / 2;
+    last.mask = mask.data;
+    last.maskStride = mask.step;
+    last.compare = gray.data;
+    last.compareStride = gray.step;
+    last.idelta = idelta;
+    runBoxPass(last, bandThreads);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include "thresholdStage.hpp"
+
+// ----------------- Integral threshold ----------------- //
+// cv::adaptiveThreshold(gray, mask, 255, method, THRESH_BINARY, blockSize, C) built on running box sums
+//  - Per row band : vertical running sums per column (+ row entering the block, - row leaving it), then a
+//    prefix sum along the row = that row of the integral image, box sum = 2 lookups
+//    → same cost per pixel for blockSize 3 or 301
+//  - Gray comes straight from the LumaView (YUYV / BGR / gray) while the rows enter the window, no gray pass first
+//  - Rows are split into bands over the shared ThreadPool (each band warms up its own window), AVX2 / NEON kernels like thresholdStage
+//
+// ADAPTIVE_BOX_MEAN     : same mask as ADAPTIVE_THRESH_MEAN_C bit for bit (box mean rounded like cv::boxFilter, BORDER_REPLICATE)
+// ADAPTIVE_BOX_GAUSSIAN : ADAPTIVE_THRESH_GAUSSIAN_C approximated by 3 box passes whose widths add up to the
+//                         variance of the Gaussian OpenCV picks for blockSize (sigma = 0.3 * ((blockSize - 1) / 2 - 1) + 0.8)
+//                         → not bit exact, a few pixels flip where the pixel is within a grey level of its local mean
+enum AdaptiveBoxMethod
+{
+    ADAPTIVE_BOX_MEAN,
+    ADAPTIVE_BOX_GAUSSIAN
+};
+
+// blockSize odd, 3 .. 1023, threads 0 = one band per thread of the shared ThreadPool
+void integralThreshold(const LumaView &src, cv::Mat &mask, int blockSize, double C,
+                       AdaptiveBoxMethod method = ADAPTIVE_BOX_MEAN, int threads = 0);
+
+// Box widths the Gaussian mode uses for blockSize (3 odd widths)
+void gaussianBoxWidths(int blockSize, int widths[3]);
+
+// "avx2", "neon" or "scalar"
+const char *integralThresholdBackend();
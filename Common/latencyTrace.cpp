@@ -0,0 +1,98 @@
+#include "latencyTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+LatencyTrace::LatencyTrace(const std::vector<std::string> &stageNames, size_t maxFrames)
+    : names_(stageNames),
+      stages_(stageNames.size()),
+      maxFrames_(maxFrames > 0 ? maxFrames : 1),
+      marks_(maxFrames_ * stages_, -1)
+{
+}
+
+void LatencyTrace::beginFrame(int64_t captureNs)
+{
+    if (stages_ == 0)
+        return;
+
+    int64_t *row = &marks_[row_ * stages_];
+    std::fill(row, row + stages_, (int64_t)-1);
+    row[0] = captureNs;
+    open_ = true;
+}
+
+void LatencyTrace::mark(int stage, int64_t ns)
+{
+    if (open_ && stage > 0 && (size_t)stage < stages_)
+        marks_[row_ * stages_ + stage] = ns;
+}
+
+void LatencyTrace::endFrame()
+{
+    if (!open_)
+        return;
+
+    open_ = false;
+    row_ = (row_ + 1) % maxFrames_;
+    if (count_ < maxFrames_)
+        count_++;
+}
+
+// Nearest rank percentile, values gets partially sorted
+static double percentileMs(std::vector<int64_t> &values, double p)
+{
+    size_t rank = (size_t)(p / 100.0 * (double)(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank] / 1e6;
+}
+
+void LatencyTrace::printReport(std::ostream &out) const
+{
+    out << "\n------ Latency (ms, " << count_ << " frames, capture = V4L2 buffer timestamp) ------\n";
+    if (count_ == 0)
+        return;
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-12s %7s | %8s %8s %8s | %8s %8s %8s\n",
+                  "stage", "frames", "p50", "p95", "p99", "step p50", "step p95", "step p99");
+    out << line;
+
+    std::vector<int64_t> sinceCapture, sincePrevious;
+    sinceCapture.reserve(count_);
+    sincePrevious.reserve(count_);
+
+    for (size_t s = 1; s < stages_; s++)
+    {
+        sinceCapture.clear();
+        sincePrevious.clear();
+        for (size_t f = 0; f < count_; f++)
+        {
+            const int64_t *row = &marks_[f * stages_];
+            if (row[s] < 0)
+                continue;
+
+            sinceCapture.push_back(row[s] - row[0]);
+
+            // Step = since the last stage this frame actually reached
+            size_t prev = s - 1;
+            while (prev > 0 && row[prev] < 0)
+                prev--;
+            sincePrevious.push_back(row[s] - row[prev]);
+        }
+
+        if (sinceCapture.empty())
+        {
+            std::snprintf(line, sizeof(line), "%-12s %7d |\n", names_[s].c_str(), 0);
+            out << line;
+            continue;
+        }
+
+        double c50 = percentileMs(sinceCapture, 50), c95 = percentileMs(sinceCapture, 95), c99 = percentileMs(sinceCapture, 99);
+        double s50 = percentileMs(sincePrevious, 50), s95 = percentileMs(sincePrevious, 95), s99 = percentileMs(sincePrevious, 99);
+        std::snprintf(line, sizeof(line), "%-12s %7zu | %8.2f %8.2f %8.2f | %8.2f %8.2f %8.2f\n",
+                      names_[s].c_str(), sinceCapture.size(), c50, c95, c99, s50, s95, s99);
+        out << line;
+    }
+    out.flush();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "monotonicClock.hpp"
+
+// ----------------- LatencyTrace ----------------- //
+// Per frame timestamps at each pipeline stage, all on CLOCK_MONOTONIC
+//  - Stage 0 is the V4L2 buffer timestamp (when the driver finished the frame), not when we got it
+//  - mark(stage) stamps "now" for that stage, stages a frame never reaches (no contour → no inference) stay empty
+//  - Everything is preallocated, the frame loop never allocates; once maxFrames is hit the oldest frames are overwritten
+//  - printReport() gives p50 / p95 / p99 per stage, both "since capture" (how old the frame is) and "since previous stage"
+class LatencyTrace
+{
+public:
+    LatencyTrace(const std::vector<std::string> &stageNames, size_t maxFrames = 65536);
+
+    void beginFrame(int64_t captureNs);
+    void mark(int stage) { mark(stage, monotonicNowNs()); }
+    void mark(int stage, int64_t ns);
+    void endFrame();
+
+    size_t frames() const { return count_; }
+    void printReport(std::ostream &out) const;
+
+private:
+    std::vector<std::string> names_;
+    size_t stages_;
+    size_t maxFrames_;
+    std::vector<int64_t> marks_; // maxFrames_ rows of stages_ timestamps, -1 = stage not reached
+    size_t row_ = 0;             // Row of the frame in progress
+    size_t count_ = 0;           // Frames committed (capped at maxFrames_)
+    bool open_ = false;
+};
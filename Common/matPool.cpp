@@ -0,0 +1,33 @@
+#include "matPool.hpp"
+
+cv::Mat MatPool::get(int rows, int cols, int type)
+{
+    gets_++;
+
+    // An empty Mat has no buffer (u == nullptr), nothing to keep
+    if (rows == 0 || cols == 0)
+        return cv::Mat(rows, cols, type);
+
+    // refcount 1 = only mats_ holds it, whoever had it last is done with it
+    for (const cv::Mat &mat : mats_)
+    {
+        if (mat.u && mat.rows == rows && mat.cols == cols && mat.type() == type && mat.u->refcount == 1)
+            return mat;
+    }
+
+    mats_.emplace_back(rows, cols, type);
+    return mats_.back();
+}
+
+void MatPool::printStats(std::ostream &out) const
+{
+    if (gets_ == 0)
+        return;
+
+    size_t bytes = 0;
+    for (const cv::Mat &mat : mats_)
+        bytes += mat.total() * mat.elemSize();
+
+    out << "Mat pool: " << gets_ << " gets, " << mats_.size() << " buffers allocated (" << bytes / 1024
+        << " KB held)\n";
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// ----------------- MatPool ----------------- //
+// Scratch images for the stages of a frame loop, kept by size and type instead of allocated again every frame
+//  - get() hands out a Mat of that size and type nobody else holds (the pool's own reference is the only one left
+//    on its buffer), a new buffer only when they're all taken → after the first frame nothing is allocated
+//  - The Mat shares the pool's buffer, dropping it (end of the stage) makes it free again, no release() to call
+//  - Contents are whatever the last user left in it
+//  - One per loop, not thread safe
+class MatPool
+{
+public:
+    cv::Mat get(int rows, int cols, int type);
+    cv::Mat get(cv::Size size, int type) { return get(size.height, size.width, type); }
+
+    // Buffers the pool holds (= how many were ever allocated)
+    size_t size() const { return mats_.size(); }
+
+    // get() calls, buffers allocated for them, bytes held
+    void printStats(std::ostream &out) const;
+
+private:
+    std::vector<cv::Mat> mats_;
+    uint64_t gets_ = 0;
+};
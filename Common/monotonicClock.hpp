@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <time.h>
+
+// CLOCK_MONOTONIC in ns, same clock as the V4L2 buffer timestamps
+inline int64_t monotonicNowNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
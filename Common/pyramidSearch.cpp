@@ -0,0 +1,73 @@
+#include "pyramidSearch.hpp"
+
+#include <opencv2/imgproc.hpp>
+
+#include "blobLabeler.hpp"
+#include "contourTracker.hpp"
+#include "roiTracker.hpp"
+
+PyramidSearch::PyramidSearch(int factor, int margin)
+    : factor_(factor < 1 ? 1 : factor),
+      margin_(margin > 0 ? margin : 0)
+{
+}
+
+int PyramidSearch::search(const LumaView &src, int threshVal, const cv::Rect &roi, cv::Mat &mask,
+                          std::vector<std::vector<cv::Point>> &contours, LumaHistogram *histogram)
+{
+    const cv::Rect full(0, 0, src.width, src.height);
+    const cv::Rect area = roi & full;
+
+    if (area != full || factor_ == 1 || src.width < 8 * factor_ || src.height < 8 * factor_)
+    {
+        blurThreshold(src, threshVal, area, mask, histogram);
+        return largest(mask, area, contours);
+    }
+
+    searches_++;
+    framePixels_ += (uint64_t)full.area();
+
+    // ---------- Coarse : pick the blob ---------- //
+    downscaleLuma(src, factor_, small_);
+    blurThreshold(lumaFromGray(small_), threshVal, cv::Rect(0, 0, small_.cols, small_.rows), coarseMask_, histogram);
+    int coarse = largestContour(coarseMask_, cv::Rect(0, 0, small_.cols, small_.rows), coarseContours_);
+    if (coarse == -1)
+    {
+        mask.create(src.height, src.width, CV_8UC1);
+        contours.clear();
+        return -1;
+    }
+
+    // ---------- Fine : trace it at full resolution ---------- //
+    const cv::Rect box = cv::boundingRect(coarseContours_[coarse]);
+    const cv::Rect region = cv::Rect(box.x * factor_ - margin_, box.y * factor_ - margin_,
+                                     box.width * factor_ + 2 * margin_, box.height * factor_ + 2 * margin_) &
+                            full;
+
+    blurThreshold(src, threshVal, region, mask);
+    finePixels_ += (uint64_t)region.area();
+    int fine = largest(mask, region, contours);
+    if (fine != -1 && !touchesInnerEdge(cv::boundingRect(contours[fine]), region, full.size()))
+        return fine;
+
+    // Blob grew past the region at full resolution (or vanished), no shortcut this time
+    fallbacks_++;
+    finePixels_ += (uint64_t)full.area();
+    blurThreshold(src, threshVal, full, mask);
+    return largest(mask, full, contours);
+}
+
+int PyramidSearch::largest(const cv::Mat &mask, const cv::Rect &roi, std::vector<std::vector<cv::Point>> &contours)
+{
+    return tracker_ ? tracker_->find(mask, roi, contours) : largestContour(mask, roi, contours);
+}
+
+void PyramidSearch::printStats(std::ostream &out) const
+{
+    if (searches_ == 0)
+        return;
+
+    out << "Pyramid search (1/" << factor_ << "): " << searches_ << " whole frame searches, " << fallbacks_
+        << " fell back to full resolution, " << 100.0 * finePixels_ / framePixels_
+        << "% of the full resolution pixels thresholded\n";
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "thresholdStage.hpp"
+
+class ContourTracker;
+
+// ----------------- PyramidSearch ----------------- //
+// Whole frame hand search, coarse to fine
+//  1) Frame averaged down by factor (2 → 1/4 of the pixels, 4 → 1/16), blurThreshold + findContours on that
+//  2) The largest blob's box is scaled back up, padded by margin and only that region is thresholded + traced
+//     at full resolution
+//  - The full resolution pass is the normal blurThreshold, so when the same blob is picked and it fits in the
+//    region the contour (area, perimeter, defects) is exactly the one the full frame search gives
+//  - Blob runs off the region (blur differs a bit between scales) → the whole frame at full resolution
+//  - factor 1 = plain full resolution search
+//  - Tolerances are checked on recordings by PyramidCheck/
+class PyramidSearch
+{
+public:
+    explicit PyramidSearch(int factor = 2, int margin = 12);
+
+    // Largest contour inside roi (index into contours, -1 = none), points in frame coordinates
+    //  - roi covering the whole frame goes coarse to fine, anything smaller is searched directly at full resolution
+    //  - mask is (re)created at full size, only the parts that were searched are written
+    //  - histogram != null gets the gray of the first pass : roi itself, or the whole downscaled frame
+    int search(const LumaView &src, int threshVal, const cv::Rect &roi, cv::Mat &mask,
+               std::vector<std::vector<cv::Point>> &contours, LumaHistogram *histogram = nullptr);
+
+    // Full resolution contours come from tracker (warm started from the last frame) instead of largestContour,
+    // null = largestContour every time. Not owned
+    void setContourTracker(ContourTracker *tracker) { tracker_ = tracker; }
+
+    int factor() const { return factor_; }
+    void setFactor(int factor) { factor_ = factor < 1 ? 1 : factor; }
+
+    // Last coarse mask (debugging)
+    const cv::Mat &coarseMask() const { return coarseMask_; }
+
+    // Coarse searches, how many needed the full resolution fallback, full resolution pixels thresholded
+    void printStats(std::ostream &out) const;
+
+private:
+    int largest(const cv::Mat &mask, const cv::Rect &roi, std::vector<std::vector<cv::Point>> &contours);
+
+    int factor_;
+    int margin_;
+    ContourTracker *tracker_ = nullptr;
+
+    cv::Mat small_;
+    cv::Mat coarseMask_;
+    std::vector<std::vector<cv::Point>> coarseContours_;
+
+    uint64_t searches_ = 0;
+    uint64_t fallbacks_ = 0;
+    uint64_t finePixels_ = 0;
+    uint64_t framePixels_ = 0;
+};
@@ -0,0 +1,106 @@
+#include "roiTracker.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <cstdlib>
+
+RoiTracker::RoiTracker(cv::Size frameSize, int margin, double maxFraction)
+    : full_(0, 0, frameSize.width, frameSize.height),
+      margin_(margin > 0 ? margin : 0),
+      maxFraction_(maxFraction)
+{
+}
+
+cv::Rect RoiTracker::predict()
+{
+    frames_++;
+
+    cv::Rect roi = full_;
+    if (tracking())
+    {
+        // Constant velocity : the box moves again by what it moved last frame,
+        // the margin grows by the same amount in case it speeds up or turns
+        const int padX = margin_ + std::abs(velocity_.x);
+        const int padY = margin_ + std::abs(velocity_.y);
+        cv::Rect predicted(last_.x + velocity_.x - padX, last_.y + velocity_.y - padY,
+                           last_.width + 2 * padX, last_.height + 2 * padY);
+        predicted &= full_;
+
+        if (predicted.area() > 0 && predicted.area() <= maxFraction_ * full_.area())
+        {
+            roi = predicted;
+            trackedFrames_++;
+        }
+    }
+
+    pixels_ += (uint64_t)roi.area();
+    return roi;
+}
+
+bool RoiTracker::needsFullFrame(const cv::Rect &roi, const cv::Rect &bbox) const
+{
+    if (roi == full_)
+        return false;
+    if (bbox.area() <= 0)
+        return true;
+
+    // Touching an inner ROI edge = the hand is probably cut there
+    return touchesInnerEdge(bbox, roi, full_.size());
+}
+
+cv::Rect RoiTracker::fullFrame()
+{
+    retries_++;
+    pixels_ += (uint64_t)full_.area();
+    return full_;
+}
+
+void RoiTracker::update(const cv::Rect &bbox)
+{
+    if (!enabled_ || bbox.area() <= 0)
+    {
+        hasTrack_ = false;
+        velocity_ = cv::Point(0, 0);
+        return;
+    }
+
+    if (hasTrack_)
+        velocity_ = (bbox.tl() + bbox.br() - last_.tl() - last_.br()) / 2;
+    else
+        velocity_ = cv::Point(0, 0);
+
+    last_ = bbox;
+    hasTrack_ = true;
+}
+
+void RoiTracker::reset()
+{
+    hasTrack_ = false;
+    velocity_ = cv::Point(0, 0);
+}
+
+void RoiTracker::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+    reset();
+}
+
+void RoiTracker::printStats(std::ostream &out) const
+{
+    if (frames_ == 0)
+        return;
+
+    const double fraction = (double)pixels_ / ((double)frames_ * full_.area());
+    out << "ROI tracking: " << trackedFrames_ << "/" << frames_ << " frames tracked, "
+        << retries_ << " full frame retries, " << fraction * 100.0 << "% of the pixels processed on average";
+    if (fraction > 0)
+        out << " (" << 1.0 / fraction << "x fewer)";
+    out << "\n";
+}
+
+bool touchesInnerEdge(const cv::Rect &box, const cv::Rect &region, const cv::Size &frameSize)
+{
+    return (box.x <= region.x && region.x > 0) ||
+           (box.y <= region.y && region.y > 0) ||
+           (box.x + box.width >= region.x + region.width && region.x + region.width < frameSize.width) ||
+           (box.y + box.height >= region.y + region.height && region.y + region.height < frameSize.height);
+}
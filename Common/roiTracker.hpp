@@ -0,0 +1,55 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// ----------------- RoiTracker ----------------- //
+// Once the hand is found, only the area around where it's expected next gets thresholded / searched
+//  - predict() = last bounding box moved by the last frame to frame motion (constant velocity),
+//    grown by margin + that motion on every side, clipped to the frame
+//  - No track yet (or tracking off) → the whole frame
+//  - Hand lost, or its box touches an ROI edge that isn't a frame edge (it may go on past it)
+//    → needsFullFrame() says so and the caller redoes the frame with fullFrame()
+//  - An ROI covering more than maxFraction of the frame is not worth it, the whole frame is used instead
+class RoiTracker
+{
+public:
+    RoiTracker(cv::Size frameSize, int margin = 48, double maxFraction = 0.6);
+
+    // ROI to process this frame (counted in the stats)
+    cv::Rect predict();
+    // True when the result found inside roi can't be trusted (bbox empty = nothing found)
+    bool needsFullFrame(const cv::Rect &roi, const cv::Rect &bbox) const;
+    // Whole frame, counted as a retry
+    cv::Rect fullFrame();
+    // Bounding box of the hand this frame, empty = lost (next predict() is the whole frame)
+    void update(const cv::Rect &bbox);
+
+    void reset();
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_; }
+    bool tracking() const { return enabled_ && hasTrack_; }
+
+    // Frames, tracked frames, full frame retries and the average share of the frame that was processed
+    void printStats(std::ostream &out) const;
+
+private:
+    cv::Rect full_;
+    int margin_;
+    double maxFraction_;
+    bool enabled_ = true;
+
+    bool hasTrack_ = false;
+    cv::Rect last_;
+    cv::Point velocity_; // Centre motion between the last two boxes
+
+    uint64_t frames_ = 0;
+    uint64_t trackedFrames_ = 0;
+    uint64_t retries_ = 0;
+    uint64_t pixels_ = 0; // Pixels handed out by predict() + fullFrame()
+};
+
+// box touches an edge of region that isn't also an edge of the frame (what's in there may go on past it)
+bool touchesInnerEdge(const cv::Rect &box, const cv::Rect &region, const cv::Size &frameSize);
@@ -0,0 +1,303 @@
+#include "shapeDescriptors.hpp"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MOMENTS_HAVE_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MOMENTS_HAVE_NEON 1
+#endif
+
+const char *const SHAPE_FEATURE_CSV_HEADER =
+    "hu1,hu2,hu3,hu4,hu5,hu6,hu7,solidity,extent,eccentricity,depth_bin0,depth_bin1,depth_bin2,depth_bin3,depth_bin4";
+
+// ----------------- Moment sums ----------------- //
+// cv::moments' contour terms (Green's theorem over each edge) of edges from .. n - 1, added to s[0 .. 9]
+// (m00 m10 m01 m20 m11 m02 m30 m21 m12 m03, before scaling). Exact integers, so every kernel gives the same sums
+struct MomentKernels
+{
+    const char *name;
+    void (*sums)(const int64_t *x, const int64_t *y, size_t n, int64_t s[10]);
+};
+
+static void momentSumsScalarFrom(const int64_t *x, const int64_t *y, size_t from, size_t n, int64_t s[10])
+{
+    int64_t a00 = 0, a10 = 0, a01 = 0, a20 = 0, a11 = 0, a02 = 0, a30 = 0, a21 = 0, a12 = 0, a03 = 0;
+    for (size_t i = from; i < n; i++)
+    {
+        const int64_t x0 = x[i], y0 = y[i], x1 = x[i + 1], y1 = y[i + 1];
+        const int64_t x02 = x0 * x0, y02 = y0 * y0, x12 = x1 * x1, y12 = y1 * y1;
+        const int64_t dxy = x0 * y1 - x1 * y0;
+        const int64_t xs = x0 + x1, ys = y0 + y1;
+
+        a00 += dxy;
+        a10 += dxy * xs;
+        a01 += dxy * ys;
+        a20 += dxy * (x0 * xs + x12);
+        a11 += dxy * (x0 * (ys + y0) + x1 * (ys + y1));
+        a02 += dxy * (y0 * ys + y12);
+        a30 += dxy * xs * (x02 + x12);
+        a03 += dxy * ys * (y02 + y12);
+        a21 += dxy * (x02 * (3 * y0 + y1) + 2 * x1 * x0 * ys + x12 * (y0 + 3 * y1));
+        a12 += dxy * (y02 * (3 * x0 + x1) + 2 * y1 * y0 * xs + y12 * (x0 + 3 * x1));
+    }
+    s[0] += a00;
+    s[1] += a10;
+    s[2] += a01;
+    s[3] += a20;
+    s[4] += a11;
+    s[5] += a02;
+    s[6] += a30;
+    s[7] += a21;
+    s[8] += a12;
+    s[9] += a03;
+}
+
+static void momentSumsScalar(const int64_t *x, const int64_t *y, size_t n, int64_t s[10])
+{
+    momentSumsScalarFrom(x, y, 0, n, s);
+}
+
+static const MomentKernels SCALAR_KERNELS = {"scalar", momentSumsScalar};
+
+// The vector kernels need every coordinate in 0 .. 32767 (checked by the caller) :
+//  - x * y, x * (x0 + x1), x * x * (3 * y0 + y1), ... have both operands in int32 → one 32 x 32 → 64 bit multiply
+//  - dxy = x0 * y1 - x1 * y0 fits in int32 too, only dxy (or dxy * xs) times a 64 bit factor needs the full
+//    64 bit product (neither AVX2 nor NEON has one, it's built from 3 32 bit multiplies)
+
+// ---------- AVX2 (x86, picked at runtime) ---------- //
+#ifdef MOMENTS_HAVE_AVX2
+// Low 64 bits of a * b (lo * lo + (hi * lo + lo * hi) << 32), right for signed values too
+__attribute__((target("avx2"))) static inline __m256i mul64Avx2(__m256i a, __m256i b)
+{
+    const __m256i lo = _mm256_mul_epu32(a, b);
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                           _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+__attribute__((target("avx2"))) static void momentSumsAvx2(const int64_t *x, const int64_t *y, size_t n, int64_t s[10])
+{
+    __m256i a[10];
+    for (int k = 0; k < 10; k++)
+        a[k] = _mm256_setzero_si256();
+
+    // 4 edges at a time, a lane keeps its own sums
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i x0 = _mm256_loadu_si256((const __m256i *)(x + i)), x1 = _mm256_loadu_si256((const __m256i *)(x + i + 1));
+        const __m256i y0 = _mm256_loadu_si256((const __m256i *)(y + i)), y1 = _mm256_loadu_si256((const __m256i *)(y + i + 1));
+        const __m256i x02 = _mm256_mul_epi32(x0, x0), y02 = _mm256_mul_epi32(y0, y0);
+        const __m256i x12 = _mm256_mul_epi32(x1, x1), y12 = _mm256_mul_epi32(y1, y1);
+        const __m256i dxy = _mm256_sub_epi64(_mm256_mul_epi32(x0, y1), _mm256_mul_epi32(x1, y0));
+        const __m256i xs = _mm256_add_epi64(x0, x1), ys = _mm256_add_epi64(y0, y1);
+        const __m256i dxs = _mm256_mul_epi32(dxy, xs), dys = _mm256_mul_epi32(dxy, ys);
+
+        a[0] = _mm256_add_epi64(a[0], dxy);
+        a[1] = _mm256_add_epi64(a[1], dxs);
+        a[2] = _mm256_add_epi64(a[2], dys);
+        a[3] = _mm256_add_epi64(a[3], mul64Avx2(dxy, _mm256_add_epi64(_mm256_mul_epi32(x0, xs), x12)));
+        a[4] = _mm256_add_epi64(a[4], mul64Avx2(dxy, _mm256_add_epi64(_mm256_mul_epi32(x0, _mm256_add_epi64(ys, y0)),
+                                                                      _mm256_mul_epi32(x1, _mm256_add_epi64(ys, y1)))));
+        a[5] = _mm256_add_epi64(a[5], mul64Avx2(dxy, _mm256_add_epi64(_mm256_mul_epi32(y0, ys), y12)));
+        a[6] = _mm256_add_epi64(a[6], mul64Avx2(dxs, _mm256_add_epi64(x02, x12)));
+        a[9] = _mm256_add_epi64(a[9], mul64Avx2(dys, _mm256_add_epi64(y02, y12)));
+
+        // 3 * y0 + y1, 2 * x1 * x0 * ys, ...
+        const __m256i y0y1 = _mm256_add_epi64(_mm256_add_epi64(y0, y0), ys), y1y0 = _mm256_add_epi64(_mm256_add_epi64(y1, y1), ys);
+        const __m256i x0x1 = _mm256_add_epi64(_mm256_add_epi64(x0, x0), xs), x1x0 = _mm256_add_epi64(_mm256_add_epi64(x1, x1), xs);
+        const __m256i t21 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epi32(x02, y0y1), _mm256_mul_epi32(x12, y1y0)),
+                                             _mm256_slli_epi64(_mm256_mul_epi32(_mm256_mul_epi32(x1, x0), ys), 1));
+        const __m256i t12 = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epi32(y02, x0x1), _mm256_mul_epi32(y12, x1x0)),
+                                             _mm256_slli_epi64(_mm256_mul_epi32(_mm256_mul_epi32(y1, y0), xs), 1));
+        a[7] = _mm256_add_epi64(a[7], mul64Avx2(dxy, t21));
+        a[8] = _mm256_add_epi64(a[8], mul64Avx2(dxy, t12));
+    }
+
+    alignas(32) int64_t lanes[4];
+    for (int k = 0; k < 10; k++)
+    {
+        _mm256_store_si256((__m256i *)lanes, a[k]);
+        s[k] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    momentSumsScalarFrom(x, y, i, n, s);
+}
+
+static const MomentKernels AVX2_KERNELS = {"avx2", momentSumsAvx2};
+#endif
+
+// ---------- NEON (AArch64) ---------- //
+// Same operations as the AVX2 kernel, 2 edges at a time
+#ifdef MOMENTS_HAVE_NEON
+// 32 x 32 → 64 bit product of the low halves (what _mm256_mul_epi32 does)
+static inline int64x2_t mul32Neon(int64x2_t a, int64x2_t b)
+{
+    return vmull_s32(vmovn_s64(a), vmovn_s64(b));
+}
+
+static inline int64x2_t mul64Neon(int64x2_t a, int64x2_t b)
+{
+    const uint64x2_t ua = vreinterpretq_u64_s64(a), ub = vreinterpretq_u64_s64(b);
+    const uint32x2_t aLo = vmovn_u64(ua), bLo = vmovn_u64(ub), aHi = vshrn_n_u64(ua, 32), bHi = vshrn_n_u64(ub, 32);
+    const uint32x2_t cross = vmla_u32(vmul_u32(aHi, bLo), aLo, bHi);
+    return vreinterpretq_s64_u64(vaddq_u64(vmull_u32(aLo, bLo), vshlq_n_u64(vmovl_u32(cross), 32)));
+}
+
+static void momentSumsNeon(const int64_t *x, const int64_t *y, size_t n, int64_t s[10])
+{
+    int64x2_t a[10];
+    for (int k = 0; k < 10; k++)
+        a[k] = vdupq_n_s64(0);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        const int64x2_t x0 = vld1q_s64(x + i), x1 = vld1q_s64(x + i + 1);
+        const int64x2_t y0 = vld1q_s64(y + i), y1 = vld1q_s64(y + i + 1);
+        const int64x2_t x02 = mul32Neon(x0, x0), y02 = mul32Neon(y0, y0);
+        const int64x2_t x12 = mul32Neon(x1, x1), y12 = mul32Neon(y1, y1);
+        const int64x2_t dxy = vsubq_s64(mul32Neon(x0, y1), mul32Neon(x1, y0));
+        const int64x2_t xs = vaddq_s64(x0, x1), ys = vaddq_s64(y0, y1);
+        const int64x2_t dxs = mul32Neon(dxy, xs), dys = mul32Neon(dxy, ys);
+
+        a[0] = vaddq_s64(a[0], dxy);
+        a[1] = vaddq_s64(a[1], dxs);
+        a[2] = vaddq_s64(a[2], dys);
+        a[3] = vaddq_s64(a[3], mul64Neon(dxy, vaddq_s64(mul32Neon(x0, xs), x12)));
+        a[4] = vaddq_s64(a[4], mul64Neon(dxy, vaddq_s64(mul32Neon(x0, vaddq_s64(ys, y0)), mul32Neon(x1, vaddq_s64(ys, y1)))));
+        a[5] = vaddq_s64(a[5], mul64Neon(dxy, vaddq_s64(mul32Neon(y0, ys), y12)));
+        a[6] = vaddq_s64(a[6], mul64Neon(dxs, vaddq_s64(x02, x12)));
+        a[9] = vaddq_s64(a[9], mul64Neon(dys, vaddq_s64(y02, y12)));
+
+        const int64x2_t y0y1 = vaddq_s64(vaddq_s64(y0, y0), ys), y1y0 = vaddq_s64(vaddq_s64(y1, y1), ys);
+        const int64x2_t x0x1 = vaddq_s64(vaddq_s64(x0, x0), xs), x1x0 = vaddq_s64(vaddq_s64(x1, x1), xs);
+        const int64x2_t t21 = vaddq_s64(vaddq_s64(mul32Neon(x02, y0y1), mul32Neon(x12, y1y0)),
+                                        vshlq_n_s64(mul32Neon(mul32Neon(x1, x0), ys), 1));
+        const int64x2_t t12 = vaddq_s64(vaddq_s64(mul32Neon(y02, x0x1), mul32Neon(y12, x1x0)),
+                                        vshlq_n_s64(mul32Neon(mul32Neon(y1, y0), xs), 1));
+        a[7] = vaddq_s64(a[7], mul64Neon(dxy, t21));
+        a[8] = vaddq_s64(a[8], mul64Neon(dxy, t12));
+    }
+
+    for (int k = 0; k < 10; k++)
+        s[k] += vaddvq_s64(a[k]);
+    momentSumsScalarFrom(x, y, i, n, s);
+}
+
+static const MomentKernels NEON_KERNELS = {"neon", momentSumsNeon};
+#endif
+
+// ---------- Dispatch ---------- //
+static const MomentKernels &pickKernels()
+{
+#ifdef MOMENTS_HAVE_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+        return AVX2_KERNELS;
+#endif
+#ifdef MOMENTS_HAVE_NEON
+    return NEON_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const char *shapeMomentsBackend()
+{
+    return pickKernels().name;
+}
+
+void ShapeDescriptorExtractor::extract(const std::vector<cv::Point> &contour, const HandGeometry &geometry,
+                                       ShapeFeatureVector &features)
+{
+    const size_t n = contour.size();
+
+    // ---------- Unpack, edge i = x_[i] → x_[i + 1] ---------- //
+    // spread : every coordinate OR'ed together, below 32768 = all of them in 0 .. 32767 (what the vector kernels need)
+    x_.resize(n + 1);
+    y_.resize(n + 1);
+    if (n > 0)
+    {
+        x_[0] = contour[n - 1].x;
+        y_[0] = contour[n - 1].y;
+    }
+    uint32_t spread = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        x_[i + 1] = contour[i].x;
+        y_[i + 1] = contour[i].y;
+        spread |= (uint32_t)contour[i].x | (uint32_t)contour[i].y;
+    }
+
+    // ---------- One pass : every moment up to the 3rd order ---------- //
+    int64_t s[10] = {};
+    const MomentKernels &k = spread < 32768 ? pickKernels() : SCALAR_KERNELS;
+    k.sums(x_.data(), y_.data(), n, s);
+    const int64_t a00 = s[0], a10 = s[1], a01 = s[2], a20 = s[3], a11 = s[4], a02 = s[5];
+    const int64_t a30 = s[6], a21 = s[7], a12 = s[8], a03 = s[9];
+
+    // Clockwise contours sum negative, the sign goes like in cv::moments (area ≥ 0 either way). Scaled by the same
+    // reciprocals it multiplies with, not divided → the same doubles
+    if (a00 != 0)
+    {
+        const double sign = a00 > 0 ? 1.0 : -1.0;
+        const double k2 = sign * 0.5, k6 = sign * (1.0 / 6), k12 = sign * (1.0 / 12), k24 = sign * (1.0 / 24);
+        const double k20 = sign * 0.05, k60 = sign * (1.0 / 60);
+        moments_ = cv::Moments(a00 * k2, a10 * k6, a01 * k6, a20 * k12, a11 * k24, a02 * k12,
+                               a30 * k20, a21 * k60, a12 * k60, a03 * k20);
+    }
+    else
+        moments_ = cv::Moments();
+
+    // ---------- Hu moments ---------- //
+    double hu[7];
+    cv::HuMoments(moments_, hu);
+    for (int i = 0; i < 7; i++)
+        features[FEATURE_HU1 + i] = hu[i] == 0 ? 0.0f : (float)(std::copysign(1.0, hu[i]) * -std::log10(std::fabs(hu[i])));
+
+    // ---------- Solidity, extent ---------- //
+    // Hull area : shoelace over the hull points (contour order, a closed polygon), exact in int64 too
+    int64_t twiceHullArea = 0;
+    const size_t hullCount = geometry.hull.size();
+    for (size_t i = 0, j = hullCount - 1; i < hullCount; j = i++)
+        twiceHullArea += (int64_t)geometry.hull[j].x * geometry.hull[i].y - (int64_t)geometry.hull[j].y * geometry.hull[i].x;
+    const double hullArea = std::fabs((double)twiceHullArea * 0.5);
+    const double boxArea = (double)geometry.box.width * geometry.box.height;
+    features[FEATURE_SOLIDITY] = hullArea > 0 ? (float)(geometry.area / hullArea) : 0.0f;
+    features[FEATURE_EXTENT] = boxArea > 0 ? (float)(geometry.area / boxArea) : 0.0f;
+
+    // ---------- Eccentricity ---------- //
+    // Covariance eigenvalues from the central moments, e = sqrt(1 - minor / major)
+    const double half = (moments_.mu20 + moments_.mu02) * 0.5, diff = (moments_.mu20 - moments_.mu02) * 0.5;
+    const double root = std::sqrt(diff * diff + moments_.mu11 * moments_.mu11);
+    const double major = half + root, minor = half - root;
+    features[FEATURE_ECCENTRICITY] = major > 0 ? (float)std::sqrt(std::max(0.0, 1.0 - minor / major)) : 0.0f;
+
+    // ---------- Defect depth histogram ---------- //
+    for (int b = 0; b < DEPTH_BINS; b++)
+        features[FEATURE_DEPTH_BIN0 + b] = 0.0f;
+    const float height = geometry.box.height > 0 ? (float)geometry.box.height : 1.0f;
+    for (const cv::Vec4i &defect : geometry.defects)
+    {
+        const float ratio = defect[3] / 256.0f / height;
+        const int bin = (int)(std::upper_bound(DEPTH_BIN_EDGES.begin(), DEPTH_BIN_EDGES.end(), ratio) - DEPTH_BIN_EDGES.begin());
+        features[FEATURE_DEPTH_BIN0 + bin] += 1.0f;
+    }
+}
+
+void ShapeDescriptorExtractor::writeCsv(std::ostream &out, const ShapeFeatureVector &features)
+{
+    // Enough digits to read back the exact float, like the hand features
+    const std::streamsize precision = out.precision(std::numeric_limits<float>::max_digits10);
+    for (int i = 0; i < SHAPE_FEATURE_COUNT; i++)
+        out << (i ? "," : "") << features[i];
+    out.precision(precision);
+}
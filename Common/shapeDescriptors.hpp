@@ -0,0 +1,67 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "handFeatures.hpp"
+
+// ----------------- ShapeDescriptorExtractor ----------------- //
+// Shape of the hand past the 9 coarse numbers : Hu moments, solidity, extent, eccentricity, defect depth histogram
+//  - One pass over the contour for every moment up to the 3rd order (cv::moments' polygon formula). Contour points are
+//    integers, each edge's terms are exact integers too → summed in int64 the sums are exact in any order : same
+//    moments as cv::moments to the bit, with AVX2 (x86, checked at runtime) / NEON kernels or the scalar loop
+//  - Hull area from the hull points HandFeatureExtractor already has, defects and box from the same HandGeometry
+//  - No overflow : in a 640x480 frame an edge's 3rd order term is below 2^41 * its length, the sums stay below
+//    2^41 * perimeter
+enum ShapeFeature
+{
+    FEATURE_HU1, // Hu moments, log scaled : -sign(h) * log10(|h|), 0 for h = 0 (raw ones span 1e-1 .. 1e-20)
+    FEATURE_HU2,
+    FEATURE_HU3,
+    FEATURE_HU4,
+    FEATURE_HU5,
+    FEATURE_HU6,
+    FEATURE_HU7,
+    FEATURE_SOLIDITY,     // Contour area / hull area
+    FEATURE_EXTENT,       // Contour area / bounding box area
+    FEATURE_ECCENTRICITY, // Of the ellipse with the same 2nd order moments, 0 = round .. 1 = a line
+    FEATURE_DEPTH_BIN0,   // Defects by depth / box height, bins split at DEPTH_BIN_EDGES, they add up to numDefects
+    FEATURE_DEPTH_BIN1,
+    FEATURE_DEPTH_BIN2,
+    FEATURE_DEPTH_BIN3,
+    FEATURE_DEPTH_BIN4,
+    SHAPE_FEATURE_COUNT
+};
+
+using ShapeFeatureVector = std::array<float, SHAPE_FEATURE_COUNT>;
+
+// CSV column names of the shape block, in ShapeFeature order
+extern const char *const SHAPE_FEATURE_CSV_HEADER;
+
+constexpr int DEPTH_BINS = FEATURE_DEPTH_BIN4 - FEATURE_DEPTH_BIN0 + 1;
+constexpr std::array<float, DEPTH_BINS - 1> DEPTH_BIN_EDGES = {0.05f, 0.1f, 0.2f, 0.3f};
+
+// "avx2", "neon" or "scalar" (contours with a coordinate past 32767 always go through the scalar loop)
+const char *shapeMomentsBackend();
+
+class ShapeDescriptorExtractor
+{
+public:
+    // contour + the geometry HandFeatureExtractor::extract() built from it this frame
+    void extract(const std::vector<cv::Point> &contour, const HandGeometry &geometry, ShapeFeatureVector &features);
+
+    // Spatial moments of the last contour, same as cv::moments(contour) (m00 .. m03, the rest derived from them)
+    const cv::Moments &moments() const { return moments_; }
+
+    // Same block, one CSV row fragment
+    static void writeCsv(std::ostream &out, const ShapeFeatureVector &features);
+
+private:
+    cv::Moments moments_;
+
+    // Contour coordinates with the last point first again (x_[i] → x_[i + 1] is edge i), kept between frames
+    std::vector<int64_t> x_, y_;
+};
@@ -0,0 +1,340 @@
+#include "skinLut.hpp"
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// ----------------- OpenCV 8-bit colour conversions ----------------- //
+// Integer versions of cvtColor(COLOR_BGR2YCrCb) / cvtColor(COLOR_BGR2HSV) for CV_8U, same rounding so the
+// table gives the same answer as cvtColor + inRange for every colour
+
+static inline uint8_t clamp8(int v)
+{
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// yuv_shift = 14, R2Y / G2Y / B2Y + the Cr / Cb scale factors
+static const int YCC_SHIFT = 14;
+static const int YCC_R = 4899;
+static const int YCC_G = 9617;
+static const int YCC_B = 1868;
+static const int YCC_CR = 11682;
+static const int YCC_CB = 9241;
+static const int YCC_DELTA = 128 << YCC_SHIFT;
+static const int YCC_ROUND = 1 << (YCC_SHIFT - 1);
+
+static inline void bgrToYCrCb(int b, int g, int r, int &y, int &cr, int &cb)
+{
+    y = (b * YCC_B + g * YCC_G + r * YCC_R + YCC_ROUND) >> YCC_SHIFT;
+    cr = clamp8(((r - y) * YCC_CR + YCC_DELTA + YCC_ROUND) >> YCC_SHIFT);
+    cb = clamp8(((b - y) * YCC_CB + YCC_DELTA + YCC_ROUND) >> YCC_SHIFT);
+}
+
+// hsv_shift = 12, divisions go through the same rounded reciprocal tables OpenCV builds, H range 0..180
+static const int HSV_SHIFT = 12;
+static const int HSV_ROUND = 1 << (HSV_SHIFT - 1);
+
+struct HsvTables
+{
+    int sdiv[256];
+    int hdiv[256];
+
+    HsvTables()
+    {
+        sdiv[0] = hdiv[0] = 0;
+        for (int i = 1; i < 256; i++)
+        {
+            sdiv[i] = (int)std::lround((255 << HSV_SHIFT) / (1. * i));
+            hdiv[i] = (int)std::lround((180 << HSV_SHIFT) / (6. * i));
+        }
+    }
+};
+
+static const HsvTables &hsvTables()
+{
+    static const HsvTables tables;
+    return tables;
+}
+
+static inline void bgrToHSV(const HsvTables &t, int b, int g, int r, int &h, int &s, int &v)
+{
+    v = std::max(b, std::max(g, r));
+    int vmin = std::min(b, std::min(g, r));
+    int diff = v - vmin;
+
+    s = (diff * t.sdiv[v] + HSV_ROUND) >> HSV_SHIFT;
+
+    if (v == r)
+        h = g - b;
+    else if (v == g)
+        h = b - r + 2 * diff;
+    else
+        h = r - g + 4 * diff;
+    h = (h * t.hdiv[diff] + HSV_ROUND) >> HSV_SHIFT;
+    h += h < 0 ? 180 : 0;
+    h = clamp8(h);
+}
+
+// ----------------- SkinLut ----------------- //
+SkinLut::SkinLut(int bitsPerChannel)
+    : bits_(bitsPerChannel == 6 ? 6 : 8),
+      shift_(8 - bits_),
+      words_(((size_t)1 << (3 * bits_)) / 64)
+{
+    combined_.assign(words_, ~0ull);
+}
+
+void SkinLut::setRule(Rule &rule, const int low[3], const int high[3])
+{
+    // Trackbar loops call this every frame, only a real change costs a rebuild
+    bool sameBounds = true;
+    for (int c = 0; c < 3; c++)
+        sameBounds = sameBounds && rule.low[c] == low[c] && rule.high[c] == high[c];
+    if (sameBounds && rule.enabled)
+        return;
+
+    if (!sameBounds || rule.table.empty())
+    {
+        std::copy(low, low + 3, rule.low);
+        std::copy(high, high + 3, rule.high);
+        rule.dirty = true;
+    }
+    rule.enabled = true;
+    combinedDirty_ = true;
+}
+
+void SkinLut::setYCrCb(int lowY, int lowCr, int lowCb, int highY, int highCr, int highCb)
+{
+    const int low[3] = {lowY, lowCr, lowCb};
+    const int high[3] = {highY, highCr, highCb};
+    setRule(ycrcb_, low, high);
+}
+
+void SkinLut::setHSV(int lowH, int lowS, int lowV, int highH, int highS, int highV)
+{
+    const int low[3] = {lowH, lowS, lowV};
+    const int high[3] = {highH, highS, highV};
+    setRule(hsv_, low, high);
+}
+
+// inRange on 8-bit images compares against the bounds rounded to int (lower rounded up, upper down)
+void SkinLut::setYCrCb(const cv::Scalar &lower, const cv::Scalar &upper)
+{
+    setYCrCb((int)std::ceil(lower[0]), (int)std::ceil(lower[1]), (int)std::ceil(lower[2]),
+             (int)std::floor(upper[0]), (int)std::floor(upper[1]), (int)std::floor(upper[2]));
+}
+
+void SkinLut::setHSV(const cv::Scalar &lower, const cv::Scalar &upper)
+{
+    setHSV((int)std::ceil(lower[0]), (int)std::ceil(lower[1]), (int)std::ceil(lower[2]),
+           (int)std::floor(upper[0]), (int)std::floor(upper[1]), (int)std::floor(upper[2]));
+}
+
+void SkinLut::clearYCrCb()
+{
+    if (ycrcb_.enabled)
+        combinedDirty_ = true;
+    ycrcb_.enabled = false;
+}
+
+void SkinLut::clearHSV()
+{
+    if (hsv_.enabled)
+        combinedDirty_ = true;
+    hsv_.enabled = false;
+}
+
+// Sets bits [from, to) of a run of bits starting at word 0
+static void setBitRange(uint64_t *words, int from, int to)
+{
+    for (int i = from; i < to;)
+    {
+        int bit = i & 63;
+        int count = std::min(64 - bit, to - i);
+        uint64_t run = count == 64 ? ~0ull : ((1ull << count) - 1) << bit;
+        words[i >> 6] |= run;
+        i += count;
+    }
+}
+
+// Tables are in index order (b, g, then r innermost), every (b, g) pair owns a run of 2^bits consecutive r bits
+//
+// YCrCb : for a fixed (b, g), Y and Cr never go down as r goes up and Cb never goes up (Y moves by at most 1
+// per step of r, so r - Y and b - Y are monotonic too), every bound is a cut-off on r and the colours that pass
+// are one r interval → 6 binary searches per (b, g) instead of 256 conversions
+void SkinLut::buildYCrCb()
+{
+    Rule &rule = ycrcb_;
+    rule.table.assign(words_, 0);
+
+    const int n = 1 << bits_;
+    const int centre = shift_ ? 1 << (shift_ - 1) : 0;
+
+    for (int bi = 0; bi < n; bi++)
+    {
+        const int b = (bi << shift_) | centre;
+        for (int gi = 0; gi < n; gi++)
+        {
+            const int g = (gi << shift_) | centre;
+
+            auto channels = [&](int ri, int &y, int &cr, int &cb)
+            { bgrToYCrCb(b, g, (ri << shift_) | centre, y, cr, cb); };
+
+            // First ri in [0, n) where pred holds, pred goes false → true as ri grows
+            auto firstTrue = [&](auto pred)
+            {
+                int lo = 0, hi = n;
+                while (lo < hi)
+                {
+                    int mid = (lo + hi) / 2;
+                    int y, cr, cb;
+                    channels(mid, y, cr, cb);
+                    if (pred(y, cr, cb))
+                        hi = mid;
+                    else
+                        lo = mid + 1;
+                }
+                return lo;
+            };
+
+            int from = std::max({firstTrue([&](int y, int, int) { return y >= rule.low[0]; }),
+                                 firstTrue([&](int, int cr, int) { return cr >= rule.low[1]; }),
+                                 firstTrue([&](int, int, int cb) { return cb <= rule.high[2]; })});
+            int to = std::min({firstTrue([&](int y, int, int) { return y > rule.high[0]; }),
+                               firstTrue([&](int, int cr, int) { return cr > rule.high[1]; }),
+                               firstTrue([&](int, int, int cb) { return cb < rule.low[2]; })});
+
+            size_t row = ((size_t)bi * n + gi) * n; // Bit index of (bi, gi, 0)
+            if (from < to)
+                setBitRange(rule.table.data() + row / 64, (int)(row % 64) + from, (int)(row % 64) + to);
+        }
+    }
+
+    rule.dirty = false;
+    rebuilds_++;
+}
+
+// HSV : H and S aren't monotonic in any one channel, so every colour is converted, one 64-bit word at a time,
+// with the b planes split over the shared ThreadPool (~4x faster for the 2 MB table on a 4 core board)
+void SkinLut::buildHSV()
+{
+    Rule &rule = hsv_;
+    rule.table.assign(words_, 0);
+
+    const HsvTables &t = hsvTables();
+    const int n = 1 << bits_;
+    const int centre = shift_ ? 1 << (shift_ - 1) : 0;
+    const size_t planeWords = words_ / n; // One b plane
+    const int lowH = rule.low[0], lowS = rule.low[1], lowV = rule.low[2];
+    const int highH = rule.high[0], highS = rule.high[1], highV = rule.high[2];
+
+    auto buildPlanes = [&](int firstB, int lastB)
+    {
+        for (int bi = firstB; bi < lastB; bi++)
+        {
+            const int b = (bi << shift_) | centre;
+            uint64_t *word = rule.table.data() + (size_t)bi * planeWords;
+            for (int gi = 0; gi < n; gi++)
+            {
+                const int g = (gi << shift_) | centre;
+                for (int ri = 0; ri < n; ri += 64, word++)
+                {
+                    uint64_t bitsSet = 0;
+                    for (int k = 0; k < 64; k++)
+                    {
+                        const int r = ((ri + k) << shift_) | centre;
+                        int h, s, v;
+                        bgrToHSV(t, b, g, r, h, s, v);
+                        bool in = h >= lowH && h <= highH && s >= lowS && s <= highS && v >= lowV && v <= highV;
+                        bitsSet |= (uint64_t)in << k;
+                    }
+                    *word = bitsSet;
+                }
+            }
+        }
+    };
+
+    // The 32 KB table is built faster than a thread starts
+    const int tasks = bits_ == 8 ? ThreadPool::shared().size() : 1;
+    ThreadPool::shared().run(tasks, [&](int i)
+                             { buildPlanes(n * i / tasks, n * (i + 1) / tasks); });
+
+    rule.dirty = false;
+    rebuilds_++;
+}
+
+void SkinLut::update()
+{
+    if (ycrcb_.enabled && ycrcb_.dirty)
+        buildYCrCb();
+    if (hsv_.enabled && hsv_.dirty)
+        buildHSV();
+
+    if (!combinedDirty_)
+        return;
+
+    // AND of the enabled rules, a disabled rule keeps its table so turning it back on is free
+    combined_.assign(words_, ~0ull);
+    for (const Rule *rule : {&ycrcb_, &hsv_})
+    {
+        if (!rule->enabled)
+            continue;
+        for (size_t i = 0; i < words_; i++)
+            combined_[i] &= rule->table[i];
+    }
+    combinedDirty_ = false;
+}
+
+// One table lookup per pixel, strips of fewer rows than this aren't worth waking a worker
+static const int MIN_STRIP_ROWS = 32;
+
+void SkinLut::apply(const cv::Mat &bgr, cv::Mat &mask)
+{
+    CV_Assert(bgr.type() == CV_8UC3);
+
+    update();
+    mask.create(bgr.rows, bgr.cols, CV_8UC1);
+
+    // Pixels are independent, row strips over the shared pool
+    const uint64_t *table = combined_.data();
+    ThreadPool::shared().strips(bgr.rows, 0, MIN_STRIP_ROWS, [&](const Strip &s)
+                                {
+        for (int y = s.y0; y < s.y1; y++)
+        {
+            const uint8_t *p = bgr.ptr<uint8_t>(y);
+            uint8_t *out = mask.ptr<uint8_t>(y);
+            for (int x = 0; x < bgr.cols; x++, p += 3)
+            {
+                uint32_t i = index(p[0], p[1], p[2]);
+                out[x] = (uint8_t)(0 - ((table[i >> 6] >> (i & 63)) & 1)); // 1 → 255
+            }
+        } });
+}
+
+void SkinLut::apply(const cv::Mat &bgr, BitMask &mask)
+{
+    CV_Assert(bgr.type() == CV_8UC3);
+
+    update();
+    mask.create(bgr.cols, bgr.rows);
+
+    const uint64_t *table = combined_.data();
+    ThreadPool::shared().strips(bgr.rows, 0, MIN_STRIP_ROWS, [&](const Strip &s)
+                                {
+        for (int y = s.y0; y < s.y1; y++)
+        {
+            const uint8_t *p = bgr.ptr<uint8_t>(y);
+            uint64_t *out = mask.row(y);
+            for (int x0 = 0; x0 < bgr.cols; x0 += 64)
+            {
+                const int count = std::min(64, bgr.cols - x0);
+                uint64_t word = 0;
+                for (int k = 0; k < count; k++, p += 3)
+                {
+                    uint32_t i = index(p[0], p[1], p[2]);
+                    word |= ((table[i >> 6] >> (i & 63)) & 1) << k;
+                }
+                out[x0 >> 6] = word;
+            }
+        } });
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "bitMask.hpp"
+
+// ----------------- SkinLut ----------------- //
+// BGR → skin mask with one table lookup per pixel instead of cvtColor(YCrCb / HSV) + inRange
+//  - One bit per BGR colour : bit set = colour passes every enabled rule
+//  - 8 bits per channel : 2^24 bits = 2 MB, exact (same integer formulas as OpenCV's 8-bit cvtColor + inRange)
+//  - 6 bits per channel : 2^18 bits = 32 KB, fits in L1/L2, colours are bucketed by 4 per channel and each
+//    bucket is classified by its centre, so pixels near a bound can come out differently
+//  - Each rule has its own table, moving a trackbar only rebuilds the rule it belongs to, then the rules are ANDed
+//  - Rules with no range set are ignored, no rule at all = every pixel passes
+class SkinLut
+{
+public:
+    explicit SkinLut(int bitsPerChannel = 8);
+
+    // Same channel order / ranges as the cv::Scalar bounds passed to inRange (H is 0..180)
+    void setYCrCb(int lowY, int lowCr, int lowCb, int highY, int highCr, int highCb);
+    void setHSV(int lowH, int lowS, int lowV, int highH, int highS, int highV);
+    void setYCrCb(const cv::Scalar &lower, const cv::Scalar &upper);
+    void setHSV(const cv::Scalar &lower, const cv::Scalar &upper);
+    void clearYCrCb();
+    void clearHSV();
+
+    // Rebuilds whatever changed since the last call, apply() does it for you
+    void update();
+
+    // mask = 255 where the pixel passes, 0 elsewhere (CV_8UC1, same size as bgr)
+    void apply(const cv::Mat &bgr, cv::Mat &mask);
+    // Same mask straight into bits, 64 lookups per stored word
+    void apply(const cv::Mat &bgr, BitMask &mask);
+
+    bool contains(uint8_t b, uint8_t g, uint8_t r) const
+    {
+        uint32_t i = index(b, g, r);
+        return (combined_[i >> 6] >> (i & 63)) & 1;
+    }
+
+    int bitsPerChannel() const { return bits_; }
+    int rebuilds() const { return rebuilds_; } // How many rule tables were rebuilt so far
+
+private:
+    struct Rule
+    {
+        bool enabled = false;
+        bool dirty = false;
+        int low[3] = {0, 0, 0};
+        int high[3] = {255, 255, 255};
+        std::vector<uint64_t> table;
+    };
+
+    uint32_t index(uint8_t b, uint8_t g, uint8_t r) const
+    {
+        return ((uint32_t)(b >> shift_) << (2 * bits_)) | ((uint32_t)(g >> shift_) << bits_) | (uint32_t)(r >> shift_);
+    }
+
+    void setRule(Rule &rule, const int low[3], const int high[3]);
+    void buildYCrCb();
+    void buildHSV();
+
+    int bits_;
+    int shift_; // 8 - bits_
+    size_t words_;
+
+    Rule ycrcb_;
+    Rule hsv_;
+    std::vector<uint64_t> combined_;
+    bool combinedDirty_ = true;
+    int rebuilds_ = 0;
+};
@@ -0,0 +1,217 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Pause between polls of a spinning worker (~40 to 140 cycles on x86)
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// How long an idle worker polls for the next run before it sleeps (~0.1 to 0.5 ms), long enough for the next
+// stage of the same frame, short enough that the cores are free between frames
+static const int SPIN_POLLS = 4096;
+
+static const uint64_t TASK_MASK = 0xFFFF;
+static const int MAX_TASKS = 0xFFFF;
+
+static inline uint64_t packRun(uint32_t generation, int tasks)
+{
+    return ((uint64_t)generation << 32) | ((uint64_t)tasks << 16);
+}
+
+// Set while this thread runs a task (nested runs go inline)
+static thread_local bool insideTask = false;
+
+// CPUs this process may run on, in order
+static std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+    }
+#endif
+    return cpus;
+}
+
+ThreadPool::ThreadPool(int threads, bool pin)
+{
+    const std::vector<int> cpus = allowedCpus();
+    if (threads <= 0)
+        threads = !cpus.empty() ? (int)cpus.size() : (int)std::max(1u, std::thread::hardware_concurrency());
+
+    // Worker i → (i + 1)th allowed core, core 0 of the set is left to the calling thread / capture / display
+    for (int i = 1; i < threads; i++)
+    {
+        const int cpu = pin && !cpus.empty() ? cpus[(size_t)i % cpus.size()] : -1;
+        workers_.emplace_back(&ThreadPool::workerLoop, this, cpu);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_.store(true);
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_)
+        worker.join();
+}
+
+// ----------------- Shared pool ----------------- //
+static int sharedThreads = 0;
+static bool sharedPin = true;
+static std::atomic<bool> sharedCreated{false};
+
+void ThreadPool::configureShared(int threads, bool pin)
+{
+    if (sharedCreated.load())
+        return;
+    sharedThreads = threads;
+    sharedPin = pin;
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool((sharedCreated.store(true), sharedThreads), sharedPin);
+    return pool;
+}
+
+// ----------------- Runs ----------------- //
+int ThreadPool::stripCount(int height, int minRows) const
+{
+    const int limit = limit_.load(std::memory_order_relaxed);
+    const int threads = limit > 0 ? std::min(limit, size()) : size();
+    return std::max(1, std::min(threads, height / std::max(1, minRows)));
+}
+
+void ThreadPool::work(uint32_t generation)
+{
+    uint64_t cur = next_.load(std::memory_order_acquire);
+    while ((uint32_t)(cur >> 32) == generation)
+    {
+        const int task = (int)(cur & TASK_MASK);
+        const int tasks = (int)((cur >> 16) & TASK_MASK);
+        if (task >= tasks)
+            break;
+        if (!next_.compare_exchange_weak(cur, cur + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        // Claimed a task of this run, the caller can't start another run before it's done so fn / ctx are this run's
+        insideTask = true;
+        fn_.load(std::memory_order_relaxed)(ctx_.load(std::memory_order_relaxed), task);
+        insideTask = false;
+        pending_.fetch_sub(1, std::memory_order_release);
+        cur = next_.load(std::memory_order_acquire);
+    }
+}
+
+void ThreadPool::dispatch(int tasks, TaskFn fn, void *ctx)
+{
+    if (tasks <= 0)
+        return;
+
+    bool idle = false;
+    if (tasks == 1 || tasks > MAX_TASKS || workers_.empty() || insideTask ||
+        !busy_.compare_exchange_strong(idle, true, std::memory_order_acquire))
+    {
+        for (int i = 0; i < tasks; i++)
+            fn(ctx, i);
+        inlineRuns_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    fn_.store(fn, std::memory_order_relaxed);
+    ctx_.store(ctx, std::memory_order_relaxed);
+    pending_.store(tasks, std::memory_order_relaxed);
+    const uint32_t generation = (uint32_t)(next_.load(std::memory_order_relaxed) >> 32) + 1;
+    next_.store(packRun(generation, tasks)); // seq_cst : publishes the run, and pairs with sleeping_ below
+
+    // Only pay for the futex when somebody is actually asleep
+    if (sleeping_.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_.notify_all();
+    }
+
+    // The caller takes tasks too, then waits for the ones still running on the workers
+    work(generation);
+    for (int polls = 0; pending_.load(std::memory_order_acquire) > 0; polls++)
+    {
+        if (polls < SPIN_POLLS)
+            cpuRelax();
+        else
+            std::this_thread::yield(); // More threads than free cores, let the worker we wait for run
+    }
+
+    busy_.store(false, std::memory_order_release);
+    parallelRuns_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::workerLoop(int cpu)
+{
+#ifdef __linux__
+    if (cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+            pinned_.fetch_add(1, std::memory_order_relaxed);
+    }
+#else
+    (void)cpu;
+#endif
+
+    uint32_t seen = 0;
+    while (true)
+    {
+        uint32_t generation = (uint32_t)(next_.load(std::memory_order_acquire) >> 32);
+        for (int i = 0; i < SPIN_POLLS && generation == seen && !stop_.load(std::memory_order_relaxed); i++)
+        {
+            cpuRelax();
+            generation = (uint32_t)(next_.load(std::memory_order_acquire) >> 32);
+        }
+
+        if (generation == seen)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleeping_.fetch_add(1); // seq_cst, see dispatch()
+            wake_.wait(lock, [&]
+                       { return stop_.load() || (uint32_t)(next_.load() >> 32) != seen; });
+            sleeping_.fetch_sub(1);
+            generation = (uint32_t)(next_.load(std::memory_order_acquire) >> 32);
+        }
+
+        if (stop_.load())
+            return;
+
+        seen = generation;
+        work(generation);
+    }
+}
+
+void ThreadPool::printStats(std::ostream &out) const
+{
+    out << "Thread pool: " << size() << " threads (" << pinnedWorkers() << " workers pinned), "
+        << parallelRuns_.load(std::memory_order_relaxed) << " parallel runs, "
+        << inlineRuns_.load(std::memory_order_relaxed) << " inline\n";
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ----------------- ThreadPool ----------------- //
+// Persistent workers for splitting one frame's stages over the cores (lower latency per frame, not just more frames)
+//  - Workers are started once (shared() at startup) and pinned one per core, a run never creates a thread
+//  - run(tasks, fn) calls fn(task) for task = 0 .. tasks - 1 on the workers + the calling thread, returns when all are done
+//  - Nothing is allocated per run : the task function goes through a function pointer + context, not std::function
+//  - Workers spin a little after a run (the next stage of the frame is usually right behind), then sleep on a condvar
+//  - A run started from inside a task, or while another thread's run is going, is done inline on the caller
+//    (stages can call each other without caring who's already parallel)
+//  - Tasks must not throw
+struct Strip
+{
+    int index;          // 0 .. strip count - 1
+    int y0, y1;         // Rows this strip writes
+    int readY0, readY1; // Rows it may read : y0 - halo .. y1 + halo, clipped to the image
+};
+
+class ThreadPool
+{
+public:
+    // threads = workers + the calling thread, 0 = every core this process may run on
+    // pin : worker i is bound to the (i + 1)th allowed core, the calling thread is left alone
+    explicit ThreadPool(int threads = 0, bool pin = true);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Process wide pool the stages in Common use, created on the first call
+    // configureShared() before that picks its size (YAML profile / command line), later calls are ignored
+    static ThreadPool &shared();
+    static void configureShared(int threads, bool pin = true);
+
+    int size() const { return (int)workers_.size() + 1; }
+    int pinnedWorkers() const { return pinned_.load(std::memory_order_relaxed); }
+
+    template <class F>
+    void run(int tasks, F &&fn)
+    {
+        using Fn = typename std::remove_reference<F>::type;
+        dispatch(tasks, [](void *ctx, int task)
+                 { (*static_cast<Fn *>(ctx))(task); },
+                 (void *)&fn);
+    }
+
+    // Rows 0 .. height split in at most size() strips of at least minRows rows, fn(const Strip &) per strip
+    // halo = how many rows above / below its own the strip reads (blur radius, kernel half size, ...)
+    template <class F>
+    void strips(int height, int halo, int minRows, F &&fn)
+    {
+        const int count = stripCount(height, minRows);
+        run(count, [&](int i)
+            {
+                Strip s;
+                s.index = i;
+                s.y0 = (int)((int64_t)height * i / count);
+                s.y1 = (int)((int64_t)height * (i + 1) / count);
+                s.readY0 = s.y0 - halo < 0 ? 0 : s.y0 - halo;
+                s.readY1 = s.y1 + halo > height ? height : s.y1 + halo;
+                fn(s); });
+    }
+
+    // How many strips strips() uses for that height (per strip buffers, partial histograms, ...)
+    int stripCount(int height, int minRows) const;
+
+    // strips() uses at most this many threads (benchmarks sweeping the thread count), 0 = size()
+    void setThreadLimit(int threads) { limit_.store(threads, std::memory_order_relaxed); }
+
+    // Parallel runs vs runs done inline on the caller (nested / busy / one task)
+    void printStats(std::ostream &out) const;
+
+private:
+    using TaskFn = void (*)(void *ctx, int task);
+
+    void dispatch(int tasks, TaskFn fn, void *ctx);
+    void workerLoop(int cpu);
+    void work(uint32_t generation);
+
+    std::vector<std::thread> workers_;
+    std::atomic<int> pinned_{0};
+    std::atomic<int> limit_{0};
+
+    // Current run : generation (32 bits) | task count (16 bits) | next task (16 bits), tasks are claimed with CAS
+    // on the whole word so a worker late from the previous run can never take a task of the next one
+    std::atomic<uint64_t> next_{0};
+    std::atomic<TaskFn> fn_{nullptr};
+    std::atomic<void *> ctx_{nullptr};
+    std::atomic<int> pending_{0};
+    std::atomic<bool> busy_{false};
+
+    std::atomic<bool> stop_{false};
+    std::atomic<int> sleeping_{0};
+    std::mutex mutex_; // Only parks idle workers
+    std::condition_variable wake_;
+
+    std::atomic<uint64_t> parallelRuns_{0};
+    std::atomic<uint64_t> inlineRuns_{0};
+};
@@ -0,0 +1,585 @@
+#include "thresholdStage.hpp"
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define THRESHOLD_HAVE_AVX2 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define THRESHOLD_HAVE_NEON 1
+#endif
+
+LumaView lumaFromYUYV(const uint8_t *data, int width, int height, size_t stride)
+{
+    LumaView luma;
+    luma.data = data; // Y0 is the first byte of every YUYV pair
+    luma.width = width;
+    luma.height = height;
+    luma.rowStride = stride;
+    luma.pixelStride = 2;
+    return luma;
+}
+
+LumaView lumaFromYUYV(const FrameView &view)
+{
+    return lumaFromYUYV(view.data, view.width, view.height, view.stride);
+}
+
+LumaView lumaFromGray(const cv::Mat &gray)
+{
+    CV_Assert(gray.type() == CV_8UC1);
+
+    LumaView luma;
+    luma.data = gray.data;
+    luma.width = gray.cols;
+    luma.height = gray.rows;
+    luma.rowStride = gray.step;
+    luma.pixelStride = 1;
+    return luma;
+}
+
+LumaView lumaFromBGR(const cv::Mat &bgr)
+{
+    CV_Assert(bgr.type() == CV_8UC3);
+
+    LumaView luma;
+    luma.data = bgr.data;
+    luma.width = bgr.cols;
+    luma.height = bgr.rows;
+    luma.rowStride = bgr.step;
+    luma.pixelStride = 3;
+    luma.bgr = true;
+    return luma;
+}
+
+// BORDER_REFLECT_101 : ... 2 1 | 0 1 2 ... n-1 | n-2 n-3 ...
+static inline int reflect101(int i, int n)
+{
+    if (n == 1)
+        return 0;
+    while (i < 0 || i >= n)
+    {
+        if (i < 0)
+            i = -i;
+        if (i >= n)
+            i = 2 * (n - 1) - i;
+    }
+    return i;
+}
+
+// cv::COLOR_BGR2GRAY for 8-bit : 14 bit fixed point BT.601 weights, rounded
+static const int GRAY_B = 1868;
+static const int GRAY_G = 9617;
+static const int GRAY_R = 4899;
+static const int GRAY_SHIFT = 14;
+
+static inline uint8_t grayFromBGR(const uint8_t *p)
+{
+    return (uint8_t)((p[0] * GRAY_B + p[1] * GRAY_G + p[2] * GRAY_R + (1 << (GRAY_SHIFT - 1))) >> GRAY_SHIFT);
+}
+
+// ----------------- Row kernels ----------------- //
+// Each source row goes through three steps, all on small buffers that stay in L1 :
+//  1. gray   : source row → gray row (copy, YUYV de-interleave or BGR2GRAY)
+//  2. hblur  : horizontal [1 4 6 4 1] on the gray row padded by 2 reflected pixels each side → uint16 (16x, max 4080)
+//  3. vblur  : vertical [1 4 6 4 1] over the 5 rolling uint16 rows → (v + 128) >> 8 → > thresh ? 255 : 0
+// Every backend does the exact same integer math, they only differ in how many pixels they do at once
+struct RowKernels
+{
+    const char *name;
+    void (*gray)(const uint8_t *src, int pixelStride, bool bgr, int width, uint8_t *dst);
+    void (*hblur)(const uint8_t *padded, int width, uint16_t *dst);
+    void (*vblur)(const uint16_t *r0, const uint16_t *r1, const uint16_t *r2, const uint16_t *r3, const uint16_t *r4,
+                  int width, int threshVal, uint8_t *dst);
+};
+
+// ---------- Scalar ---------- //
+static void grayRowScalar(const uint8_t *src, int pixelStride, bool bgr, int width, uint8_t *dst, int from)
+{
+    if (bgr)
+    {
+        for (int x = from; x < width; x++)
+            dst[x] = grayFromBGR(src + (size_t)x * 3);
+    }
+    else if (pixelStride == 1)
+        std::memcpy(dst + from, src + from, (size_t)(width - from));
+    else
+    {
+        for (int x = from; x < width; x++)
+            dst[x] = src[(size_t)x * pixelStride];
+    }
+}
+
+static void grayScalar(const uint8_t *src, int pixelStride, bool bgr, int width, uint8_t *dst)
+{
+    grayRowScalar(src, pixelStride, bgr, width, dst, 0);
+}
+
+static void hblurRowScalar(const uint8_t *g, int width, uint16_t *dst, int from)
+{
+    for (int x = from; x < width; x++)
+        dst[x] = (uint16_t)(g[x] + 4 * (g[x + 1] + g[x + 3]) + 6 * g[x + 2] + g[x + 4]);
+}
+
+static void hblurScalar(const uint8_t *g, int width, uint16_t *dst)
+{
+    hblurRowScalar(g, width, dst, 0);
+}
+
+static void vblurRowScalar(const uint16_t *r0, const uint16_t *r1, const uint16_t *r2, const uint16_t *r3, const uint16_t *r4,
+                           int width, int threshVal, uint8_t *dst, int from)
+{
+    for (int x = from; x < width; x++)
+    {
+        // v is 256x the blurred value (max 65280), (v + 128) >> 8 rounds like OpenCV
+        uint32_t v = (uint32_t)r0[x] + 4u * (r1[x] + r3[x]) + 6u * r2[x] + r4[x];
+        dst[x] = (int)((v + 128) >> 8) > threshVal ? 255 : 0;
+    }
+}
+
+static void vblurScalar(const uint16_t *r0, const uint16_t *r1, const uint16_t *r2, const uint16_t *r3, const uint16_t *r4,
+                        int width, int threshVal, uint8_t *dst)
+{
+    vblurRowScalar(r0, r1, r2, r3, r4, width, threshVal, dst, 0);
+}
+
+static const RowKernels SCALAR_KERNELS = {"scalar", grayScalar, hblurScalar, vblurScalar};
+
+// ---------- AVX2 (x86, picked at runtime) ---------- //
+#ifdef THRESHOLD_HAVE_AVX2
+// 4 BGR pixels → 4 int32 gray : pshufb lines up (b, g) and (r, 1) as int16 pairs, pmaddwd does the weighted sum + rounding
+__attribute__((target("avx2"))) static inline __m128i grayFourAvx2(const uint8_t *p)
+{
+    const __m128i bgMask = _mm_setr_epi8(0, -1, 1, -1, 3, -1, 4, -1, 6, -1, 7, -1, 9, -1, 10, -1);
+    const __m128i rMask = _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+    const __m128i bgWeights = _mm_set1_epi32((GRAY_G << 16) | GRAY_B);
+    const __m128i rWeights = _mm_set1_epi32(((1 << (GRAY_SHIFT - 1)) << 16) | GRAY_R);
+
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    __m128i bg = _mm_shuffle_epi8(v, bgMask);
+    __m128i r1 = _mm_or_si128(_mm_shuffle_epi8(v, rMask), _mm_set1_epi32(1 << 16));
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(bg, bgWeights), _mm_madd_epi16(r1, rWeights));
+    return _mm_srli_epi32(sum, GRAY_SHIFT);
+}
+
+__attribute__((target("avx2"))) static void grayAvx2(const uint8_t *src, int pixelStride, bool bgr, int width, uint8_t *dst)
+{
+    int x = 0;
+    if (bgr)
+    {
+        // 8 pixels at a time, each 16 byte load only uses 12 so stop while the over-read is still inside the row
+        for (; x * 3 + 28 <= width * 3; x += 8)
+        {
+            const uint8_t *p = src + (size_t)x * 3;
+            __m128i g16 = _mm_packs_epi32(grayFourAvx2(p), grayFourAvx2(p + 12));
+            _mm_storel_epi64((__m128i *)(dst + x), _mm_packus_epi16(g16, g16));
+        }
+    }
+    else if (pixelStride == 2)
+    {
+        // YUYV : keep the low byte of every 16-bit pair, 32 pixels at a time
+        const __m256i lowByte = _mm256_set1_epi16(0x00FF);
+        for (; x + 32 <= width; x += 32)
+        {
+            const uint8_t *p = src + (size_t)x * 2;
+            __m256i a = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)p), lowByte);
+            __m256i b = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(p + 32)), lowByte);
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8); // packus works per 128-bit lane
+            _mm256_storeu_si256((__m256i *)(dst + x), packed);
+        }
+    }
+    grayRowScalar(src, pixelStride, bgr, width, dst, x);
+}
+
+__attribute__((target("avx2"))) static void hblurAvx2(const uint8_t *g, int width, uint16_t *dst)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m256i a0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(g + x)));
+        __m256i a1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(g + x + 1)));
+        __m256i a2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(g + x + 2)));
+        __m256i a3 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(g + x + 3)));
+        __m256i a4 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(g + x + 4)));
+
+        __m256i outer = _mm256_add_epi16(a0, a4);
+        __m256i inner = _mm256_slli_epi16(_mm256_add_epi16(a1, a3), 2);
+        __m256i centre = _mm256_add_epi16(_mm256_slli_epi16(a2, 2), _mm256_slli_epi16(a2, 1));
+        _mm256_storeu_si256((__m256i *)(dst + x), _mm256_add_epi16(_mm256_add_epi16(outer, inner), centre));
+    }
+    hblurRowScalar(g, width, dst, x);
+}
+
+// 16 pixels of the vertical pass → 0xFFFF where blurred > threshVal
+// Every term fits in 16 bits (max 65280 + 128), the compare is signed but blurred is 0..255 and threshVal 0..254
+__attribute__((target("avx2"))) static inline __m256i vblurMaskAvx2(const uint16_t *r0, const uint16_t *r1, const uint16_t *r2,
+                                                                    const uint16_t *r3, const uint16_t *r4, __m256i thresh)
+{
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)r0);
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)r1);
+    __m256i v2 = _mm256_loadu_si256((const __m256i *)r2);
+    __m256i v3 = _mm256_loadu_si256((const __m256i *)r3);
+    __m256i v4 = _mm256_loadu_si256((const __m256i *)r4);
+
+    __m256i outer = _mm256_add_epi16(v0, v4);
+    __m256i inner = _mm256_slli_epi16(_mm256_add_epi16(v1, v3), 2);
+    __m256i centre = _mm256_add_epi16(_mm256_slli_epi16(v2, 2), _mm256_slli_epi16(v2, 1));
+    __m256i v = _mm256_add_epi16(_mm256_add_epi16(outer, inner), _mm256_add_epi16(centre, _mm256_set1_epi16(128)));
+    return _mm256_cmpgt_epi16(_mm256_srli_epi16(v, 8), thresh);
+}
+
+__attribute__((target("avx2"))) static void vblurAvx2(const uint16_t *r0, const uint16_t *r1, const uint16_t *r2, const uint16_t *r3, const uint16_t *r4,
+                                                      int width, int threshVal, uint8_t *dst)
+{
+    const __m256i thresh = _mm256_set1_epi16((short)threshVal);
+    int x = 0;
+    for (; x + 32 <= width; x += 32)
+    {
+        __m256i lo = vblurMaskAvx2(r0 + x, r1 + x, r2 + x, r3 + x, r4 + x, thresh);
+        __m256i hi = vblurMaskAvx2(r0 + x + 16, r1 + x + 16, r2 + x + 16, r3 + x + 16, r4 + x + 16, thresh);
+        __m256i mask = _mm256_packs_epi16(lo, hi); // -1 stays -1 = 255
+        _mm256_storeu_si256((__m256i *)(dst + x), _mm256_permute4x64_epi64(mask, 0xD8));
+    }
+    vblurRowScalar(r0, r1, r2, r3, r4, width, threshVal, dst, x);
+}
+
+static const RowKernels AVX2_KERNELS = {"avx2", grayAvx2, hblurAvx2, vblurAvx2};
+#endif
+
+// ---------- NEON (ARM, always there on aarch64) ---------- //
+#ifdef THRESHOLD_HAVE_NEON
+static void grayNeon(const uint8_t *src, int pixelStride, bool bgr, int width, uint8_t *dst)
+{
+    int x = 0;
+    if (bgr)
+    {
+        // vld3 de-interleaves B, G, R for us, 16 pixels at a time
+        const uint32x4_t round = vdupq_n_u32(1 << (GRAY_SHIFT - 1));
+        auto half = [&](uint16x8_t b, uint16x8_t g, uint16x8_t r)
+        {
+            uint32x4_t lo = vmlal_n_u16(vmlal_n_u16(vmlal_n_u16(round, vget_low_u16(b), GRAY_B), vget_low_u16(g), GRAY_G), vget_low_u16(r), GRAY_R);
+            uint32x4_t hi = vmlal_n_u16(vmlal_n_u16(vmlal_n_u16(round, vget_high_u16(b), GRAY_B), vget_high_u16(g), GRAY_G), vget_high_u16(r), GRAY_R);
+            return vcombine_u16(vshrn_n_u32(lo, GRAY_SHIFT), vshrn_n_u32(hi, GRAY_SHIFT));
+        };
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16x3_t bgrPx = vld3q_u8(src + (size_t)x * 3);
+            uint16x8_t lo = half(vmovl_u8(vget_low_u8(bgrPx.val[0])), vmovl_u8(vget_low_u8(bgrPx.val[1])), vmovl_u8(vget_low_u8(bgrPx.val[2])));
+            uint16x8_t hi = half(vmovl_u8(vget_high_u8(bgrPx.val[0])), vmovl_u8(vget_high_u8(bgrPx.val[1])), vmovl_u8(vget_high_u8(bgrPx.val[2])));
+            vst1q_u8(dst + x, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+        }
+    }
+    else if (pixelStride == 2)
+    {
+        for (; x + 16 <= width; x += 16)
+            vst1q_u8(dst + x, vld2q_u8(src + (size_t)x * 2).val[0]);
+    }
+    grayRowScalar(src, pixelStride, bgr, width, dst, x);
+}
+
+static void hblurNeon(const uint8_t *g, int width, uint16_t *dst)
+{
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        uint16x8_t a0 = vmovl_u8(vld1_u8(g + x));
+        uint16x8_t a1 = vmovl_u8(vld1_u8(g + x + 1));
+        uint16x8_t a2 = vmovl_u8(vld1_u8(g + x + 2));
+        uint16x8_t a3 = vmovl_u8(vld1_u8(g + x + 3));
+        uint16x8_t a4 = vmovl_u8(vld1_u8(g + x + 4));
+
+        uint16x8_t sum = vaddq_u16(a0, a4);
+        sum = vmlaq_n_u16(sum, vaddq_u16(a1, a3), 4);
+        sum = vmlaq_n_u16(sum, a2, 6);
+        vst1q_u16(dst + x, sum);
+    }
+    hblurRowScalar(g, width, dst, x);
+}
+
+static void vblurNeon(const uint16_t *r0, const uint16_t *r1, const uint16_t *r2, const uint16_t *r3, const uint16_t *r4,
+                      int width, int threshVal, uint8_t *dst)
+{
+    // Unsigned compare, threshVal == -1 never gets here (blurThreshold() fills the mask directly)
+    const uint16x8_t thresh = vdupq_n_u16((uint16_t)threshVal);
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        uint16x8_t v = vaddq_u16(vld1q_u16(r0 + x), vld1q_u16(r4 + x));
+        v = vmlaq_n_u16(v, vaddq_u16(vld1q_u16(r1 + x), vld1q_u16(r3 + x)), 4);
+        v = vmlaq_n_u16(v, vld1q_u16(r2 + x), 6);
+        uint16x8_t blurred = vrshrq_n_u16(v, 8); // (v + 128) >> 8
+        vst1_u8(dst + x, vmovn_u16(vcgtq_u16(blurred, thresh)));
+    }
+    vblurRowScalar(r0, r1, r2, r3, r4, width, threshVal, dst, x);
+}
+
+static const RowKernels NEON_KERNELS = {"neon", grayNeon, hblurNeon, vblurNeon};
+#endif
+
+// ---------- Dispatch ---------- //
+static bool allowSimd = true;
+
+static const RowKernels &pickKernels()
+{
+    if (!allowSimd)
+        return SCALAR_KERNELS;
+#ifdef THRESHOLD_HAVE_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2)
+        return AVX2_KERNELS;
+#endif
+#ifdef THRESHOLD_HAVE_NEON
+    return NEON_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+void setBlurThresholdSimd(bool enabled)
+{
+    allowSimd = enabled;
+}
+
+const char *blurThresholdBackend()
+{
+    return pickKernels().name;
+}
+
+void lumaRow(const LumaView &src, int y, uint8_t *dst)
+{
+    pickKernels().gray(src.data + (size_t)y * src.rowStride, src.pixelStride, src.bgr, src.width, dst);
+}
+
+// ----------------- Blur + Threshold ----------------- //
+// Below that many rows per strip the 4 halo rows and the wake up cost more than the extra thread saves
+static const int MIN_STRIP_ROWS = 32;
+
+static inline uint8_t grayAt(const uint8_t *row, const LumaView &src, int x)
+{
+    return src.bgr ? grayFromBGR(row + (size_t)x * 3) : row[(size_t)x * src.pixelStride];
+}
+
+// 4 interleaved sub-histograms so back to back equal values don't wait on each other's increment
+static void countGray(const uint8_t *g, int width, LumaHistogram &histogram)
+{
+    uint32_t sub[4][256] = {};
+    int x = 0;
+    for (; x + 4 <= width; x += 4)
+    {
+        sub[0][g[x]]++;
+        sub[1][g[x + 1]]++;
+        sub[2][g[x + 2]]++;
+        sub[3][g[x + 3]]++;
+    }
+    for (; x < width; x++)
+        sub[0][g[x]]++;
+    for (int i = 0; i < 256; i++)
+        histogram[i] += sub[0][i] + sub[1][i] + sub[2][i] + sub[3][i];
+}
+
+// One strip of rows, r already clipped to the image
+static void blurThresholdRows(const LumaView &src, int threshVal, const cv::Rect &r, uint8_t *dst, size_t dstStride,
+                              LumaHistogram *histogram)
+{
+    const int w = src.width;
+    const int h = src.height;
+    const RowKernels &k = pickKernels();
+    const int rw = r.width;
+
+    // cv::threshold semantics at the ends : blurred is 0..255 so these are all or nothing
+    if (threshVal < 0 || threshVal >= 255)
+    {
+        for (int y = 0; y < r.height; y++)
+            std::memset(dst + (size_t)y * dstStride, threshVal < 0 ? 255 : 0, (size_t)r.width);
+
+        // Nothing to blur but the histogram still has to see the frame (an auto threshold would never come back)
+        if (histogram)
+        {
+            static thread_local std::vector<uint8_t> span;
+            span.resize((size_t)rw);
+            for (int y = r.y; y < r.y + r.height; y++)
+            {
+                k.gray(src.data + (size_t)y * src.rowStride + (size_t)r.x * src.pixelStride, src.pixelStride, src.bgr, rw, span.data());
+                countGray(span.data(), rw, *histogram);
+            }
+        }
+        return;
+    }
+
+    // Gray row with 2 pixels each side (+ slack so 16 byte loads never leave the buffer),
+    // and the rolling buffer of 5 horizontally blurred rows, slot = row index mod 5
+    static thread_local std::vector<uint8_t> grayRow;
+    static thread_local std::vector<uint16_t> rows;
+    grayRow.resize((size_t)rw + 4 + 32);
+    rows.resize((size_t)rw * 5);
+
+    auto slot = [&](int y)
+    { return rows.data() + (size_t)(((y % 5) + 5) % 5) * rw; };
+
+    // The 2 pixel halo around the ROI comes from the real neighbours, only the image border is reflected,
+    // so the ROI mask is exactly the full frame mask cropped
+    const int haloFrom = r.x - 2, haloTo = r.x + rw + 2;
+    const int from = std::max(haloFrom, 0), to = std::min(haloTo, w);
+
+    auto loadRow = [&](int y)
+    {
+        const uint8_t *row = src.data + (size_t)reflect101(y, h) * src.rowStride;
+        uint8_t *g = grayRow.data(); // g[x - haloFrom] = gray of column x
+
+        k.gray(row + (size_t)from * src.pixelStride, src.pixelStride, src.bgr, to - from, g + (from - haloFrom));
+        for (int x = haloFrom; x < from; x++)
+            g[x - haloFrom] = grayAt(row, src, reflect101(x, w));
+        for (int x = to; x < haloTo; x++)
+            g[x - haloFrom] = grayAt(row, src, reflect101(x, w));
+
+        // Histogram rides along on the gray row, halo rows / columns are left out so every pixel counts once
+        if (histogram && y >= r.y && y < r.y + r.height)
+            countGray(g + 2, rw, *histogram);
+
+        k.hblur(grayRow.data(), rw, slot(y));
+    };
+
+    // First iteration loads rows y0 - 2 .. y0 + 2, after that one new row per output row
+    int loaded = r.y - 3;
+    for (int y = r.y; y < r.y + r.height; y++)
+    {
+        while (loaded < y + 2)
+            loadRow(++loaded);
+
+        k.vblur(slot(y - 2), slot(y - 1), slot(y), slot(y + 1), slot(y + 2), rw, threshVal, dst + (size_t)(y - r.y) * dstStride);
+    }
+}
+
+void blurThreshold(const LumaView &src, int threshVal, const cv::Rect &roi, uint8_t *dst, size_t dstStride,
+                   LumaHistogram *histogram)
+{
+    const cv::Rect r = roi & cv::Rect(0, 0, src.width, src.height);
+    if (r.width <= 0 || r.height <= 0)
+        return;
+
+    // Strips of rows over the shared pool, each one blurs the 2 rows above / below it again (halo)
+    // Histograms are counted per strip and added up at the end, so no two threads touch the same bins
+    ThreadPool &pool = ThreadPool::shared();
+    const int strips = pool.stripCount(r.height, MIN_STRIP_ROWS);
+    if (strips == 1)
+    {
+        blurThresholdRows(src, threshVal, r, dst, dstStride, histogram);
+        return;
+    }
+
+    // Named through a pointer : inside the strips thread_local would be each worker's own vector
+    static thread_local std::vector<LumaHistogram> partialStorage;
+    if (histogram && partialStorage.size() < (size_t)strips)
+        partialStorage.resize((size_t)strips);
+    LumaHistogram *partial = partialStorage.data();
+
+    pool.strips(r.height, 2, MIN_STRIP_ROWS, [&](const Strip &s)
+                {
+        LumaHistogram *part = nullptr;
+        if (histogram)
+        {
+            part = &partial[s.index];
+            part->fill(0);
+        }
+        const cv::Rect rows(r.x, r.y + s.y0, r.width, s.y1 - s.y0);
+        blurThresholdRows(src, threshVal, rows, dst + (size_t)s.y0 * dstStride, dstStride, part); });
+
+    if (histogram)
+    {
+        for (int i = 0; i < strips; i++)
+            for (int v = 0; v < 256; v++)
+                (*histogram)[v] += partial[i][v];
+    }
+}
+
+void blurThreshold(const LumaView &src, int threshVal, uint8_t *dst, size_t dstStride)
+{
+    blurThreshold(src, threshVal, cv::Rect(0, 0, src.width, src.height), dst, dstStride);
+}
+
+void blurThreshold(const LumaView &src, int threshVal, cv::Mat &mask)
+{
+    mask.create(src.height, src.width, CV_8UC1);
+    blurThreshold(src, threshVal, mask.data, mask.step);
+}
+
+void blurThreshold(const LumaView &src, int threshVal, const cv::Rect &roi, cv::Mat &mask, LumaHistogram *histogram)
+{
+    mask.create(src.height, src.width, CV_8UC1);
+    const cv::Rect r = roi & cv::Rect(0, 0, src.width, src.height);
+    if (r.width <= 0 || r.height <= 0)
+        return;
+    blurThreshold(src, threshVal, r, mask.ptr<uint8_t>(r.y) + r.x, mask.step, histogram);
+}
+
+// ----------------- Downscale ----------------- //
+void lumaHistogram(const LumaView &src, int step, LumaHistogram &histogram)
+{
+    CV_Assert(step >= 1);
+
+    static thread_local std::vector<uint8_t> samples;
+    samples.resize((size_t)(src.width + step - 1) / step);
+    for (int y = 0; y < src.height; y += step)
+    {
+        const uint8_t *row = src.data + (size_t)y * src.rowStride;
+        int n = 0;
+        for (int x = 0; x < src.width; x += step)
+            samples[n++] = grayAt(row, src, x);
+        countGray(samples.data(), n, histogram);
+    }
+}
+
+void downscaleLuma(const LumaView &src, int factor, cv::Mat &dst)
+{
+    CV_Assert(factor >= 1);
+
+    const int dw = src.width / factor;
+    const int dh = src.height / factor;
+    dst.create(dh, dw, CV_8UC1);
+    if (dw == 0 || dh == 0)
+        return;
+
+    const RowKernels &k = pickKernels();
+    const int used = dw * factor; // Leftover columns / rows past the last full block are dropped
+    const uint32_t count = (uint32_t)(factor * factor);
+
+    static thread_local std::vector<uint8_t> grayRow;
+    static thread_local std::vector<uint32_t> sums;
+    grayRow.resize((size_t)used + 32);
+    sums.resize((size_t)dw);
+
+    for (int y = 0; y < dh; y++)
+    {
+        std::fill(sums.begin(), sums.end(), 0u);
+        for (int j = 0; j < factor; j++)
+        {
+            k.gray(src.data + (size_t)(y * factor + j) * src.rowStride, src.pixelStride, src.bgr, used, grayRow.data());
+            const uint8_t *g = grayRow.data();
+            for (int x = 0; x < dw; x++, g += factor)
+                for (int i = 0; i < factor; i++)
+                    sums[x] += g[i];
+        }
+
+        uint8_t *out = dst.ptr<uint8_t>(y);
+        for (int x = 0; x < dw; x++)
+            out[x] = (uint8_t)((sums[x] + count / 2) / count);
+    }
+}
+
+int lumaThresholdFromGray(int threshVal)
+{
+    // gray > T  <=>  Y > 16 + 219 * T / 255
+    return 16 + (219 * threshVal) / 255;
+}
+
+int grayThresholdFromLuma(int lumaThresh)
+{
+    int threshVal = (int)std::lround((lumaThresh - 16) * 255.0 / 219.0);
+    return std::min(std::max(threshVal, 0), 255);
+}
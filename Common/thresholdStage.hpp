@@ -0,0 +1,78 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "v4l2Capture.hpp"
+
+// ----------------- LumaView ----------------- //
+// Strided 8-bit luminance plane, pixel (x, y) lives at data[y * rowStride + x * pixelStride]
+//  - Gray cv::Mat  : pixelStride = 1
+//  - YUYV buffer   : pixelStride = 2 (Y0 U Y1 V ...), so the Y bytes are read in place with no conversion pass
+//  - BGR cv::Mat   : pixelStride = 3 + bgr, gray is computed on the fly exactly like cv::COLOR_BGR2GRAY
+struct LumaView
+{
+    const uint8_t *data = nullptr;
+    int width = 0;
+    int height = 0;
+    size_t rowStride = 0;
+    int pixelStride = 1;
+    bool bgr = false;
+};
+
+LumaView lumaFromYUYV(const uint8_t *data, int width, int height, size_t stride);
+LumaView lumaFromYUYV(const FrameView &view);
+LumaView lumaFromGray(const cv::Mat &gray);
+LumaView lumaFromBGR(const cv::Mat &bgr);
+
+// 256 bin histogram of the gray values a stage converted
+using LumaHistogram = std::array<uint32_t, 256>;
+
+// Gray of row y (src.width bytes) with the same SIMD kernels the stages below use
+void lumaRow(const LumaView &src, int y, uint8_t *dst);
+
+// ----------------- Blur + Threshold ----------------- //
+// Same result as
+//      cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);   (only for lumaFromBGR views)
+//      cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
+//      cv::threshold(blurred, mask, threshVal, 255, cv::THRESH_BINARY);
+// but in one pass with a 5 row rolling buffer and no intermediate images
+//  - 5x5 Gaussian with sigma 0 is the separable [1 4 6 4 1] / 16 kernel, borders are BORDER_REFLECT_101
+//  - Integer math with the same rounding OpenCV uses for 8-bit images, so the mask matches bit for bit
+//  - Rows go through AVX2 (x86, checked at runtime) or NEON (ARM) kernels, scalar otherwise, all give the same mask
+void blurThreshold(const LumaView &src, int threshVal, uint8_t *dst, size_t dstStride);
+void blurThreshold(const LumaView &src, int threshVal, cv::Mat &mask);
+
+// Only the pixels inside roi (clipped to the image)
+//  - The blur reads the real pixels around the ROI, so the result is the full frame mask cropped to roi, bit for bit
+//  - dst points at the ROI's top left pixel, roi.height rows of roi.width are written
+//  - cv::Mat version : mask is (re)created at full size, only mask(roi) is written, the rest keeps whatever it had
+//  - histogram != null : the gray of every pixel in roi is added to it on the way (no extra read of the frame)
+void blurThreshold(const LumaView &src, int threshVal, const cv::Rect &roi, uint8_t *dst, size_t dstStride,
+                   LumaHistogram *histogram = nullptr);
+void blurThreshold(const LumaView &src, int threshVal, const cv::Rect &roi, cv::Mat &mask, LumaHistogram *histogram = nullptr);
+
+// ----------------- Histogram ----------------- //
+// Gray of every step-th pixel of every step-th row of the whole frame added to histogram
+// (step 4 on 640x480 = 19200 pixels read, the same spread of levels as the full frame for picking a threshold)
+void lumaHistogram(const LumaView &src, int step, LumaHistogram &histogram);
+
+// ----------------- Downscale ----------------- //
+// Gray image of (width / factor) x (height / factor), every pixel is the rounded mean of a factor x factor block
+// (cv::resize INTER_AREA for an integer factor), gray computed on the way like blurThreshold does
+void downscaleLuma(const LumaView &src, int factor, cv::Mat &dst);
+
+// "avx2", "neon" or "scalar"
+const char *blurThresholdBackend();
+
+// false = always use the scalar kernels (benchmarks, checking the SIMD ones against them)
+void setBlurThresholdSimd(bool enabled);
+
+// threshVal in our YAML profiles / CSVs was tuned on BGR2GRAY of the decoded frame
+//  - OpenCV decodes YUYV as limited range (BT.601), which makes gray ~= (Y - 16) * 255 / 219
+//  - Use this to get the equivalent cut-off on raw Y bytes so old profiles keep working
+int lumaThresholdFromGray(int threshVal);
+// The other way round, for a threshold picked on raw Y (auto threshold) that has to go back in the CSV / trackbar
+int grayThresholdFromLuma(int lumaThresh);
@@ -0,0 +1,435 @@
+#include "v4l2Capture.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// ----------------- FrameView ----------------- //
+FrameView::~FrameView()
+{
+    release();
+}
+
+FrameView::FrameView(FrameView &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+FrameView &FrameView::operator=(FrameView &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+
+        data = other.data;
+        bytesUsed = other.bytesUsed;
+        width = other.width;
+        height = other.height;
+        stride = other.stride;
+        pixelFormat = other.pixelFormat;
+        sequence = other.sequence;
+        timestampNs = other.timestampNs;
+        owner_ = other.owner_;
+        index_ = other.index_;
+
+        other.data = nullptr;
+        other.owner_ = nullptr;
+        other.index_ = -1;
+    }
+    return *this;
+}
+
+void FrameView::release()
+{
+    if (owner_ && index_ >= 0)
+        owner_->requeue(index_);
+
+    data = nullptr;
+    bytesUsed = 0;
+    owner_ = nullptr;
+    index_ = -1;
+}
+
+// ----------------- V4L2Capture ----------------- //
+V4L2Capture::~V4L2Capture()
+{
+    close();
+}
+
+bool V4L2Capture::xioctl(unsigned long request, void *arg, const char *name) const
+{
+    int result;
+    do
+    {
+        result = ioctl(fd_, request, arg);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1)
+    {
+        if (errno != EAGAIN)
+            std::cerr << "❌ " << name << " failed on " << device_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool V4L2Capture::open(const std::string &device, int width, int height, uint32_t pixelFormat, int bufferCount)
+{
+    close();
+    device_ = device;
+
+    // Non-blocking so grab() can wait with poll() and a timeout instead of hanging in DQBUF
+    fd_ = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd_ < 0)
+    {
+        std::cerr << "❌ Could not open " << device << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    v4l2_capability cap{};
+    if (!xioctl(VIDIOC_QUERYCAP, &cap, "VIDIOC_QUERYCAP"))
+    {
+        close();
+        return false;
+    }
+    if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(cap.capabilities & V4L2_CAP_STREAMING))
+    {
+        std::cerr << "❌ " << device << " does not support streaming video capture" << std::endl;
+        close();
+        return false;
+    }
+
+    // Ask for the format, the driver is allowed to adjust it so read back what we actually got
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.pixelformat = pixelFormat;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (!xioctl(VIDIOC_S_FMT, &fmt, "VIDIOC_S_FMT"))
+    {
+        close();
+        return false;
+    }
+
+    width_ = fmt.fmt.pix.width;
+    height_ = fmt.fmt.pix.height;
+    stride_ = fmt.fmt.pix.bytesperline;
+    pixelFormat_ = fmt.fmt.pix.pixelformat;
+
+    if (pixelFormat_ != pixelFormat)
+        std::cerr << "⚠️ Driver picked " << fourccToString(pixelFormat_) << " instead of " << fourccToString(pixelFormat) << std::endl;
+    if (width_ != width || height_ != height)
+        std::cerr << "⚠️ Driver picked " << width_ << "x" << height_ << " instead of " << width << "x" << height << std::endl;
+
+    v4l2_requestbuffers req{};
+    req.count = bufferCount;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (!xioctl(VIDIOC_REQBUFS, &req, "VIDIOC_REQBUFS"))
+    {
+        close();
+        return false;
+    }
+    if (req.count < 1)
+    {
+        std::cerr << "❌ " << device << " gave us no buffers" << std::endl;
+        close();
+        return false;
+    }
+
+    buffers_.resize(req.count);
+    for (unsigned int i = 0; i < req.count; i++)
+    {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (!xioctl(VIDIOC_QUERYBUF, &buf, "VIDIOC_QUERYBUF"))
+        {
+            close();
+            return false;
+        }
+
+        void *start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+        if (start == MAP_FAILED)
+        {
+            std::cerr << "❌ mmap failed on " << device << ": " << std::strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        buffers_[i].start = start;
+        buffers_[i].length = buf.length;
+    }
+
+    return true;
+}
+
+bool V4L2Capture::setFrameInterval(uint32_t numerator, uint32_t denominator)
+{
+    if (fd_ < 0 || streaming_ || numerator == 0 || denominator == 0)
+        return false;
+
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = numerator;
+    parm.parm.capture.timeperframe.denominator = denominator;
+    if (!xioctl(VIDIOC_S_PARM, &parm, "VIDIOC_S_PARM"))
+        return false;
+
+    intervalNumerator_ = parm.parm.capture.timeperframe.numerator;
+    intervalDenominator_ = parm.parm.capture.timeperframe.denominator;
+    if ((uint64_t)intervalNumerator_ * denominator != (uint64_t)numerator * intervalDenominator_)
+        std::cerr << "⚠️ Driver picked " << intervalNumerator_ << "/" << intervalDenominator_ << " s per frame instead of "
+                  << numerator << "/" << denominator << std::endl;
+    return true;
+}
+
+bool V4L2Capture::start()
+{
+    if (fd_ < 0)
+        return false;
+    if (streaming_)
+        return true;
+
+    for (size_t i = 0; i < buffers_.size(); i++)
+    {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (!xioctl(VIDIOC_QBUF, &buf, "VIDIOC_QBUF"))
+            return false;
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (!xioctl(VIDIOC_STREAMON, &type, "VIDIOC_STREAMON"))
+        return false;
+
+    streaming_ = true;
+    return true;
+}
+
+void V4L2Capture::stop()
+{
+    if (fd_ < 0 || !streaming_)
+        return;
+
+    // STREAMOFF also pulls every buffer back from the driver, so outstanding views must not requeue afterwards
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    xioctl(VIDIOC_STREAMOFF, &type, "VIDIOC_STREAMOFF");
+    streaming_ = false;
+}
+
+void V4L2Capture::close()
+{
+    stop();
+
+    for (auto &buffer : buffers_)
+    {
+        if (buffer.start)
+            munmap(buffer.start, buffer.length);
+    }
+    buffers_.clear();
+
+    if (fd_ >= 0)
+    {
+        // Free the driver side buffers before closing
+        v4l2_requestbuffers req{};
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        ioctl(fd_, VIDIOC_REQBUFS, &req);
+
+        ::close(fd_);
+        fd_ = -1;
+    }
+    intervalNumerator_ = 0;
+    intervalDenominator_ = 0;
+}
+
+bool V4L2Capture::grab(FrameView &view, int timeoutMs)
+{
+    view.release();
+    if (!streaming_)
+        return false;
+
+    while (true)
+    {
+        pollfd pfd{};
+        pfd.fd = fd_;
+        pfd.events = POLLIN;
+
+        int ready = poll(&pfd, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+        {
+            std::cerr << "⚠️ Timed out waiting for a frame from " << device_ << std::endl;
+            return false;
+        }
+
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        if (!xioctl(VIDIOC_DQBUF, &buf, "VIDIOC_DQBUF"))
+        {
+            if (errno == EAGAIN)
+                continue;
+            return false;
+        }
+
+        // Corrupted transfer (USB hiccup), give it straight back and wait for the next one
+        if (buf.flags & V4L2_BUF_FLAG_ERROR)
+        {
+            requeue(buf.index);
+            continue;
+        }
+
+        view.data = static_cast<const uint8_t *>(buffers_[buf.index].start);
+        view.bytesUsed = buf.bytesused;
+        view.width = width_;
+        view.height = height_;
+        view.stride = stride_;
+        view.pixelFormat = pixelFormat_;
+        view.sequence = buf.sequence;
+        view.timestampNs = (int64_t)buf.timestamp.tv_sec * 1000000000LL + (int64_t)buf.timestamp.tv_usec * 1000LL;
+        view.owner_ = this;
+        view.index_ = buf.index;
+        return true;
+    }
+}
+
+void V4L2Capture::requeue(int index)
+{
+    if (!streaming_)
+        return;
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    xioctl(VIDIOC_QBUF, &buf, "VIDIOC_QBUF");
+}
+
+int V4L2Capture::exportBuffer(int index) const
+{
+    if (fd_ < 0 || index < 0 || index >= (int)buffers_.size())
+        return -1;
+
+    v4l2_exportbuffer expbuf{};
+    expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    expbuf.index = index;
+    expbuf.flags = O_RDONLY | O_CLOEXEC;
+    if (!xioctl(VIDIOC_EXPBUF, &expbuf, "VIDIOC_EXPBUF"))
+        return -1;
+
+    return expbuf.fd;
+}
+
+std::string fourccToString(uint32_t fourcc)
+{
+    std::string text(4, ' ');
+    for (int i = 0; i < 4; i++)
+        text[i] = (char)((fourcc >> (8 * i)) & 0xFF);
+    return text;
+}
+
+// ----------------- Mode enumeration ----------------- //
+static int ioctlRetry(int fd, unsigned long request, void *arg)
+{
+    int result;
+    do
+    {
+        result = ioctl(fd, request, arg);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
+
+static void addIntervals(int fd, CaptureMode mode, std::vector<CaptureMode> &modes)
+{
+    v4l2_frmivalenum ival{};
+    ival.pixel_format = mode.pixelFormat;
+    ival.width = mode.width;
+    ival.height = mode.height;
+
+    bool any = false;
+    for (ival.index = 0; ioctlRetry(fd, VIDIOC_ENUM_FRAMEINTERVALS, &ival) == 0; ival.index++)
+    {
+        if (ival.type == V4L2_FRMIVAL_TYPE_DISCRETE)
+        {
+            mode.intervalNumerator = ival.discrete.numerator;
+            mode.intervalDenominator = ival.discrete.denominator;
+            modes.push_back(mode);
+        }
+        else
+        {
+            // Continuous / stepwise : fastest and slowest end of the range
+            mode.intervalNumerator = ival.stepwise.min.numerator;
+            mode.intervalDenominator = ival.stepwise.min.denominator;
+            modes.push_back(mode);
+            mode.intervalNumerator = ival.stepwise.max.numerator;
+            mode.intervalDenominator = ival.stepwise.max.denominator;
+            modes.push_back(mode);
+            any = true;
+            break;
+        }
+        any = true;
+    }
+
+    if (!any)
+        modes.push_back(mode); // No interval list, stream at whatever the driver defaults to
+}
+
+std::vector<CaptureMode> enumerateModes(const std::string &device)
+{
+    std::vector<CaptureMode> modes;
+
+    int fd = ::open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd < 0)
+    {
+        std::cerr << "❌ Could not open " << device << ": " << std::strerror(errno) << std::endl;
+        return modes;
+    }
+
+    v4l2_fmtdesc fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    for (fmt.index = 0; ioctlRetry(fd, VIDIOC_ENUM_FMT, &fmt) == 0; fmt.index++)
+    {
+        CaptureMode mode;
+        mode.pixelFormat = fmt.pixelformat;
+        mode.description = (const char *)fmt.description;
+        mode.compressed = (fmt.flags & V4L2_FMT_FLAG_COMPRESSED) != 0;
+
+        v4l2_frmsizeenum size{};
+        size.pixel_format = fmt.pixelformat;
+        for (size.index = 0; ioctlRetry(fd, VIDIOC_ENUM_FRAMESIZES, &size) == 0; size.index++)
+        {
+            if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE)
+            {
+                mode.width = size.discrete.width;
+                mode.height = size.discrete.height;
+                addIntervals(fd, mode, modes);
+            }
+            else
+            {
+                mode.width = size.stepwise.min_width;
+                mode.height = size.stepwise.min_height;
+                addIntervals(fd, mode, modes);
+                mode.width = size.stepwise.max_width;
+                mode.height = size.stepwise.max_height;
+                addIntervals(fd, mode, modes);
+                break;
+            }
+        }
+    }
+
+    ::close(fd);
+    return modes;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <linux/videodev2.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class V4L2Capture;
+
+// ----------------- FrameView ----------------- //
+// Zero-copy view of one dequeued driver buffer
+//  - data points straight into the mmap'd buffer, nothing is copied
+//  - The buffer goes back to the driver (VIDIOC_QBUF) when the view is released or destroyed
+//  - Move-only so a buffer can never be queued twice
+class FrameView
+{
+public:
+    FrameView() = default;
+    ~FrameView();
+
+    FrameView(FrameView &&other) noexcept;
+    FrameView &operator=(FrameView &&other) noexcept;
+    FrameView(const FrameView &) = delete;
+    FrameView &operator=(const FrameView &) = delete;
+
+    // Hand the buffer back to the driver early (safe to call more than once)
+    void release();
+    bool empty() const { return data == nullptr; }
+
+    const uint8_t *data = nullptr;
+    size_t bytesUsed = 0;
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;        // Bytes per row
+    uint32_t pixelFormat = 0; // V4L2_PIX_FMT_*
+    uint32_t sequence = 0;    // Driver frame counter, gaps mean the driver dropped frames
+    int64_t timestampNs = 0;  // Buffer timestamp (CLOCK_MONOTONIC)
+
+private:
+    friend class V4L2Capture;
+    V4L2Capture *owner_ = nullptr;
+    int index_ = -1;
+};
+
+// ----------------- V4L2Capture ----------------- //
+// Talks to /dev/videoN directly with VIDIOC_REQBUFS/QBUF/DQBUF and mmap'd buffers
+//  - bufferCount bounds the driver queue, 2 keeps capture latency to about one frame
+//  - Every function returns false (and prints why) instead of throwing
+class V4L2Capture
+{
+public:
+    V4L2Capture() = default;
+    ~V4L2Capture();
+
+    V4L2Capture(const V4L2Capture &) = delete;
+    V4L2Capture &operator=(const V4L2Capture &) = delete;
+
+    bool open(const std::string &device, int width, int height,
+              uint32_t pixelFormat = V4L2_PIX_FMT_YUYV, int bufferCount = 2);
+    // Frame interval (1/30 = 30 fps), call after open() and before start(). The driver may round it, the one it picked is kept
+    bool setFrameInterval(uint32_t numerator, uint32_t denominator);
+    double fps() const { return intervalNumerator_ ? (double)intervalDenominator_ / intervalNumerator_ : 0.0; }
+
+    bool start();
+    void stop();
+    void close();
+
+    // Blocks (up to timeoutMs) until the driver hands over the next filled buffer
+    bool grab(FrameView &view, int timeoutMs = 1000);
+
+    // Export a buffer as a DMABUF file descriptor (VIDIOC_EXPBUF) for sharing with other devices, -1 on failure
+    int exportBuffer(int index) const;
+
+    bool isOpened() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t stride() const { return stride_; }
+    uint32_t pixelFormat() const { return pixelFormat_; }
+    int bufferCount() const { return (int)buffers_.size(); }
+
+private:
+    friend class FrameView;
+    void requeue(int index);
+    bool xioctl(unsigned long request, void *arg, const char *name) const;
+
+    struct Buffer
+    {
+        void *start = nullptr;
+        size_t length = 0;
+    };
+
+    int fd_ = -1;
+    std::string device_;
+    std::vector<Buffer> buffers_;
+    bool streaming_ = false;
+    int width_ = 0;
+    int height_ = 0;
+    size_t stride_ = 0;
+    uint32_t pixelFormat_ = 0;
+    uint32_t intervalNumerator_ = 0;
+    uint32_t intervalDenominator_ = 0;
+};
+
+// ----------------- Mode enumeration ----------------- //
+// One pixel format + frame size + frame interval the camera says it supports
+struct CaptureMode
+{
+    uint32_t pixelFormat = 0;
+    std::string description; // "YUYV 4:2:2", "Motion-JPEG", ...
+    bool compressed = false;
+    int width = 0;
+    int height = 0;
+    uint32_t intervalNumerator = 0; // 0 = driver didn't list any interval
+    uint32_t intervalDenominator = 0;
+
+    double fps() const { return intervalNumerator ? (double)intervalDenominator / intervalNumerator : 0.0; }
+};
+
+// VIDIOC_ENUM_FMT → ENUM_FRAMESIZES → ENUM_FRAMEINTERVALS. Stepwise / continuous ranges only give their min and max
+std::vector<CaptureMode> enumerateModes(const std::string &device);
+
+// "YUYV", "MJPG", ... for printing
+std::string fourccToString(uint32_t fourcc);
@@ -2,9 +2,16 @@
 #include <vector>
 #include <iostream>
 
+#include "fingerGeometry.hpp"
+
 using namespace cv;
 using namespace std;
 
+// Gaps between fingers = defects deeper than 10 px with a far point angle under 90°
+FingerExtractor fingerExtractor(90.0f);
+FingerGeometry fingers;
+FingerFeatureVector fingerFeatures;
+
 // Function to detect and draw hand contours and convexity defects
 void detectHandContours(Mat &frame)
 {
@@ -60,26 +67,28 @@ void detectHandContours(Mat &frame)
         { // Minimum size for convexity defects calculation
             convexityDefects(contours[largestContourIndex], hullIndices, defects);
 
-            int fingerCount = 0;
-            for (const Vec4i &defect : defects)
+            // Filter defects by depth and by the angle at the far point (only gaps between fingers), all at once
+            const Rect box = boundingRect(contours[largestContourIndex]);
+            fingerExtractor.extract(contours[largestContourIndex], defects, box, 10, fingers, fingerFeatures);
+
+            for (size_t i = 0; i < defects.size(); i++)
             {
-                Point start = contours[largestContourIndex][defect[0]];
-                Point end = contours[largestContourIndex][defect[1]];
-                Point far = contours[largestContourIndex][defect[2]];
-                float depth = defect[3] / 256.0; // Convert from fixed-point
-
-                // Filter defects by depth (only consider deep defects between fingers)
-                if (depth > 10)
-                {
-                    circle(frame, far, 5, Scalar(255, 0, 0), -1);  // Mark defect points
-                    line(frame, start, far, Scalar(255, 0, 0), 2); // Line from start to defect point
-                    line(frame, far, end, Scalar(255, 0, 0), 2);   // Line from defect point to end
-
-                    fingerCount++; // Counting fingers based on convexity defects
-                }
+                if (!fingerExtractor.kept(i))
+                    continue;
+
+                Point start = contours[largestContourIndex][defects[i][0]];
+                Point end = contours[largestContourIndex][defects[i][1]];
+                Point far = contours[largestContourIndex][defects[i][2]];
+                circle(frame, far, 5, Scalar(255, 0, 0), -1);  // Mark defect points
+                line(frame, start, far, Scalar(255, 0, 0), 2); // Line from start to defect point
+                line(frame, far, end, Scalar(255, 0, 0), 2);   // Line from defect point to end
             }
+            for (int i = 0; i < fingers.tipCount; i++)
+                circle(frame, fingers.tips[i], 8, Scalar(0, 255, 255), 2); // Fingertips
+            circle(frame, fingers.palmCentre, (int)fingers.palmRadius, Scalar(255, 0, 255), 1);
 
-            // Display finger count
+            // Display finger count (fingertips around the gaps, was one per deep defect)
+            int fingerCount = (int)fingerFeatures[FEATURE_FINGERS];
             putText(frame, "Fingers: " + to_string(fingerCount), Point(10, 30), FONT_HERSHEY_SIMPLEX, 1, Scalar(255, 255, 255), 2);
         }
     }
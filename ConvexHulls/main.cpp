@@ -2,6 +2,11 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <memory_resource>
+
+#include "contourHull.hpp"
+#include "frameArena.hpp"
+
 #define MAXTHRESH 255
 // These values work great if lamp is on
 int treshVal = 75; // With logitec camera
@@ -57,8 +62,15 @@ int main()
 
     cv::Mat frame, gray, blurred, thresh;
 
+    // Hull, hull indices and defects come out of the arena, reset every frame
+    // contours is findContours' output (a std::vector, OpenCV can't fill a pmr one), kept across frames so it's reused
+    FrameArena arena;
+    std::vector<std::vector<cv::Point>> contours;
+
     while (true)
     {
+        arena.reset();
+
         cap >> frame;
         if (frame.empty())
             break;
@@ -69,8 +81,6 @@ int main()
         cv::threshold(blurred, thresh, treshVal, MAXTHRESH, cv::THRESH_BINARY); // If pixel greater than thresVal, set it to 255, other than that set it to 0
 
         // Find contours
-        std::vector<std::vector<cv::Point>> contours;
-
         /*
             Notes about void cv::findContours(InputArray image, OutputArrayOfArrays contours, int mode, int method, cv::Point offset = cv::Point())
 
@@ -114,25 +124,21 @@ int main()
 
                 More learning resources about convex hulls ---> https://learnopencv.com/convex-hull-using-opencv-in-python-and-c/
             */
-            // Compute convex hull (for drawing)
-            std::vector<cv::Point> hull;
-            cv::convexHull(contours[largestContourIdx], hull);
+            // Compute convex hull : sorted indices (for finding defects) + the points in contour order (for drawing)
+            std::pmr::vector<int> hullIndices(arena.resource());
+            std::pmr::vector<cv::Point> hull(arena.resource());
+            contourHull(contours[largestContourIdx], hullIndices, &hull);
             int numHullPoints = hull.size(); // Store convex hull point count
 
             std::cout << "Convex Hull Points: " << numHullPoints << std::endl;
 
-            // Compute convex hull (for finding defects)
-            std::vector<int> hullIndices;
-            cv::convexHull(contours[largestContourIdx], hullIndices, false, false);
-            std::sort(hullIndices.begin(), hullIndices.end());
-
             // Compute convexity defects
             int numDefects = 0;
-            std::vector<cv::Vec4i> defects;
+            std::pmr::vector<cv::Vec4i> defects(arena.resource());
 
-            if (hullIndices.size() > 3) // Need at least 4 points to compute defects
+            // Need at least 4 points to compute defects, a self intersecting contour gives none
+            if (hullIndices.size() > 3 && hullDefects(contours[largestContourIdx], hullIndices, defects))
             {
-                cv::convexityDefects(contours[largestContourIdx], hullIndices, defects);
                 numDefects = defects.size(); // Store defect count
 
                 for (size_t i = 0; i < defects.size(); i++)
@@ -182,7 +188,9 @@ int main()
 
             // Draw contours and convex hull
             cv::drawContours(frame, contours, largestContourIdx, cv::Scalar(0, 255, 0), 2);
-            cv::polylines(frame, hull, true, cv::Scalar(255, 0, 0), 2);
+            const cv::Point *hullPoints = hull.data();
+            const int hullCount = (int)hull.size();
+            cv::polylines(frame, &hullPoints, &hullCount, 1, true, cv::Scalar(255, 0, 0), 2);
 
             // --------------- Write values to CSV file ---------------
             if (file.is_open())
@@ -206,6 +214,7 @@ int main()
 
     // Close the file properly after the loop
     file.close();
+    arena.printStats(std::cout);
 
     cap.release();
     cv::destroyAllWindows();
@@ -0,0 +1,151 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "threadPool.hpp"
+#include "thresholdStage.hpp"
+
+// ----------------- FusedThresholdBenchmark ----------------- //
+// OpenCV chain (cvtColor → GaussianBlur → threshold) vs blurThreshold() on the same frames
+//  - Checks the masks are identical before timing anything
+//  - Then times blurThreshold() over 1, 2, 4 .. threads of the pool (latency of one frame vs cores)
+//  - ./fusedThreshold [image] [iterations] [threshVal] [threads]
+//  - No image = synthetic 640x480 frame (gradients + noise so the mask isn't trivial)
+
+static const int WARMUP = 20;
+
+cv::Mat syntheticFrame()
+{
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::RNG rng(12345);
+    for (int y = 0; y < frame.rows; y++)
+    {
+        for (int x = 0; x < frame.cols; x++)
+        {
+            cv::Vec3b &px = frame.at<cv::Vec3b>(y, x);
+            px[0] = cv::saturate_cast<uchar>(x * 255 / frame.cols + rng.uniform(-30, 30));
+            px[1] = cv::saturate_cast<uchar>(y * 255 / frame.rows + rng.uniform(-30, 30));
+            px[2] = cv::saturate_cast<uchar>((x + y) % 256 + rng.uniform(-30, 30));
+        }
+    }
+    cv::circle(frame, cv::Point(320, 240), 120, cv::Scalar(40, 60, 200), cv::FILLED);
+    return frame;
+}
+
+template <typename Fn>
+double timeIt(int iterations, Fn fn)
+{
+    for (int i = 0; i < WARMUP; i++)
+        fn();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+bool sameMask(const cv::Mat &a, const cv::Mat &b, const std::string &what)
+{
+    cv::Mat diff;
+    cv::compare(a, b, diff, cv::CMP_NE);
+    int wrong = cv::countNonZero(diff);
+    if (wrong != 0)
+    {
+        std::cerr << "❌ " << what << " : " << wrong << " pixels differ from the OpenCV chain" << std::endl;
+        return false;
+    }
+    std::cout << "✅ " << what << " matches the OpenCV chain bit for bit" << std::endl;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    cv::Mat frame = argc > 1 ? cv::imread(argv[1], cv::IMREAD_COLOR) : syntheticFrame();
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 500;
+    int threshVal = argc > 3 ? std::stoi(argv[3]) : 60;
+    ThreadPool::configureShared(argc > 4 ? std::stoi(argv[4]) : 0);
+    ThreadPool &pool = ThreadPool::shared();
+
+    if (frame.empty())
+    {
+        std::cerr << "❌ Could not read " << argv[1] << std::endl;
+        return -1;
+    }
+
+    std::cout << "Frame " << frame.cols << "x" << frame.rows << ", threshVal " << threshVal << ", " << iterations
+              << " iterations, OpenCV threads " << cv::getNumThreads() << ", SIMD backend " << blurThresholdBackend() << ", pool threads " << pool.size() << "\n\n";
+
+    // ---------- Correctness ---------- //
+    cv::Mat gray, blurred, expected, fusedMask;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
+    cv::threshold(blurred, expected, threshVal, 255, cv::THRESH_BINARY);
+
+    bool ok = true;
+    for (bool simd : {false, true})
+    {
+        setBlurThresholdSimd(simd);
+        std::string backend = blurThresholdBackend();
+
+        blurThreshold(lumaFromBGR(frame), threshVal, fusedMask);
+        ok &= sameMask(expected, fusedMask, "BGR  input, " + backend);
+
+        blurThreshold(lumaFromGray(gray), threshVal, fusedMask);
+        ok &= sameMask(expected, fusedMask, "gray input, " + backend);
+    }
+    if (!ok)
+        return -1;
+
+    // ---------- Timing ---------- //
+    double opencvMs = timeIt(iterations, [&]
+                             {
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
+        cv::threshold(blurred, expected, threshVal, 255, cv::THRESH_BINARY); });
+
+    setBlurThresholdSimd(false);
+    double scalarMs = timeIt(iterations, [&]
+                             { blurThreshold(lumaFromBGR(frame), threshVal, fusedMask); });
+
+    setBlurThresholdSimd(true);
+    double simdMs = timeIt(iterations, [&]
+                           { blurThreshold(lumaFromBGR(frame), threshVal, fusedMask); });
+
+    std::printf("\n%-34s %10s %10s\n", "BGR → mask", "ms/frame", "speedup");
+    std::printf("%-34s %10.3f %10s\n", "cvtColor + GaussianBlur + threshold", opencvMs, "1.00x");
+    std::printf("%-34s %10.3f %9.2fx\n", "blurThreshold (scalar)", scalarMs, opencvMs / scalarMs);
+    std::printf("%-34s %10.3f %9.2fx\n", (std::string("blurThreshold (") + blurThresholdBackend() + ")").c_str(), simdMs, opencvMs / simdMs);
+
+    // ---------- Threads ---------- //
+    // Same frame split in more strips each time, the mask has to stay the same whatever the split
+    std::printf("\n%-34s %10s %10s\n", "blurThreshold over the pool", "ms/frame", "vs 1");
+    double oneThreadMs = 0;
+    cv::Mat diff;
+    for (int threads = 1;; threads = std::min(threads * 2, pool.size()))
+    {
+        pool.setThreadLimit(threads);
+        blurThreshold(lumaFromBGR(frame), threshVal, fusedMask);
+        cv::compare(fusedMask, expected, diff, cv::CMP_NE);
+        if (cv::countNonZero(diff) != 0)
+        {
+            std::cerr << "❌ " << threads << " threads : mask differs from the OpenCV chain" << std::endl;
+            ok = false;
+        }
+
+        double ms = timeIt(iterations, [&]
+                           { blurThreshold(lumaFromBGR(frame), threshVal, fusedMask); });
+        if (threads == 1)
+            oneThreadMs = ms;
+        std::printf("%-34s %10.3f %9.2fx\n", (std::to_string(threads) + " threads").c_str(), ms, oneThreadMs / ms);
+
+        if (threads == pool.size())
+            break;
+    }
+    pool.setThreadLimit(0);
+    pool.printStats(std::cout);
+
+    return ok ? 0 : -1;
+}
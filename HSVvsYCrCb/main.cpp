@@ -12,6 +12,8 @@
 #include <atomic>
 #include <iomanip>
 
+#include "skinLut.hpp"
+
 using namespace cv;
 using namespace std;
 using namespace std::chrono;
@@ -31,7 +33,7 @@ int main()
     usbCamera.set(cv::CAP_PROP_FRAME_WIDTH, 640);
     usbCamera.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
 
-    Mat frame, hsvImage, ycrcbImage;
+    Mat frame;
     Mat skinMaskHSVOutput, skinMaskYCrCbOutput;
     Mat combinedImage;
 
@@ -64,6 +66,11 @@ int main()
     Scalar ycrcbLower(0, 133, 77);
     Scalar ycrcbUpper(255, 173, 127);
 
+    // One BGR → skin lookup table per colour space, same masks as cvtColor + inRange without converting the frame
+    SkinLut hsvLut, ycrcbLut;
+    hsvLut.setHSV(hsvLower, hsvUpper);
+    ycrcbLut.setYCrCb(ycrcbLower, ycrcbUpper);
+
     // Get screen resolution
     int screen_width = 1920;
     int screen_height = 1080;
@@ -91,17 +98,11 @@ int main()
             break;
         }
 
-        // void cv::cvtColor(cv::InputArray src, cv::OutputArray dst, int code, int dstCn = 0)
-        // Convert to HSV and YCrCb color spaces
-        cvtColor(frame, hsvImage, COLOR_BGR2HSV);
-        cvtColor(frame, ycrcbImage, COLOR_BGR2YCrCb);
-
-        // void cv::inRange(cv::InputArray src, cv::InputArray lowerb, cv::InputArray upperb, cv::OutputArray dst)
         // Apply skin color segmentation in HSV
-        inRange(hsvImage, hsvLower, hsvUpper, skinMaskHSVOutput);
+        hsvLut.apply(frame, skinMaskHSVOutput);
 
         // Apply skin color segmentation in YCrCb
-        inRange(ycrcbImage, ycrcbLower, ycrcbUpper, skinMaskYCrCbOutput);
+        ycrcbLut.apply(frame, skinMaskYCrCbOutput);
 
         // Convert single-channel masks to 3-channel images for concatenation
         Mat skinMaskHSV3, skinMaskYCrCb3;
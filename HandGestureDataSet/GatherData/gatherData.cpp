@@ -10,11 +10,37 @@
 #include <filesystem>
 #include <unordered_set>
 
+#include "v4l2Capture.hpp"
+#include "autoThreshold.hpp"
+#include "cameraControl.hpp"
+#include "cameraProfile.hpp"
+#include "captureThread.hpp"
+#include "allocationCounter.hpp"
+#include "contourTracker.hpp"
+#include "featureSet.hpp"
+#include "frameArena.hpp"
+#include "frameFile.hpp"
+#include "frameSource.hpp"
+#include "pyramidSearch.hpp"
+#include "roiTracker.hpp"
+#include "threadPool.hpp"
+#include "thresholdStage.hpp"
+
 namespace fs = std::filesystem;
 
 #define MAXTHRESH 255
-
-int dynamicThresh = 0;
+#define CAMERA_DEVICE "/dev/video2"
+
+bool showOverlay = true;   // Debug overlay window (toggle with 'o')
+bool roiTracking = true;   // Only process around the last hand position (toggle with 't')
+int pyramidFactor = 1;     // > 1 = whole frame searches pick the hand at 1/pyramidFactor first (cycle 1 / 2 / 4 with 'p')
+bool warmStart = true;     // Hand contour followed from the last frame's instead of traced from scratch (toggle with 'w')
+int processingThreads = 0; // Threads the threshold strips are split over (YAML "threads"), 0 = every core
+int featureVersion = FEATURES_V1; // Feature columns logged (YAML "featureVersion", see featureSet.hpp), 1 = the 9 features
+// Threshold picked from each frame's luminance histogram instead of the trackbar (toggle with 'a')
+AutoThresholdMethod autoThresholdMethod = AUTO_THRESHOLD_OFF;
+double autoThresholdPercentile = 0.85;
+int autoThresholdHysteresis = 3;
 // ----------------- Convex Hull Variables ----------------- //
 // These values work with Camera_Settings_2025-06-11_16:52:41.yaml
 int treshVal = 144; // With logitec camera
@@ -40,108 +66,19 @@ int backlightCompensation = 0;
 int whiteBalanceTemperature = 4000;
 int whiteBalanceAuto = 1;
 
-void runCommand(const std::string &command)
-{
-    int result = system(command.c_str());
-    std::cout << "\n[CMD] " << command << std::endl;
-
-    if (result == 0)
-        std::cout << command << " executed successfully.\n";
-    else if (result == 127)
-        std::cout << "❌ 'v4l2-ctl' not found in PATH.\n";
-    else
-        std::cout << "⚠️ Error executing command. Return code: " << result << "\n";
-}
-
-// Callback functions to be executed when trackbar values change
-
-void setAutoExposure(int value, void *)
-{
-    // auto_exposure 0x009a0901 (menu)   : min=0 max=3 default=3 value=3 (Aperture       Priority Mode)
-    //  1: Manual Mode
-    //  3: Aperture Priority Mode
-    if (value == 0)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=1");
-    if (value == 1)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=3");
-}
-
-void setExposureTime(int value, void *)
-{
-    // exposure_time_absolute 0x009a0902 (int)    : min=3 max=2047 step=1 default=250 value=333 flags=inactive
-    //  runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=exposure_auto=1"); // Set manual mode
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=exposure_time_absolute=" + std::to_string(value));
-}
-
-void onFocusChange(int value, void *)
-{
-    // runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_auto=0"); // Disable autofocus
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_absolute=" + std::to_string(value));
-}
-
-void onAutofocusToggle(int value, void *)
-{
-    if (value == 0)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_automatic_continuous=0");
-    if (value == 1)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_automatic_continuous=1");
-}
-
-// Additional recommended control callbacks
-
-void setExposureTimeAbsolute(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 ---set-ctrl=exposure_time_absolute=" + std::to_string(value));
-}
-
-void setBrightness(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=brightness=" + std::to_string(value));
-}
-
-void setContrast(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=contrast=" + std::to_string(value));
-}
-
-void setSaturation(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=saturation=" + std::to_string(value));
-}
-
-void setGain(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=gain=" + std::to_string(value));
-}
-
-void setSharpness(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=sharpness=" + std::to_string(value));
-}
-
-void setBacklightComp(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=backlight_compensation=" + std::to_string(value));
-}
-
-void setWhiteBalanceTemperature(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_temperature=" + std::to_string(value));
-}
-
-void setWhiteBalanceAuto(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_automatic=" + std::to_string(value));
-}
-
 int main(int argc, char *argv[])
 {
     // Expected parameters to be passed
     // 1) Gesture label
+    // 2) Camera settings YAML
+    // 3) Folder the CSV is saved in
+    // Optional, after those :
+    //  --record file.hgf        Also dump every raw camera frame to file.hgf
+    //  --replay file.hgf [--fast] Read frames from a recording instead of the camera (--fast = no pacing, no dropped frames)
 
-    if (argc < 3)
+    if (argc < 4)
     {
-        printf("\n\nEnter name of GESTURE to be recorded and if you want Dynamic thresholding applied (true/false)\r\n\n");
+        printf("\n\nUsage: gatherData <GESTURE label> <camera settings yaml> <save path> [--record file.hgf | --replay file.hgf [--fast]]\r\n\n");
 
         exit(1);
     }
@@ -152,9 +89,20 @@ int main(int argc, char *argv[])
     std::string yamlFilePath = argv[2];
     std::string savePath = argv[3];
 
-    // std::string dynamicArg = argv[2];
-    //  bool dynamicThresholdFlag = (dynamicArg == "true");
-    //  std::cout << argv[2] << "\t" << dynamicThresholdFlag;
+    std::string recordPath, replayPath;
+    bool replayFast = false;
+    for (int i = 4; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (arg == "--fast")
+            replayFast = true;
+        else
+            std::cerr << "⚠️ Ignoring unknown option " << arg << std::endl;
+    }
 
     csvLabel += ".csv";
 
@@ -207,13 +155,6 @@ int main(int argc, char *argv[])
 
     // std::ofstream file("hand_gesture_data.csv", std::ios::app); // Append mode
 
-    // Check if the file is empty before writing the headers
-    if (file.tellp() == 0) // If file is empty, write header
-    {
-        // Write this to the CSV header
-        file << "threshVal,depthLevel,numHullPoints,numDefects,bbox.width,bbox.height,aspect_ratio,area,perimeter,gesture_label\n";
-    }
-
     // -------------- Read from YAML -------------- //
     try
     {
@@ -237,27 +178,45 @@ int main(int argc, char *argv[])
         whiteBalanceAuto = readConfig["whiteBalanceAuto"].as<int>();
         treshVal = readConfig["threshVal"].as<int>();
         depthLevel = readConfig["depthLevel"].as<int>();
+        if (readConfig["showOverlay"]) // Optional, older profiles don't have it
+            showOverlay = readConfig["showOverlay"].as<bool>();
+        if (readConfig["roiTracking"])
+            roiTracking = readConfig["roiTracking"].as<bool>();
+        if (readConfig["pyramidFactor"])
+            pyramidFactor = readConfig["pyramidFactor"].as<int>();
+        if (readConfig["warmStart"])
+            warmStart = readConfig["warmStart"].as<bool>();
+        if (readConfig["autoThreshold"] && !AutoThreshold::parseMethod(readConfig["autoThreshold"].as<std::string>(), autoThresholdMethod))
+            std::cerr << "⚠️ Unknown autoThreshold \"" << readConfig["autoThreshold"].as<std::string>() << "\", kept it off\n";
+        if (readConfig["autoThresholdPercentile"])
+            autoThresholdPercentile = readConfig["autoThresholdPercentile"].as<double>();
+        if (readConfig["autoThresholdHysteresis"])
+            autoThresholdHysteresis = readConfig["autoThresholdHysteresis"].as<int>();
+        if (readConfig["threads"])
+            processingThreads = readConfig["threads"].as<int>();
+        if (readConfig["featureVersion"])
+            featureVersion = readConfig["featureVersion"].as<int>();
+
+        // Set the values, whole profile in one VIDIOC_S_EXT_CTRLS instead of a v4l2-ctl fork per control
+        // (skipped when replaying, the recording already has whatever the camera was set to)
+        CameraControl camera;
+        if (replayPath.empty() && camera.open(CAMERA_DEVICE))
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            std::vector<ControlResult> results = camera.set(controlsFromProfile(readConfig));
+            auto t1 = std::chrono::steady_clock::now();
 
-        // Set the values
-        setAutoExposure(setAutoExposure_, nullptr); // manual (1) or auto (3)
-        setExposureTime(exposureValue, nullptr);    // actual exposure timey
-        setExposureTimeAbsolute(setAutoExposureValue, nullptr);
-        setAutoExposure(exposureValue, nullptr);
-        setBrightness(brightnessValue, nullptr);
-        setContrast(contrastValue, nullptr);
-        setSaturation(saturationValue, nullptr);
-        setGain(gainValue, nullptr);
-        setSharpness(sharpnessValue, nullptr);
-        setBacklightComp(backlightCompensation, nullptr);
-        setWhiteBalanceTemperature(whiteBalanceTemperature, nullptr);
-        setWhiteBalanceAuto(whiteBalanceAuto, nullptr);
+            int failed = printControlResults(results);
+            std::cout << "Applied " << results.size() - failed << "/" << results.size() << " controls in "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() << " us\n";
+        }
 
         std::cout << "\n\n✅ Loaded camera settings from YAML:\n";
         std::cout << "Exposure: " << exposureValue << "\n";
         std::cout << "Focus: " << focusValue << "\n";
         std::cout << "Autofocus Enabled: " << autofocusEnabled << "\n";
         std::cout << "Aperture: " << setAperature << "\n";
-        std::cout << "Auto Exposure: " << setAutoExposureValue << "\n";
+        std::cout << "Auto Exposure: " << setAutoExposure_ << "\n";
         std::cout << "Brightness: " << brightnessValue << "\n";
         std::cout << "Contrast: " << contrastValue << "\n";
         std::cout << "Saturation: " << saturationValue << "\n";
@@ -274,30 +233,88 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // -------------- CSV header -------------- //
+    // Written after the YAML : the columns depend on "featureVersion"
+    if (featureWidth(featureVersion) == 0)
+    {
+        std::cerr << "❌ Unknown featureVersion " << featureVersion << " (1 .. " << FEATURE_VERSION_LATEST << ")" << std::endl;
+        return 1;
+    }
+    const std::string csvHeader = featureCsvHeader(featureVersion) + ",gesture_label";
+
+    // Check if the file is empty before writing the headers
+    if (file.tellp() == 0) // If file is empty, write header
+    {
+        // Write this to the CSV header
+        file << csvHeader << "\n";
+    }
+    else
+    {
+        // Appending : the new rows need the columns the file already has
+        std::ifstream existing(outputFilePath);
+        std::string existingHeader;
+        std::getline(existing, existingHeader);
+        if (existingHeader != csvHeader)
+        {
+            int existingVersion = 0;
+            for (int version = FEATURES_V1; version <= FEATURE_VERSION_LATEST; version++)
+            {
+                if (existingHeader == featureCsvHeader(version) + ",gesture_label")
+                    existingVersion = version;
+            }
+            std::cerr << "❌ " << outputFilePath << " holds feature version " << existingVersion << " rows (0 = unknown), this run writes version "
+                      << featureVersion << ", use another output file" << std::endl;
+            return 1;
+        }
+    }
+
+    // -------------- Thread pool -------------- //
+    // Workers started (and pinned) once here, every frame's threshold pass splits its rows over them
+    ThreadPool::configureShared(processingThreads);
+    ThreadPool &pool = ThreadPool::shared();
+    std::cout << "Thread pool : " << pool.size() << " threads\n";
+
     // std::cout << "Press ENTER to continue...." << std::endl;
     // std::cin.get();
 
     // -------------- Camera -------------- //
-    cv::VideoCapture cap(2, cv::CAP_V4L2);
+    // Straight V4L2 instead of cv::VideoCapture, frames are mmap'd driver buffers (no memcpy)
+    // and the driver queue is capped at 2 buffers so we never process a stale frame
+    V4L2Capture cap;
+    V4L2Source cameraSource(cap);
+    ReplaySource replay;
+    FrameSource *source = &cameraSource;
 
-    double width = 640;
-    double height = 480;
+    int width = 640;
+    int height = 480;
 
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, width);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, height);
     // cv::namedWindow("Camera Feed", cv::WINDOW_AUTOSIZE);
 
-    if (!cap.isOpened())
+    if (!replayPath.empty())
+    {
+        if (!replay.open(replayPath, replayFast))
+            return 1;
+        source = &replay;
+    }
+    else if (!cap.open(CAMERA_DEVICE, width, height, V4L2_PIX_FMT_YUYV, 2) || !cap.start())
     {
         std::cerr << "Error: Could not open camera." << std::endl;
         return 0;
     }
 
+    FrameRecorder recorder;
+    if (!recordPath.empty())
+    {
+        if (!recorder.open(recordPath, source->width(), source->height(), source->stride(), source->pixelFormat()))
+            return 1;
+        std::cout << "✅ Recording raw frames to " << recordPath << std::endl;
+    }
+
     // Trackbars
     cv::namedWindow("Convex Hull Detection", cv::WINDOW_AUTOSIZE);
     cv::createTrackbar("treshVal", "Convex Hull Detection", &treshVal, MAXTHRESH);
     cv::createTrackbar("depthLevel", "Convex Hull Detection", &depthLevel, MAXTHRESH);
-    cv::Mat frame, gray, blurred, thresh;
+    cv::Mat frame, thresh;
 
     // auto now = std::chrono::steady_clock::now();
     // int secondsUntilNextSample = timeOut - std::chrono::duration_cast<std::chrono::seconds>(now - lastSampleTime).count();
@@ -315,39 +332,67 @@ int main(int argc, char *argv[])
     int recordDuration = 30; // in seconds
     auto startTime = std::chrono::steady_clock::now();
 
+    // Capture runs on its own thread into a small ring, the loop below always gets the newest frame
+    // so a slow iteration skips frames instead of falling further and further behind
+    CaptureThread capture(*source, 4);
+    if (recorder.isOpened())
+        capture.setRecorder(&recorder);
+
+    // Threshold + contour search only around where the hand should be, whole frame until it's found
+    RoiTracker tracker(cv::Size(source->width(), source->height()));
+    tracker.setEnabled(roiTracking);
+    PyramidSearch pyramid(pyramidFactor);
+    // The hand's contour is followed from the last frame's, full trace only when it's lost or jumps
+    ContourTracker contourTracker;
+    contourTracker.setEnabled(warmStart);
+    pyramid.setContourTracker(&contourTracker);
+
+    // Histogram of this frame picks the threshold of the next one, treshVal until the first one is in
+    AutoThreshold autoThresh(autoThresholdMethod, autoThresholdPercentile, autoThresholdHysteresis);
+    autoThresh.reset(treshVal);
+
+    // Feature row + the hull / defects it came from, same extractor in gatherData and testGestures
+    FeatureSet features(featureVersion);
+    std::cout << "Feature version " << featureVersion << " : " << features.width() << " features per row\n";
+
+    // Per frame geometry (hull, hull indices, defects) comes out of the arena, reset every frame
+    // contours is findContours' output (a std::vector, OpenCV can't fill a pmr one), kept across frames so it's reused
+    FrameArena arena;
+    std::vector<std::vector<cv::Point>> contours;
+    AllocationMeter loopAllocations("loop"), geometryAllocations("hand geometry");
+
+    capture.start();
+
     while (true)
     {
-        cap >> frame;
-        if (frame.empty())
+        const FrameSlot *slot = capture.waitNewest();
+        if (!slot)
             break;
 
-        // if (dynamicThresholdFlag)
-        // {
-        //     cv::Scalar meanIntensity = cv::mean(gray);
-        //     dynamicThresh = static_cast<int>(meanIntensity[0] * 0.85); // 'Taking' whatever percentage
-        //                                                                //  Of the average brightness of the
-        //                                                                //  Grayscale to use as s threshold
-        //                                                                //  Value
-        //                                                                // Adjust this number to keep more (increase it) of the background
-        //                                                                // Example : 0.9 --> Keep more of background but could be too conservative
-        //                                                                //           0.7 --> More aggressive but might  lose finger details in shadow
-        //                                                                //           8.5 --> Good balance
-        //     dynamicThresh = std::clamp(dynamicThresh, 30, 150);
-
-        //     treshVal = dynamicThresh; // Update global or trackbar value
-        // }
-
-        // Convert to grayscale and apply threshold
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
-        cv::threshold(blurred, thresh, treshVal, MAXTHRESH, cv::THRESH_BINARY); // If pixel greater than thresVal, set it to 255, other than that set it to 0
-
-        // Calculate brightness based on grayscale image
-        // Assume you already have gray (grayscale image)
+        loopAllocations.begin();
+        arena.reset();
+        HandGeometry geometry(arena.resource());
+
+        // Same gray the collected datasets were thresholded on : OpenCV's YUYV → BGR decode (what VideoCapture did),
+        // BGR2GRAY inside the blur + threshold pass. Raw Y would be cheaper but its masks aren't bit exact with it,
+        // and the rows written here have to match the ones already in the CSVs / the models trained on them
+        // If pixel greater than thresVal, set it to 255, other than that set it to 0
+        // Only what gets searched (predicted ROI, or the pyramid's region) is thresholded, in pyramid.search() below,
+        // the rest of thresh is cleared when it's the one on screen
+        cv::Mat yuyv(slot->height, slot->width, CV_8UC2, (void *)slot->data.data(), slot->stride);
+        cv::cvtColor(yuyv, frame, cv::COLOR_YUV2BGR_YUYV);
+        const LumaView luma = lumaFromBGR(frame);
+        if (autoThresh.enabled() && autoThresh.value() != treshVal)
+        {
+            // Trackbar follows so the value written to the CSV is the one on screen
+            treshVal = autoThresh.value();
+            cv::setTrackbarPos("treshVal", "Convex Hull Detection", treshVal);
+        }
+        cv::Rect roi = tracker.predict();
+        if (!showOverlay && !thresh.empty())
+            thresh.setTo(0);
 
         // Find contours
-        std::vector<std::vector<cv::Point>> contours;
-
         /*
             Notes about void cv::findContours(InputArray image, OutputArrayOfArrays contours, int mode, int method, cv::Point offset = cv::Point())
 
@@ -363,21 +408,23 @@ int main(int argc, char *argv[])
             cv::CHAIN_APPROX_TC89_L1	Applies the Teh-Chin approximation to compress the contour further.
             cv::CHAIN_APPROX_TC89_KCOS	Similar to TC89_L1, but uses a different heuristic for contour approximation.
         */
-        cv::findContours(thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        // Threshold + the same findContours(RETR_EXTERNAL, CHAIN_APPROX_SIMPLE) but on the ROI only,
+        // returns the largest contour (likely the hand)
+        int largestContourIdx = pyramid.search(luma, treshVal, roi, thresh, contours);
+        cv::Rect handBox = largestContourIdx != -1 ? cv::boundingRect(contours[largestContourIdx]) : cv::Rect();
 
-        // Find the largest contour (likely the hand)
-        int largestContourIdx = -1;
-        double maxArea = 0;
-
-        for (size_t i = 0; i < contours.size(); i++)
+        // Lost it, or it runs off the ROI → redo the whole frame (coarse to fine when pyramidFactor > 1)
+        if (tracker.needsFullFrame(roi, handBox))
         {
-            double area = cv::contourArea(contours[i]);
-            if (area > maxArea)
-            {
-                maxArea = area;
-                largestContourIdx = i;
-            }
+            roi = tracker.fullFrame();
+            largestContourIdx = pyramid.search(luma, treshVal, roi, thresh, contours);
+            handBox = largestContourIdx != -1 ? cv::boundingRect(contours[largestContourIdx]) : cv::Rect();
         }
+        tracker.update(handBox);
+
+        // Picked from the whole frame, not the ROI that was searched, so tracking doesn't pull the threshold
+        autoThresh.sample(luma);
+        autoThresh.update();
 
         if (largestContourIdx != -1)
         {
@@ -391,78 +438,57 @@ int main(int argc, char *argv[])
 
                 More learning resources about convex hulls ---> https://learnopencv.com/convex-hull-using-opencv-in-python-and-c/
             */
-            // Compute convex hull (for drawing)
-            std::vector<cv::Point> hull;
-            cv::convexHull(contours[largestContourIdx], hull);
-            int numHullPoints = hull.size(); // Store convex hull point count
-
-            // Compute convex hull (for finding defects)
-            std::vector<int> hullIndices;
-            cv::convexHull(contours[largestContourIdx], hullIndices, false, false);
-            std::sort(hullIndices.begin(), hullIndices.end());
+            // Hull, defects, box, area and perimeter in one go, the same code testGestures runs live
+            const std::vector<cv::Point> &hand = contours[largestContourIdx];
+            geometryAllocations.begin();
+            features.extract(hand, treshVal, depthLevel, geometry);
+            geometryAllocations.end();
 
-            // Compute convexity defects
-            int numDefects = 0;
-            std::vector<cv::Vec4i> defects;
-
-            if (hullIndices.size() > 3) // Need at least 4 points to compute defects
+            for (size_t i = 0; i < geometry.defects.size(); i++)
             {
-                cv::convexityDefects(contours[largestContourIdx], hullIndices, defects);
-                numDefects = defects.size(); // Store defect count
-
-                for (size_t i = 0; i < defects.size(); i++)
+                const cv::Vec4i &defect = geometry.defects[i];
+                cv::Point start = hand[defect[0]]; // Start of defect
+                cv::Point end = hand[defect[1]];   // End of defect
+                cv::Point far = hand[defect[2]];   // Deepest point of defect
+                float depth = defect[3] / 256.0;   // Defect depth (conexity defect depth) that measures how deep the
+                                                   // indentation between two points on the
+                                                   // conex hull on a person's hand contour
+
+                // The greater 'depth' is signifies there's a considerable amount of space between fingers or the fact that the fingers are  seperated
+                // depth measured in terms of pixels
+                if (showOverlay && depth > depthLevel)
                 {
-                    cv::Point start = contours[largestContourIdx][defects[i][0]]; // Start of defect
-                    cv::Point end = contours[largestContourIdx][defects[i][1]];   // End of defect
-                    cv::Point far = contours[largestContourIdx][defects[i][2]];   // Deepest point of defect
-                    float depth = defects[i][3] / 256.0;                          // Defect depth (conexity defect depth) that measures how deep the
-                                                                                  // indentation between two points on the
-                                                                                  // conex hull on a person's hand contour
-
-                    // Camera parameters
-                    // double autoWB = cap.get(cv::CAP_PROP_AUTO_WB);
-                    // double wbTemp = cap.get(cv::CAP_PROP_WB_TEMPERATURE);
-
-                    // std::cout << "Defect " << i << ": " << std::endl;
-                    // std::cout << "  Start: (" << start.x << ", " << start.y << ")" << std::endl;
-                    // std::cout << "  End: (" << end.x << ", " << end.y << ")" << std::endl;
-                    // std::cout << "  Far: (" << far.x << ", " << far.y << ")" << std::endl;
-                    // std::cout << "  Depth: " << depth << std::endl;
-                    // std::cout << "Auto White Balance: " << autoWB << std::endl;
-                    // std::cout << "White Balance Temperature: " << wbTemp << std::endl;
-
-                    // The greater 'depth' is signifies there's a considerable amount of space between fingers or the fact that the fingers are  seperated
-                    // depth measured in terms of pixels
-                    if (depth > depthLevel)
-                    {
-                        cv::circle(frame, far, 5, cv::Scalar(0, 0, 255), -1);
-                        cv::circle(frame, start, 5, cv::Scalar(255, 0, 0), -1);
-                        cv::circle(frame, end, 5, cv::Scalar(255, 0, 0), -1);
-                        cv::line(frame, start, far, cv::Scalar(0, 255, 255), 2);
-                        cv::line(frame, end, far, cv::Scalar(0, 255, 255), 2);
-                    }
+                    cv::circle(frame, far, 5, cv::Scalar(0, 0, 255), -1);
+                    cv::circle(frame, start, 5, cv::Scalar(255, 0, 0), -1);
+                    cv::circle(frame, end, 5, cv::Scalar(255, 0, 0), -1);
+                    cv::line(frame, start, far, cv::Scalar(0, 255, 255), 2);
+                    cv::line(frame, end, far, cv::Scalar(0, 255, 255), 2);
                 }
             }
 
-            std::cout << "Convex Hull Points: " << numHullPoints << std::endl;
-
-            // Bounding box
-            cv::Rect bbox = cv::boundingRect(contours[largestContourIdx]);
-            std::cout << "Bounding Box - Width: " << bbox.width << ", Height: " << bbox.height << std::endl;
-
-            // Aspect ratio
-            double aspect_ratio = (double)bbox.width / bbox.height;
-            std::cout << "Aspect Ratio: " << aspect_ratio << std::endl;
-
-            // Area and Perimeter
-            double area = cv::contourArea(contours[largestContourIdx]);
-            double perimeter = cv::arcLength(contours[largestContourIdx], true);
-            std::cout << "Contour Area: " << area << ", Perimeter: " << perimeter << std::endl;
-            std::cout << "dynamicThresh : " << dynamicThresh << std::endl;
+            std::cout << "Convex Hull Points: " << geometry.hull.size() << std::endl;
+            std::cout << "Bounding Box - Width: " << geometry.box.width << ", Height: " << geometry.box.height << std::endl;
+            std::cout << "Aspect Ratio: " << features.handFeatures()[FEATURE_ASPECT_RATIO] << std::endl;
+            std::cout << "Contour Area: " << geometry.area << ", Perimeter: " << geometry.perimeter << std::endl;
+            std::cout << "treshVal : " << treshVal << std::endl;
 
             // Draw contours and convex hull
-            cv::drawContours(frame, contours, largestContourIdx, cv::Scalar(0, 255, 0), 2);
-            cv::polylines(frame, hull, true, cv::Scalar(255, 0, 0), 2);
+            if (showOverlay)
+            {
+                cv::drawContours(frame, contours, largestContourIdx, cv::Scalar(0, 255, 0), 2);
+                const cv::Point *hullPoints = geometry.hull.data();
+                const int hullCount = (int)geometry.hull.size();
+                cv::polylines(frame, &hullPoints, &hullCount, 1, true, cv::Scalar(255, 0, 0), 2);
+                if (tracker.tracking())
+                    cv::rectangle(frame, roi, cv::Scalar(255, 255, 0), 1);
+                if (featureVersion >= FEATURES_V2)
+                {
+                    const FingerGeometry &fingers = features.fingers();
+                    for (int i = 0; i < fingers.tipCount; i++)
+                        cv::circle(frame, fingers.tips[i], 8, cv::Scalar(0, 255, 255), 2);
+                    cv::circle(frame, fingers.palmCentre, (int)fingers.palmRadius, cv::Scalar(255, 0, 255), 1);
+                }
+            }
 
             // auto now = std::chrono::steady_clock::now();
             // auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
@@ -473,16 +499,8 @@ int main(int argc, char *argv[])
             // --------------- Write values to CSV file ---------------
             if (file.is_open())
             {
-                file << treshVal << ","
-                     << depthLevel << ","
-                     << numHullPoints << ","
-                     << numDefects << ","
-                     << bbox.width << ","
-                     << bbox.height << ","
-                     << aspect_ratio << ","
-                     << area << ","
-                     << perimeter << ","
-                     << csvLabel << "\n";
+                features.writeCsv(file);
+                file << "," << csvLabel << "\n";
             }
 
             // // Draw countdown on frame
@@ -490,26 +508,69 @@ int main(int argc, char *argv[])
             // cv::putText(frame, countdownText, cv::Point(50, 50),
             //             cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
         }
+        loopAllocations.end(); // Capture to CSV, the window below is OpenCV's business
+
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
         int remainingTime = recordDuration - static_cast<int>(elapsed);
-        if (remainingTime <= 0)
+        if (remainingTime <= 0 && replayPath.empty()) // A replay runs until the recording ends
             break;
 
-        // Draw countdown on frame
-        std::string countdownText = "Recording ends in: " + std::to_string(remainingTime) + "s";
-        cv::putText(frame, countdownText, cv::Point(25, 25),
-                    cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
-        // Display result
-        cv::imshow("Convex Hull Detection", frame);
-        if (cv::waitKey(1) == 'q')
+        // Display result, overlay off shows the mask so the window (and trackbars) stay alive
+        if (showOverlay)
+        {
+            // Draw countdown on frame
+            std::string countdownText = "Recording ends in: " + std::to_string(remainingTime) + "s";
+            cv::putText(frame, countdownText, cv::Point(25, 25),
+                        cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
+            cv::imshow("Convex Hull Detection", frame);
+        }
+        else
+        {
+            cv::imshow("Convex Hull Detection", thresh);
+        }
+
+        int key = cv::waitKey(1);
+        if (key == 'q')
             break;
+        if (key == 'o')
+            showOverlay = !showOverlay;
+        if (key == 't')
+            tracker.setEnabled(!tracker.enabled());
+        if (key == 'p')
+            pyramid.setFactor(pyramid.factor() >= 4 ? 1 : pyramid.factor() * 2);
+        if (key == 'w')
+            contourTracker.setEnabled(!contourTracker.enabled());
+        if (key == 'a')
+        {
+            // Off <-> the profile's method (otsu if the profile had it off), restarts from the trackbar value
+            autoThresh.setMethod(autoThresh.enabled() ? AUTO_THRESHOLD_OFF
+                                                      : (autoThresholdMethod != AUTO_THRESHOLD_OFF ? autoThresholdMethod : AUTO_THRESHOLD_OTSU));
+            autoThresh.reset(treshVal);
+            std::cout << "Auto threshold: " << AutoThreshold::methodName(autoThresh.method()) << std::endl;
+        }
     }
 
     // Close the file properly after the loop
     file.close();
 
-    cap.release();
+    capture.stop();
+    std::cout << "Frames captured: " << capture.captured() << ", dropped (stale, never processed): " << capture.dropped() << std::endl;
+    tracker.printStats(std::cout);
+    pyramid.printStats(std::cout);
+    contourTracker.printStats(std::cout);
+    arena.printStats(std::cout);
+    geometryAllocations.printStats(std::cout);
+    loopAllocations.printStats(std::cout);
+    autoThresh.printStats(std::cout);
+    pool.printStats(std::cout);
+    if (recorder.isOpened())
+    {
+        recorder.close();
+        std::cout << "Recorded " << recorder.frames() << " frames to " << recordPath << std::endl;
+    }
+
+    cap.close();
     cv::destroyAllWindows();
     return 0;
 }
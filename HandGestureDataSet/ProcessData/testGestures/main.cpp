@@ -12,7 +12,25 @@
 #include <filesystem>
 #include <algorithm> // CHANGE: for std::max_element
 
+#include "v4l2Capture.hpp"
+#include "autoThreshold.hpp"
+#include "cameraControl.hpp"
+#include "cameraProfile.hpp"
+#include "captureThread.hpp"
+#include "allocationCounter.hpp"
+#include "contourTracker.hpp"
+#include "featureSet.hpp"
+#include "frameArena.hpp"
+#include "frameFile.hpp"
+#include "frameSource.hpp"
+#include "latencyTrace.hpp"
+#include "pyramidSearch.hpp"
+#include "roiTracker.hpp"
+#include "threadPool.hpp"
+#include "thresholdStage.hpp"
+
 #define MAXTHRESH 255
+#define CAMERA_DEVICE "/dev/video2"
 
 // ----------------- Globals ----------------- //
 int threshVal = 1; // With logitec camera
@@ -33,63 +51,46 @@ int sharpnessValue = 128;
 int backlightCompensation = 0;
 int whiteBalanceTemperature = 4000;
 int whiteBalanceAuto = 1;
-int onAutofocusToggleValue = 0;
 
-// ----------------- Helper: Run v4l2-ctl ----------------- //
-void runCommand(const std::string &command)
+// ----------------- Latency trace stages ----------------- //
+enum TraceStage
 {
-    int result = system(command.c_str());
-    std::cout << "\n[CMD] " << command << std::endl;
-    if (result == 0)
-        std::cout << "✔️ Command executed successfully\n";
-    else if (result == 127)
-        std::cout << "❌ 'v4l2-ctl' not found in PATH.\n";
-    else
-        std::cout << "⚠️ Error executing command. Code: " << result << "\n";
-}
-
-// ----------------- Camera Control Callbacks ----------------- //
-void setAutoExposure(int value, void *)
+    TRACE_CAPTURE, // V4L2 buffer timestamp
+    TRACE_DEQUEUE, // Frame handed to this loop
+    TRACE_PREPROCESS, // BGR decode for the overlay
+    TRACE_CONTOUR,    // Threshold + largest contour, done together since the ROI / pyramid decide what gets thresholded
+    TRACE_FEATURE,
+    TRACE_INFERENCE, // Decision made ("Predicted Gesture")
+    TRACE_DISPLAY
+};
+
+bool showOverlay = true;   // Debug overlay (toggle with 'o')
+bool roiTracking = true;   // Only process around the last hand position (toggle with 't')
+int pyramidFactor = 1;     // > 1 = whole frame searches pick the hand at 1/pyramidFactor first (cycle 1 / 2 / 4 with 'p')
+bool warmStart = true;     // Hand contour followed from the last frame's instead of traced from scratch (toggle with 'w')
+int processingThreads = 0; // Threads the threshold strips are split over (YAML "threads"), 0 = every core
+
+// Threshold picked from each frame's luminance histogram instead of threshVal (toggle with 'a')
+AutoThresholdMethod autoThresholdMethod = AUTO_THRESHOLD_OFF;
+double autoThresholdPercentile = 0.85;
+int autoThresholdHysteresis = 3;
+
+// Off <-> the profile's method (otsu if the profile had it off), restarts from the current threshVal
+void toggleAutoThreshold(AutoThreshold &autoThresh, int threshVal)
 {
-    // auto_exposure 0x009a0901 (menu)   : min=0 max=3 default=3 value=3 (Aperture Priority Mode)
-    //  1: Manual Mode
-    //  3: Aperture Priority Mode
-    if (value == 0)
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=1");
-    else
-        runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=3");
+    autoThresh.setMethod(autoThresh.enabled() ? AUTO_THRESHOLD_OFF
+                                              : (autoThresholdMethod != AUTO_THRESHOLD_OFF ? autoThresholdMethod : AUTO_THRESHOLD_OTSU));
+    autoThresh.reset(threshVal);
+    std::cout << "Auto threshold: " << AutoThreshold::methodName(autoThresh.method()) << std::endl;
 }
 
-void onAutofocusToggle(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_automatic_continuous=" + std::to_string(value));
-}
-
-void setExposureTime(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=exposure_time_absolute=" + std::to_string(value));
-}
-
-void onFocusChange(int value, void *)
-{
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_absolute=" + std::to_string(value));
-}
-
-void setBrightness(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=brightness=" + std::to_string(value)); }
-void setContrast(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=contrast=" + std::to_string(value)); }
-void setSaturation(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=saturation=" + std::to_string(value)); }
-void setGain(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=gain=" + std::to_string(value)); }
-void setSharpness(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=sharpness=" + std::to_string(value)); }
-void setBacklightComp(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=backlight_compensation=" + std::to_string(value)); }
-void setWhiteBalanceTemperature(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_temperature=" + std::to_string(value)); }
-void setWhiteBalanceAuto(int value, void *) { runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_automatic=" + std::to_string(value)); }
-
 // ----------------- Main ----------------- //
 // int main()
 int main(int argc, char *argv[])
 {
 
-    if (argc < 1)
+    // testGestures <camera settings yaml> [--record file.hgf | --replay file.hgf [--fast]]
+    if (argc < 2)
     {
         std::cout << "No arguments passed exiting program now...." << std::endl;
         return 1;
@@ -104,6 +105,21 @@ int main(int argc, char *argv[])
 
     std::string YamlPath = argv[1];
 
+    std::string recordPath, replayPath;
+    bool replayFast = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (arg == "--fast")
+            replayFast = true;
+        else
+            std::cerr << "⚠️ Ignoring unknown option " << arg << std::endl;
+    }
+
     std::cout << YamlPath << std::endl;
     std::cin.get();
 
@@ -127,20 +143,27 @@ int main(int argc, char *argv[])
         whiteBalanceAuto = readConfig["whiteBalanceAuto"].as<int>();
         threshVal = readConfig["threshVal"].as<int>();
         depthLevel = readConfig["depthLevel"].as<int>();
-        // onAutofocusToggleValue = readConfig["onAutofocusToggleValue"].as<int>();
-
-        // Set the values
-        setBrightness(brightnessValue, nullptr);
-        setContrast(contrastValue, nullptr);
-        setSaturation(saturationValue, nullptr);
-        setGain(gainValue, nullptr);
-        setSharpness(sharpnessValue, nullptr);
-        setBacklightComp(backlightCompensation, nullptr);
-        setWhiteBalanceTemperature(whiteBalanceTemperature, nullptr);
-        setWhiteBalanceAuto(whiteBalanceAuto, nullptr);
-        setAutoExposure(setAutoExposureValue, nullptr);
-        onAutofocusToggle(onAutofocusToggleValue, nullptr);
-        setExposureTime(exposureValue, nullptr);
+        if (readConfig["showOverlay"]) // Optional, older profiles don't have it
+            showOverlay = readConfig["showOverlay"].as<bool>();
+        if (readConfig["roiTracking"])
+            roiTracking = readConfig["roiTracking"].as<bool>();
+        if (readConfig["pyramidFactor"])
+            pyramidFactor = readConfig["pyramidFactor"].as<int>();
+        if (readConfig["warmStart"])
+            warmStart = readConfig["warmStart"].as<bool>();
+        if (readConfig["autoThreshold"] && !AutoThreshold::parseMethod(readConfig["autoThreshold"].as<std::string>(), autoThresholdMethod))
+            std::cerr << "⚠️ Unknown autoThreshold \"" << readConfig["autoThreshold"].as<std::string>() << "\", kept it off\n";
+        if (readConfig["autoThresholdPercentile"])
+            autoThresholdPercentile = readConfig["autoThresholdPercentile"].as<double>();
+        if (readConfig["autoThresholdHysteresis"])
+            autoThresholdHysteresis = readConfig["autoThresholdHysteresis"].as<int>();
+        if (readConfig["threads"])
+            processingThreads = readConfig["threads"].as<int>();
+
+        // Set the values, whole profile in one VIDIOC_S_EXT_CTRLS
+        CameraControl camera;
+        if (replayPath.empty() && camera.open(CAMERA_DEVICE))
+            printControlResults(camera.set(controlsFromProfile(readConfig)));
 
         std::cout << "\n\n✅ Loaded camera settings from YAML:\n";
         std::cout << "Exposure: " << exposureValue << "\n";
@@ -165,6 +188,12 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // ---------- Thread pool ---------- //
+    // Workers started (and pinned) once here, every frame's threshold pass splits its rows over them
+    ThreadPool::configureShared(processingThreads);
+    ThreadPool &pool = ThreadPool::shared();
+    std::cout << "Thread pool : " << pool.size() << " threads\n";
+
     // ---------- ONNX Runtime Setup ---------- //
     Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "gesture");
     Ort::SessionOptions session_options;
@@ -177,131 +206,178 @@ int main(int argc, char *argv[])
     auto input_name = session.GetInputNameAllocated(0, allocator);
     auto output_name = session.GetOutputNameAllocated(0, allocator);
 
+    // The model's input width says which features it was trained on, that's the version extracted every frame
+    std::vector<int64_t> modelInputShape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    const int modelInputWidth = modelInputShape.size() == 2 ? (int)modelInputShape[1] : -1;
+    const int featureVersion = featureVersionForWidth(modelInputWidth);
+    if (featureVersion == 0)
+    {
+        std::cerr << "❌ Model takes " << modelInputWidth << " features, no feature version has that many" << std::endl;
+        return -1;
+    }
+    std::cout << "Model input : " << modelInputWidth << " features (feature version " << featureVersion << ")\n";
+
     // ---------- Camera Setup ---------- //
-    cv::VideoCapture cap(2, cv::CAP_V4L2);
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, 640);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
-    if (!cap.isOpened())
+    // Direct V4L2 capture: mmap'd buffers, driver queue capped at 2 to keep latency down
+    // (or a recording when --replay is given)
+    V4L2Capture cap;
+    V4L2Source cameraSource(cap);
+    ReplaySource replay;
+    FrameSource *source = &cameraSource;
+
+    if (!replayPath.empty())
+    {
+        if (!replay.open(replayPath, replayFast))
+            return -1;
+        source = &replay;
+    }
+    else if (!cap.open(CAMERA_DEVICE, 640, 480, V4L2_PIX_FMT_YUYV, 2) || !cap.start())
     {
         std::cerr << "❌ Cannot open camera\n";
         return -1;
     }
 
+    FrameRecorder recorder;
+    if (!recordPath.empty() && !recorder.open(recordPath, source->width(), source->height(), source->stride(), source->pixelFormat()))
+        return -1;
+
+    cv::Mat frame, thresh;
+
+    // Capture runs on its own thread into a small ring, every iteration classifies the newest frame
+    CaptureThread capture(*source, 4);
+    if (recorder.isOpened())
+        capture.setRecorder(&recorder);
+
+    // How old each frame is at every stage, report printed at exit
+    LatencyTrace trace({"capture", "dequeue", "preprocess", "threshold+contour", "feature", "inference", "display"});
+
+    // Threshold + contour search only around where the hand should be, whole frame until it's found
+    RoiTracker tracker(cv::Size(source->width(), source->height()));
+    tracker.setEnabled(roiTracking);
+    PyramidSearch pyramid(pyramidFactor);
+    // The hand's contour is followed from the last frame's, full trace only when it's lost or jumps
+    ContourTracker contourTracker;
+    contourTracker.setEnabled(warmStart);
+    pyramid.setContourTracker(&contourTracker);
+
+    // Histogram of this frame picks the threshold of the next one, threshVal until the first one is in
+    AutoThreshold autoThresh(autoThresholdMethod, autoThresholdPercentile, autoThresholdHysteresis);
+    autoThresh.reset(threshVal);
+
+    // Feature row + the hull / defects it came from, same extractor in gatherData and testGestures
+    FeatureSet features(featureVersion);
+
+    // Per frame geometry (hull, hull indices, defects) comes out of the arena, reset every frame
+    // contours is findContours' output (a std::vector, OpenCV can't fill a pmr one), kept across frames so it's reused
+    FrameArena arena;
+    std::vector<std::vector<cv::Point>> contours;
+    // Dequeue to feature vector, inference (ONNX Runtime) and display aren't ours to count
+    AllocationMeter frameAllocations("capture to features"), geometryAllocations("hand geometry");
+
+    capture.start();
+
     while (true)
     {
-        cap >> frame;
-        if (frame.empty())
+        const FrameSlot *slot = capture.waitNewest();
+        if (!slot)
             break;
+        trace.beginFrame(slot->timestampNs);
+        trace.mark(TRACE_DEQUEUE);
+        frameAllocations.begin();
+        arena.reset();
+        HandGeometry geometry(arena.resource());
 
         // ----------------- Step 1: Preprocessing -----------------
-        // if (dynamicThresholdFlag)
-        // {
-        //     cv::Scalar meanIntensity = cv::mean(gray);
-        //     dynamicThresh = static_cast<int>(meanIntensity[0] * 0.85);
-        //     dynamicThresh = std::clamp(dynamicThresh, 30, 150);
-        //     threshVal = dynamicThresh; // Update global threshold value
-        // }
-
-        // Convert to grayscale and apply threshold
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
-        cv::threshold(blurred, thresh, threshVal, MAXTHRESH, cv::THRESH_BINARY);
-
-        // ----------------- Step 2: Find Contours -----------------
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-
-        // Find the largest contour (likely the hand)
-        int largestContourIdx = -1;
-        double maxArea = 0;
-        for (size_t i = 0; i < contours.size(); i++)
+        // The gray the models were trained on (gatherData does the same) : OpenCV's YUYV → BGR decode, BGR2GRAY
+        // inside the blur + threshold pass. Raw Y would skip the decode but its masks aren't bit exact with it
+        cv::Mat yuyv(slot->height, slot->width, CV_8UC2, (void *)slot->data.data(), slot->stride);
+        cv::cvtColor(yuyv, frame, cv::COLOR_YUV2BGR_YUYV);
+        const LumaView luma = lumaFromBGR(frame);
+        if (autoThresh.enabled())
+            threshVal = autoThresh.value(); // Logged in the features
+        trace.mark(TRACE_PREPROCESS);
+
+        // ----------------- Step 2: Threshold + Find Contours -----------------
+        // Largest contour in the predicted ROI (likely the hand)
+        // Only what gets searched is thresholded, the rest of thresh is cleared when it's the one on screen
+        cv::Rect roi = tracker.predict();
+        if (!showOverlay && !thresh.empty())
+            thresh.setTo(0);
+
+        int largestContourIdx = pyramid.search(luma, threshVal, roi, thresh, contours);
+        cv::Rect handBox = largestContourIdx != -1 ? cv::boundingRect(contours[largestContourIdx]) : cv::Rect();
+
+        // Lost it, or it runs off the ROI → redo the whole frame (coarse to fine when pyramidFactor > 1)
+        if (tracker.needsFullFrame(roi, handBox))
         {
-            double area = cv::contourArea(contours[i]);
-            if (area > maxArea)
-            {
-                maxArea = area;
-                largestContourIdx = i;
-            }
+            roi = tracker.fullFrame();
+            largestContourIdx = pyramid.search(luma, threshVal, roi, thresh, contours);
+            handBox = largestContourIdx != -1 ? cv::boundingRect(contours[largestContourIdx]) : cv::Rect();
         }
+        tracker.update(handBox);
+
+        // Picked from the whole frame, not the ROI that was searched, so tracking doesn't pull the threshold
+        autoThresh.sample(luma);
+        autoThresh.update();
+
+        trace.mark(TRACE_CONTOUR);
 
         // CHANGE: correctly handle "no contour" case and continue
         if (largestContourIdx == -1)
         {
+            frameAllocations.end();
             std::cout << "No contour found in this frame." << std::endl;
-            cv::imshow("Gesture Detection", frame);
-            if (cv::waitKey(1) == 'q')
+            cv::imshow("Gesture Detection", showOverlay ? frame : thresh);
+            int key = cv::waitKey(1);
+            trace.mark(TRACE_DISPLAY);
+            trace.endFrame();
+            if (key == 'q')
                 break;
+            if (key == 'o')
+                showOverlay = !showOverlay;
+            if (key == 't')
+                tracker.setEnabled(!tracker.enabled());
+            if (key == 'p')
+                pyramid.setFactor(pyramid.factor() >= 4 ? 1 : pyramid.factor() * 2);
+            if (key == 'w')
+                contourTracker.setEnabled(!contourTracker.enabled());
+            if (key == 'a')
+                toggleAutoThreshold(autoThresh, threshVal);
             continue;
         }
 
-        // ----------------- Step 3: Convex Hull -----------------
-        std::vector<cv::Point> hull;
-        cv::convexHull(contours[largestContourIdx], hull);
-        int numHullPoints = (int)hull.size();
-
-        // Compute convex hull indices for defects
-        std::vector<int> hullIndices;
-        cv::convexHull(contours[largestContourIdx], hullIndices, false, false);
-        std::sort(hullIndices.begin(), hullIndices.end());
+        // ----------------- Step 3: Hull, Defects, Features -----------------
+        // Same extractor as gatherData, so the model sees exactly the features it was trained on
+        const std::vector<cv::Point> &hand = contours[largestContourIdx];
+        geometryAllocations.begin();
+        features.extract(hand, threshVal, depthLevel, geometry);
+        geometryAllocations.end();
+        const int numDefects = (int)geometry.defects.size();
 
-        int numDefects = 0;
-        std::vector<cv::Vec4i> defects;
-
-        // ----------------- Step 4: Convexity Defects -----------------
-        if (hullIndices.size() > 3) // need at least 4
+        for (size_t i = 0; i < geometry.defects.size(); i++)
         {
-            try
-            {
-                cv::convexityDefects(contours[largestContourIdx], hullIndices, defects);
-                numDefects = (int)defects.size();
-
-                for (size_t i = 0; i < defects.size(); i++)
-                {
-                    cv::Point start = contours[largestContourIdx][defects[i][0]];
-                    cv::Point end = contours[largestContourIdx][defects[i][1]];
-                    cv::Point far = contours[largestContourIdx][defects[i][2]];
-                    float depth = defects[i][3] / 256.0f;
-
-                    if (depth > depthLevel)
-                    {
-                        cv::circle(frame, far, 5, cv::Scalar(0, 0, 255), -1);
-                        cv::circle(frame, start, 5, cv::Scalar(255, 0, 0), -1);
-                        cv::circle(frame, end, 5, cv::Scalar(255, 0, 0), -1);
-                        cv::line(frame, start, far, cv::Scalar(0, 255, 255), 2);
-                        cv::line(frame, end, far, cv::Scalar(0, 255, 255), 2);
-                    }
-                }
-            }
-            catch (const cv::Exception &e)
+            cv::Point start = hand[geometry.defects[i][0]];
+            cv::Point end = hand[geometry.defects[i][1]];
+            cv::Point far = hand[geometry.defects[i][2]];
+            float depth = geometry.defects[i][3] / 256.0f;
+
+            if (showOverlay && depth > depthLevel)
             {
-                std::cerr << "⚠️ ConvexityDefects error: " << e.what() << std::endl;
-                numDefects = 0; // fail safe
+                cv::circle(frame, far, 5, cv::Scalar(0, 0, 255), -1);
+                cv::circle(frame, start, 5, cv::Scalar(255, 0, 0), -1);
+                cv::circle(frame, end, 5, cv::Scalar(255, 0, 0), -1);
+                cv::line(frame, start, far, cv::Scalar(0, 255, 255), 2);
+                cv::line(frame, end, far, cv::Scalar(0, 255, 255), 2);
             }
         }
-
-        // ----------------- Step 5: Features -----------------
-        cv::Rect bbox = cv::boundingRect(contours[largestContourIdx]);
-        double aspect_ratio = (double)bbox.width / bbox.height;
-        double area = cv::contourArea(contours[largestContourIdx]);
-        double perimeter = cv::arcLength(contours[largestContourIdx], true);
-
-        // Prepare features for SVM/ONNX
-        std::vector<float> features = {
-            (float)threshVal,
-            (float)depthLevel,
-            (float)numHullPoints,
-            (float)numDefects,
-            (float)bbox.width,
-            (float)bbox.height,
-            (float)aspect_ratio,
-            (float)area,
-            (float)perimeter};
+        trace.mark(TRACE_FEATURE);
+        frameAllocations.end();
 
         // ----------------- Step 6: Run Inference -----------------
         auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-        std::array<int64_t, 2> input_shape{1, (int64_t)features.size()};
+        std::array<int64_t, 2> input_shape{1, (int64_t)features.width()};
         Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info, features.data(), features.size(), input_shape.data(), input_shape.size());
+            memory_info, features.data(), features.width(), input_shape.data(), input_shape.size());
 
         // Input and output names (as const char* arrays, not std::string)
         const char *input_names[] = {input_name.get()};
@@ -341,32 +417,73 @@ int main(int argc, char *argv[])
             // std::cout << std::endl;
         }
 
+        trace.mark(TRACE_INFERENCE);
+
         std::cout << "Predicted Gesture: " << predicted_class << std::endl;
-        for (float f : features)
-            std::cout << f << " ";
+        for (int i = 0; i < features.width(); i++)
+            std::cout << features.data()[i] << " ";
         std::cout << std::endl;
-        std::string gestureString = "Gesture " + std::to_string(predicted_class);
-        cv::putText(frame, gestureString, cv::Point(25, 25),
-                    cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
 
         // ----------------- Step 7: Visualization -----------------
-        cv::drawContours(frame, contours, largestContourIdx, cv::Scalar(0, 255, 0), 2);
-        cv::polylines(frame, hull, true, cv::Scalar(255, 0, 0), 2);
-
-        // CHANGE: overlay live debug to confirm YAML-applied values & features
-        std::ostringstream dbg;
-        dbg << "threshold=" << threshVal << " depth=" << depthLevel
-            << " hull=" << numHullPoints << " defects=" << numDefects;
-        cv::putText(frame, dbg.str(), cv::Point(25, 55),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 0), 2);
+        if (showOverlay)
+        {
+            std::string gestureString = "Gesture " + std::to_string(predicted_class);
+            cv::putText(frame, gestureString, cv::Point(25, 25),
+                        cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
+
+            cv::drawContours(frame, contours, largestContourIdx, cv::Scalar(0, 255, 0), 2);
+            const cv::Point *hullPoints = geometry.hull.data();
+            const int hullCount = (int)geometry.hull.size();
+            cv::polylines(frame, &hullPoints, &hullCount, 1, true, cv::Scalar(255, 0, 0), 2);
+            if (tracker.tracking())
+                cv::rectangle(frame, roi, cv::Scalar(255, 255, 0), 1);
+
+            // CHANGE: overlay live debug to confirm YAML-applied values & features
+            std::ostringstream dbg;
+            dbg << "threshold=" << threshVal << " depth=" << depthLevel
+                << " hull=" << geometry.hull.size() << " defects=" << numDefects;
+            cv::putText(frame, dbg.str(), cv::Point(25, 55),
+                        cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 0), 2);
+        }
 
         // ----------------- Step 8: Show frame -----------------
-        cv::imshow("Gesture Detection", frame);
-        if (cv::waitKey(1) == 'q')
+        // Overlay off shows the mask, keeps the window responsive without rebuilding BGR
+        cv::imshow("Gesture Detection", showOverlay ? frame : thresh);
+        int key = cv::waitKey(1);
+        trace.mark(TRACE_DISPLAY);
+        trace.endFrame();
+        if (key == 'q')
             break;
+        if (key == 'o')
+            showOverlay = !showOverlay;
+        if (key == 't')
+            tracker.setEnabled(!tracker.enabled());
+        if (key == 'p')
+            pyramid.setFactor(pyramid.factor() >= 4 ? 1 : pyramid.factor() * 2);
+        if (key == 'w')
+            contourTracker.setEnabled(!contourTracker.enabled());
+        if (key == 'a')
+            toggleAutoThreshold(autoThresh, threshVal);
+    }
+
+    capture.stop();
+    std::cout << "Frames captured: " << capture.captured() << ", dropped (stale, never classified): " << capture.dropped() << std::endl;
+    trace.printReport(std::cout);
+    tracker.printStats(std::cout);
+    pyramid.printStats(std::cout);
+    contourTracker.printStats(std::cout);
+    arena.printStats(std::cout);
+    geometryAllocations.printStats(std::cout);
+    frameAllocations.printStats(std::cout);
+    autoThresh.printStats(std::cout);
+    pool.printStats(std::cout);
+    if (recorder.isOpened())
+    {
+        recorder.close();
+        std::cout << "Recorded " << recorder.frames() << " frames to " << recordPath << std::endl;
     }
 
-    cap.release();
+    cap.close();
     cv::destroyAllWindows();
     return 0;
 }
@@ -7,7 +7,15 @@
 #include <chrono>
 #include <ctime>
 #include <sstream>
-#define MAXTHRESH 255
+
+#include "v4l2Capture.hpp"
+#include "cameraControl.hpp"
+#include "controlWorker.hpp"
+#include "cameraProfile.hpp"
+#include "thresholdStage.hpp"
+#include "blobLabeler.hpp"
+
+#define CAMERA_DEVICE "/dev/video2"
 // Globals for trackbars
 int exposureValue = 3;
 int focusValue = 30;
@@ -29,90 +37,104 @@ int backlightCompensation = 0;
 int whiteBalanceTemperature = 4000;
 int whiteBalanceAuto = 1;
 
-void runCommand(const std::string &command)
+CameraControl camera; // ioctl based, no v4l2-ctl fork per trackbar tick
+
+ControlWorker controlWorker(camera, 30); // Applies trackbar values off the GUI thread, at most 30 ioctls/s
+
+// Only posts the value, the worker sends the newest one (and prints what the driver did with it)
+void applyControl(uint32_t id, int value)
 {
-    int result = system(command.c_str());
-    std::cout << "\n[CMD] " << command << std::endl;
-
-    if (result == 0)
-        std::cout << "✅ Command executed.\n";
-    else if (result == 127)
-        std::cout << "❌ 'v4l2-ctl' not found.\n";
-    else
-    {
-        if (result == 65280)
-        {
-            std::cout << "⚠️ TURN OFF ANY 'AUTO' SETTINGS PRIOR TO ADJUSTING CAMERA VALUES " << "\n";
-        }
-        std::cout << "⚠️ Command failed. Code: " << result << "\n";
-    }
+    controlWorker.post(id, value);
 }
 
 // Callback functions
 void setAutoExposure(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=auto_exposure=" + std::to_string(value == 0 ? 1 : 3));
+    applyControl(V4L2_CID_EXPOSURE_AUTO, value == 0 ? V4L2_EXPOSURE_MANUAL : V4L2_EXPOSURE_APERTURE_PRIORITY);
 }
 void setExposureTime(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=exposure_time_absolute=" + std::to_string(value));
+    applyControl(V4L2_CID_EXPOSURE_ABSOLUTE, value);
 }
 void onFocusChange(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_absolute=" + std::to_string(value));
+    applyControl(V4L2_CID_FOCUS_ABSOLUTE, value);
 }
 void onAutofocusToggle(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=focus_automatic_continuous=" + std::to_string(value));
+    applyControl(V4L2_CID_FOCUS_AUTO, value);
 }
 void setBrightness(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=brightness=" + std::to_string(value));
+    applyControl(V4L2_CID_BRIGHTNESS, value);
 }
 void setContrast(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=contrast=" + std::to_string(value));
+    applyControl(V4L2_CID_CONTRAST, value);
 }
 void setSaturation(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=saturation=" + std::to_string(value));
+    applyControl(V4L2_CID_SATURATION, value);
 }
 void setGain(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=gain=" + std::to_string(value));
+    applyControl(V4L2_CID_GAIN, value);
 }
 void setSharpness(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=sharpness=" + std::to_string(value));
+    applyControl(V4L2_CID_SHARPNESS, value);
 }
 void setBacklightComp(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=backlight_compensation=" + std::to_string(value));
+    applyControl(V4L2_CID_BACKLIGHT_COMPENSATION, value);
 }
 void setWhiteBalanceTemperature(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_temperature=" + std::to_string(value));
+    applyControl(V4L2_CID_WHITE_BALANCE_TEMPERATURE, value);
 }
 void setWhiteBalanceAuto(int value, void *)
 {
-    runCommand("v4l2-ctl --device=/dev/video2 --set-ctrl=white_balance_automatic=" + std::to_string(value));
+    applyControl(V4L2_CID_AUTO_WHITE_BALANCE, value);
+}
+
+// Current trackbar values in the same layout as the saved Camera_Settings_*.yaml
+YAML::Node currentSettings()
+{
+    YAML::Node cameraSettings;
+    cameraSettings["exposureValue"] = exposureValue;
+    cameraSettings["focusValue"] = focusValue;
+    cameraSettings["autofocusEnabled"] = autofocusEnabled;
+    cameraSettings["setAperature"] = setAperature;
+    cameraSettings["setAutoExposureValue"] = setAutoExposureValue;
+    cameraSettings["brightness"] = brightnessValue;
+    cameraSettings["contrast"] = contrastValue;
+    cameraSettings["saturation"] = saturationValue;
+    cameraSettings["gain"] = gainValue;
+    cameraSettings["sharpness"] = sharpnessValue;
+    cameraSettings["backlightCompensation"] = backlightCompensation;
+    cameraSettings["whiteBalanceTemperature"] = whiteBalanceTemperature;
+    cameraSettings["whiteBalanceAuto"] = whiteBalanceAuto;
+    cameraSettings["threshVal"] = treshVal;
+    cameraSettings["depthLevel"] = depthLevel;
+    return cameraSettings;
 }
 
 int main()
 {
+    if (!camera.open(CAMERA_DEVICE))
+        return -1;
+
     std::cout << "------ Initial Camera Settings ------\n";
-    system("v4l2-ctl --device=/dev/video2 --all");
+    camera.printControls();
 
-    cv::VideoCapture cap(2, cv::CAP_V4L2);
-    if (!cap.isOpened())
+    // Direct V4L2 capture (mmap'd buffers, 2 deep driver queue) instead of cv::VideoCapture
+    V4L2Capture cap;
+    if (!cap.open(CAMERA_DEVICE, 640, 480, V4L2_PIX_FMT_YUYV, 2) || !cap.start())
     {
         std::cerr << "❌ Failed to open camera.\n";
         return -1;
     }
 
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, 640);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
-
     cv::namedWindow("Camera Feed");
     cv::namedWindow("Camera Settings");
     // qcv::namedWindow("Convex Hull Settings");
@@ -135,36 +157,30 @@ int main()
     cv::createTrackbar("Threshold", "Camera Settings", &treshVal, 255);
     cv::createTrackbar("Depth", "Camera Settings", &depthLevel, 20); // Adjust max as needed
 
-    // Apply initial settings
-    setExposureTime(exposureValue, 0);
-    onFocusChange(focusValue, 0);
-    onAutofocusToggle(autofocusEnabled, 0);
-    setAutoExposure(setAperature, 0);
-    setBrightness(brightnessValue, 0);
-    setContrast(contrastValue, 0);
-    setSaturation(saturationValue, 0);
-    setGain(gainValue, 0);
-    setSharpness(sharpnessValue, 0);
-    setBacklightComp(backlightCompensation, 0);
-    setWhiteBalanceAuto(whiteBalanceAuto, 0);
-    setWhiteBalanceTemperature(whiteBalanceTemperature, 0);
+    // Apply initial settings, all of them in one VIDIOC_S_EXT_CTRLS (auto modes first)
+    printControlResults(camera.set(controlsFromProfile(currentSettings())));
+    controlWorker.start(); // Trackbar changes from here on go through the worker
 
     cv::moveWindow("Camera Feed", 100, 100);
     cv::moveWindow("Camera Settings", 800, 100);
 
-    cv::Mat frame, gray, blurred, thresh;
+    cv::Mat frame, thresh;
+    FrameView view;
     while (true)
     {
-        cap >> frame;
-        if (frame.empty())
+        if (!cap.grab(view))
         {
             std::cerr << "⚠️ Blank frame grabbed.\n";
             break;
         }
 
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
-        cv::threshold(blurred, thresh, treshVal, MAXTHRESH, cv::THRESH_BINARY); // If pixel greater than
+        // Wrap the driver buffer (no copy), decode once, then give the buffer back
+        cv::Mat yuyv(view.height, view.width, CV_8UC2, (void *)view.data, view.stride);
+        cv::cvtColor(yuyv, frame, cv::COLOR_YUV2BGR_YUYV);
+        view.release();
+
+        // BGR2GRAY + GaussianBlur(5x5) + threshold in one pass, same mask as the three OpenCV calls
+        blurThreshold(lumaFromBGR(frame), treshVal, thresh);
 
         // Find contours
         std::vector<std::vector<cv::Point>> contours;
@@ -184,22 +200,9 @@ int main()
             cv::CHAIN_APPROX_TC89_L1	Applies the Teh-Chin approximation to compress the contour further.
             cv::CHAIN_APPROX_TC89_KCOS	Similar to TC89_L1, but uses a different heuristic for contour approximation.
         */
-        cv::findContours(thresh, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-
-        // Find the largest contour (likely the hand)
-        int largestContourIdx = -1;
-
-        double maxArea = 0;
-
-        for (size_t i = 0; i < contours.size(); i++)
-        {
-            double area = cv::contourArea(contours[i]);
-            if (area > maxArea)
-            {
-                maxArea = area;
-                largestContourIdx = i;
-            }
-        }
+        // Largest blob (likely the hand) picked by one labeling pass, only that one is traced (same points as
+        // findContours(RETR_EXTERNAL, CHAIN_APPROX_SIMPLE)), noise specks never become contours
+        int largestContourIdx = largestContour(thresh, cv::Rect(0, 0, thresh.cols, thresh.rows), contours);
 
         if (largestContourIdx != -1)
         {
@@ -293,26 +296,14 @@ int main()
             break;
     }
 
-    cap.release();
+    cap.close();
+    controlWorker.stop();
+    std::cout << controlWorker.posted() << " trackbar changes → " << controlWorker.batches() << " control ioctls\n";
+    camera.close();
     cv::destroyAllWindows();
 
     // Save all settings to YAML
-    YAML::Node cameraSettings;
-    cameraSettings["exposureValue"] = exposureValue;
-    cameraSettings["focusValue"] = focusValue;
-    cameraSettings["autofocusEnabled"] = autofocusEnabled;
-    cameraSettings["setAperature"] = setAperature;
-    cameraSettings["setAutoExposureValue"] = setAutoExposureValue;
-    cameraSettings["brightness"] = brightnessValue;
-    cameraSettings["contrast"] = contrastValue;
-    cameraSettings["saturation"] = saturationValue;
-    cameraSettings["gain"] = gainValue;
-    cameraSettings["sharpness"] = sharpnessValue;
-    cameraSettings["backlightCompensation"] = backlightCompensation;
-    cameraSettings["whiteBalanceTemperature"] = whiteBalanceTemperature;
-    cameraSettings["whiteBalanceAuto"] = whiteBalanceAuto;
-    cameraSettings["threshVal"] = treshVal;
-    cameraSettings["depthLevel"] = depthLevel;
+    YAML::Node cameraSettings = currentSettings();
 
     try
     {
@@ -0,0 +1,158 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchFrames.hpp"
+#include "blobLabeler.hpp"
+#include "contourHull.hpp"
+#include "thresholdStage.hpp"
+
+// ----------------- HullBenchmark ----------------- //
+// contourHull (Common/contourHull, O(n + w + h)) against what handFeatures used to run, cv::convexHull for the indices + a sort
+//  - ./hullBenchmark [--thresh N] [--repeat N] [recording.hgf | image ...]
+//  - No input = synthetic sequence (a hand shaped blob moving over noise, thin fingers of changing width)
+//  - Every frame's hand contour (blurThreshold + largestContour, like gatherData) is hulled both ways :
+//    same indices, and hullDefects gives the same defects as convexityDefects, or the frame is reported
+//  - Exits with 1 on any difference, so it can gate a change to the hull
+
+// The old handFeatures hull : indices from convexHull, sorted for convexityDefects
+void openCvHull(const std::vector<cv::Point> &contour, std::vector<int> &indices)
+{
+    cv::convexHull(contour, indices, false, false);
+    std::sort(indices.begin(), indices.end());
+}
+
+// The old handFeatures defects, false where convexityDefects throws
+bool openCvDefects(const std::vector<cv::Point> &contour, const std::vector<int> &indices, std::vector<cv::Vec4i> &defects)
+{
+    defects.clear();
+    if (indices.size() <= 3)
+        return true;
+    try
+    {
+        cv::convexityDefects(contour, indices, defects);
+    }
+    catch (const cv::Exception &)
+    {
+        defects.clear();
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int threshVal = 128;
+    int repeat = 20;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--thresh" && i + 1 < argc)
+            threshVal = std::stoi(argv[++i]);
+        else if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1, std::stoi(argv[++i]));
+        else
+            inputs.push_back(arg);
+    }
+
+    // ---------- Frames ---------- //
+    // Every frame as a LumaView + the threshold that applies to it (raw Y for recordings, gray for images)
+    BenchFrames bench;
+    if (!bench.load(inputs, threshVal))
+        return -1;
+    if (inputs.empty())
+        bench.add(syntheticHandFrames(200, 0, false), threshVal);
+    const std::vector<std::pair<LumaView, int>> &frames = bench.frames();
+
+    // ---------- Hand contours ---------- //
+    cv::Mat mask;
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<std::vector<cv::Point>> hands;
+    size_t points = 0;
+    for (const auto &frame : frames)
+    {
+        blurThreshold(frame.first, frame.second, mask);
+        if (largestContour(mask, cv::Rect(0, 0, frame.first.width, frame.first.height), contours) == 0 && !contours[0].empty())
+        {
+            points += contours[0].size();
+            hands.push_back(std::move(contours[0]));
+        }
+    }
+
+    if (hands.empty())
+    {
+        std::cerr << "❌ No hand contour in " << frames.size() << " frames" << std::endl;
+        return -1;
+    }
+    std::cout << hands.size() << " hand contours from " << frames.size() << " frames, " << points / hands.size()
+              << " points on average, threshVal " << threshVal << ", " << repeat << " repeats\n\n";
+
+    // ---------- Same hull ? ---------- //
+    std::vector<int> reference;
+    std::vector<cv::Vec4i> referenceDefects;
+    std::pmr::vector<int> got;
+    std::pmr::vector<cv::Vec4i> gotDefects;
+    size_t badIndices = 0, badDefects = 0;
+    for (size_t i = 0; i < hands.size(); i++)
+    {
+        openCvHull(hands[i], reference);
+        contourHull(hands[i], got);
+
+        if (!std::equal(got.begin(), got.end(), reference.begin(), reference.end()))
+        {
+            if (badIndices++ < 5)
+                std::cerr << "⚠️ Contour " << i << " : " << got.size() << " hull indices vs " << reference.size() << " for convexHull" << std::endl;
+        }
+
+        // hullDefects on our hull against convexityDefects on convexHull's, a refusal only matches a refusal
+        const bool refOk = openCvDefects(hands[i], reference, referenceDefects);
+        gotDefects.clear();
+        const bool gotOk = got.size() <= 3 || hullDefects(hands[i], got, gotDefects);
+        if (refOk != gotOk ||
+            !std::equal(gotDefects.begin(), gotDefects.end(), referenceDefects.begin(), referenceDefects.end()))
+        {
+            if (badDefects++ < 5)
+                std::cerr << "⚠️ Contour " << i << " : " << gotDefects.size() << " defects vs " << referenceDefects.size()
+                          << " for convexityDefects" << std::endl;
+        }
+    }
+
+    // ---------- Timing ---------- //
+    auto timeHull = [&](auto hull, auto indices)
+    {
+        size_t vertices = 0; // Keeps the calls from being optimised away
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++)
+            for (const auto &hand : hands)
+            {
+                hull(hand, indices);
+                vertices += indices.size();
+            }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        return vertices ? us / ((double)repeat * hands.size()) : 0.0;
+    };
+
+    const double openCvUs = timeHull(openCvHull, std::vector<int>());
+    const double contourUs = timeHull([](const std::vector<cv::Point> &c, std::pmr::vector<int> &i) { contourHull(c, i); },
+                                      std::pmr::vector<int>());
+
+    std::printf("%-32s %12s\n", "hull", "us/contour");
+    std::printf("%-32s %12.2f\n", "cv::convexHull + sort", openCvUs);
+    std::printf("%-32s %12.2f\n", "contourHull", contourUs);
+    std::printf("\nx%.2f, %zu index / %zu defect differences over %zu contours\n",
+                contourUs > 0 ? openCvUs / contourUs : 0.0, badIndices, badDefects, hands.size());
+
+    if (badIndices || badDefects)
+    {
+        std::cerr << "\n❌ contourHull differs from cv::convexHull" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ contourHull gives the same hull indices and defects as cv::convexHull" << std::endl;
+    return 0;
+}
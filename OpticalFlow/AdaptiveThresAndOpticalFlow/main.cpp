@@ -2,34 +2,50 @@
 #include <iostream>
 #include <vector>
 
-// Function to apply adaptive thresholding
-cv::Mat applyAdaptiveThreshold(const cv::Mat &grayFrame)
+#include "allocationCounter.hpp"
+#include "integralThreshold.hpp"
+#include "matPool.hpp"
+
+// calcOpticalFlowPyrLK's default window and levels, the pyramids handed to it are built with the same
+const cv::Size LK_WINDOW(21, 21);
+const int LK_LEVELS = 3;
+
+// Function to apply adaptive thresholding, into the caller's thresholded (reused frame after frame)
+// cv::adaptiveThreshold(GAUSSIAN_C, 11, 2) approximated with 3 running box sums, split over row bands
+void applyAdaptiveThreshold(const cv::Mat &grayFrame, cv::Mat &thresholded)
 {
-    cv::Mat thresholded;
-    cv::adaptiveThreshold(grayFrame, thresholded, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C,
-                          cv::THRESH_BINARY, 11, 2);
-    return thresholded;
+    integralThreshold(lumaFromGray(grayFrame), thresholded, 11, 2, ADAPTIVE_BOX_GAUSSIAN);
 }
 
-// Function to compute and display optical flow
-void computeOpticalFlow(cv::Mat &prevGray, cv::Mat &gray, const cv::Mat &mask)
+// Points, status and errors of the flow, kept by the caller so their capacity carries over from frame to frame
+struct OpticalFlowBuffers
 {
     std::vector<cv::Point2f> prevPoints, currPoints;
-    cv::goodFeaturesToTrack(prevGray, prevPoints, 100, 0.3, 7, mask);
+    std::vector<uchar> status;
+    std::vector<float> err;
+};
 
-    if (!prevPoints.empty())
+// Function to compute and display optical flow
+// prevPyramid / pyramid : buildOpticalFlowPyramid() of the last and this frame's gray, [0] is the gray itself
+//  - calcOpticalFlowPyrLK given the images builds both pyramids every call, given pyramids (same window and levels
+//    it would build them with) it uses them as they are → each frame's pyramid is built once instead of twice
+void computeOpticalFlow(const std::vector<cv::Mat> &prevPyramid, const std::vector<cv::Mat> &pyramid, const cv::Mat &mask,
+                        OpticalFlowBuffers &flow)
+{
+    cv::goodFeaturesToTrack(prevPyramid[0], flow.prevPoints, 100, 0.3, 7, mask);
+
+    if (!flow.prevPoints.empty())
     {
-        std::vector<uchar> status;
-        std::vector<float> err;
-        cv::calcOpticalFlowPyrLK(prevGray, gray, prevPoints, currPoints, status, err);
+        cv::calcOpticalFlowPyrLK(prevPyramid, pyramid, flow.prevPoints, flow.currPoints, flow.status, flow.err,
+                                 LK_WINDOW, LK_LEVELS);
 
         // Draw motion vectors
-        for (size_t i = 0; i < currPoints.size(); i++)
+        for (size_t i = 0; i < flow.currPoints.size(); i++)
         {
-            if (status[i])
+            if (flow.status[i])
             {
-                cv::line(mask, prevPoints[i], currPoints[i], cv::Scalar(0, 255, 0), 2);
-                cv::circle(mask, currPoints[i], 5, cv::Scalar(0, 0, 255), -1);
+                cv::line(mask, flow.prevPoints[i], flow.currPoints[i], cv::Scalar(0, 255, 0), 2);
+                cv::circle(mask, flow.currPoints[i], 5, cv::Scalar(0, 0, 255), -1);
             }
         }
     }
@@ -44,9 +60,19 @@ int main()
         return -1;
     }
 
-    cv::Mat frame, gray, prevGray, adaptiveThresh;
+    // Every stage writes into these, same size every frame → allocated once
+    cv::Mat frame, gray, adaptiveThresh;
+    std::vector<cv::Mat> prevPyramid, pyramid;
+    OpticalFlowBuffers flow;
+    MatPool pool;
+
+    // Gray, threshold, mask and pyramid should allocate nothing after the first frames.
+    // goodFeaturesToTrack and calcOpticalFlowPyrLK are left out : they build scratch of their own inside on every call
+    AllocationMeter stageAllocations("threshold + pyramid");
+
     cap >> frame;
-    cv::cvtColor(frame, prevGray, cv::COLOR_BGR2GRAY); // Initialize prevGray
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::buildOpticalFlowPyramid(gray, prevPyramid, LK_WINDOW, LK_LEVELS); // Initialize the previous frame
 
     while (true)
     {
@@ -54,27 +80,41 @@ int main()
         if (frame.empty())
             break;
 
+        stageAllocations.begin();
+
         // Convert frame to grayscale
         cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
 
         // Apply adaptive thresholding to isolate the hand
-        adaptiveThresh = applyAdaptiveThreshold(gray);
+        applyAdaptiveThreshold(gray, adaptiveThresh);
+
+        // Motion vectors are drawn on a copy of the thresholded mask, a pool buffer instead of a clone per frame
+        cv::Mat mask = pool.get(adaptiveThresh.size(), CV_8UC1);
+        adaptiveThresh.copyTo(mask);
+
+        // Pyramid of this frame, buildOpticalFlowPyramid() reuses the levels when the size doesn't change
+        cv::buildOpticalFlowPyramid(gray, pyramid, LK_WINDOW, LK_LEVELS);
+
+        stageAllocations.end();
 
         // Compute optical flow using the thresholded mask
-        cv::Mat mask = adaptiveThresh.clone();
-        computeOpticalFlow(prevGray, gray, mask);
+        computeOpticalFlow(prevPyramid, pyramid, mask, flow);
 
         // Display results
         cv::imshow("Original Frame", frame);
         cv::imshow("Adaptive Thresholding", adaptiveThresh);
         cv::imshow("Optical Flow", mask);
 
-        prevGray = gray.clone();
+        // This frame's pyramid is the previous one next time, the old one's buffers get rebuilt over (no clone)
+        std::swap(prevPyramid, pyramid);
 
         if (cv::waitKey(30) == 'q')
             break;
     }
 
+    stageAllocations.printStats(std::cout);
+    pool.printStats(std::cout);
+
     cap.release();
     cv::destroyAllWindows();
     return 0;
@@ -5,6 +5,8 @@
 #include <numeric>
 #include <cmath>
 
+#include "allocationCounter.hpp"
+
 /*
     Main goals for this program
         - Learn more about the Shi_Tomasi and Harris corner detection algorithms [DONE]
@@ -60,10 +62,13 @@ int main()
     cv::createTrackbar("Low Cb", "Optical Flow - Lucas-Kanade", &low_Cb, 255, on_trackbar);
     cv::createTrackbar("High Cb", "Optical Flow - Lucas-Kanade", &high_Cb, 255, on_trackbar);
 
+    // Every stage writes into these, same size every frame → allocated once
     cv::Mat prevGray, gray, frame;
-    cv::Mat ycrcbFrame, frameClone, maskedGray, mask, blendedGray;
+    cv::Mat ycrcbFrame, maskedGray, mask, blendedGray;
 
     std::vector<cv::Point2f> prevPoints, currPoints;
+    std::vector<uchar> status;
+    std::vector<float> err;
 
     // Capture the first frame to initialize previous points
     cap >> frame;
@@ -82,21 +87,26 @@ int main()
     cv::Ptr<cv::BackgroundSubtractor> bgSubtractor = cv::createBackgroundSubtractorMOG2();
     cv::Mat fgMask;
 
+    // Gray and the masks should allocate nothing after the first frames. MOG2, goodFeaturesToTrack and
+    // calcOpticalFlowPyrLK are left out, they're OpenCV's own business
+    AllocationMeter maskAllocations("gray + YCrCb masks");
+
     while (runProgram)
     {
         cap >> frame;
         if (frame.empty())
             break;
 
-        // Convert to grayscale
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-
         // Apply background subtraction
         bgSubtractor->apply(frame, fgMask);
 
-        // Cloned so I can pass this frame to a different cvtColor()
-        frameClone = frame.clone();
-        cv::cvtColor(frameClone, ycrcbFrame, cv::COLOR_BGR2YCrCb);
+        maskAllocations.begin();
+
+        // Convert to grayscale
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+
+        // cvtColor only reads frame, no need for a clone to convert it a second time
+        cv::cvtColor(frame, ycrcbFrame, cv::COLOR_BGR2YCrCb);
         cv::inRange(ycrcbFrame, cv::Scalar(low_Y, low_Cr, low_Cb), cv::Scalar(high_Y, high_Cr, high_Cb), mask);
 
         // Combine both masks (YCrCb mask & background subtraction mask)
@@ -106,10 +116,11 @@ int main()
         cv::bitwise_and(gray, gray, maskedGray, mask);
         cv::addWeighted(gray, 0.5, maskedGray, 0.5, 0, blendedGray);
 
-        // Calculate optical flow
-        std::vector<uchar> status;
-        std::vector<float> err;
+        maskAllocations.end();
 
+        // Calculate optical flow
+        status.clear();
+        err.clear();
         if (!prevPoints.empty())
             cv::calcOpticalFlowPyrLK(prevGray, maskedGray, prevPoints, currPoints, status, err);
 
@@ -161,7 +172,7 @@ int main()
         }
 
         prevPoints = currPoints;
-        prevGray = gray.clone();
+        cv::swap(prevGray, gray); // gray is written over next frame, its old buffer is reused instead of a clone
 
         cv::imshow("Optical Flow - Lucas-Kanade", frame);
         cv::imshow("YCrCb Mask", mask);
@@ -189,6 +200,8 @@ int main()
         }
     }
 
+    maskAllocations.printStats(std::cout);
+
     cap.release();
     cv::destroyAllWindows();
     return 0;
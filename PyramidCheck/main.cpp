@@ -0,0 +1,169 @@
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchFrames.hpp"
+#include "blobLabeler.hpp"
+#include "handFeatures.hpp"
+#include "pyramidSearch.hpp"
+#include "roiTracker.hpp"
+#include "thresholdStage.hpp"
+
+// ----------------- PyramidCheck ----------------- //
+// Are the features from the coarse to fine search (PyramidSearch, 1/2 and 1/4) still the ones the SVM was trained on ?
+//  - Every frame goes through the full resolution search and the pyramid one, the hand's
+//    area / perimeter / numDefects are compared against the tolerances below
+//  - ./pyramidCheck [--thresh N] [recording.hgf | image ...]
+//  - No input = synthetic sequence (a hand shaped blob moving over noise, plus smaller blobs)
+//  - Exits with 1 when a tolerance is broken, so it can gate a change to the pipeline
+
+// ---------- Documented tolerances ---------- //
+// The fine pass is the normal full resolution blurThreshold + findContours on a region around the blob,
+// so a frame is either exact or the coarse pass picked another blob (two blobs of almost the same size)
+static const double TOL_AREA = 0.01;       // Relative
+static const double TOL_PERIMETER = 0.01;  // Relative
+static const int TOL_DEFECTS = 1;          // Absolute
+static const double MAX_BAD_FRAMES = 0.01; // Share of frames allowed outside the tolerances
+
+struct HandFeatures
+{
+    bool found = false;
+    double area = 0;
+    double perimeter = 0;
+    int numDefects = 0;
+};
+
+// Same features gatherData writes to the CSV
+HandFeatures featuresOf(const std::vector<std::vector<cv::Point>> &contours, int idx)
+{
+    HandFeatures f;
+    if (idx == -1)
+        return f;
+
+    static HandFeatureExtractor extractor;
+    static HandGeometry geometry;
+    HandFeatureVector vector;
+    extractor.extract(contours[idx], 0, 0, geometry, vector);
+
+    f.found = true;
+    f.area = geometry.area;
+    f.perimeter = geometry.perimeter;
+    f.numDefects = (int)geometry.defects.size();
+    return f;
+}
+
+bool withinTolerance(const HandFeatures &ref, const HandFeatures &got)
+{
+    if (ref.found != got.found)
+        return false;
+    if (!ref.found)
+        return true;
+
+    return std::abs(got.area - ref.area) <= TOL_AREA * ref.area &&
+           std::abs(got.perimeter - ref.perimeter) <= TOL_PERIMETER * ref.perimeter &&
+           std::abs(got.numDefects - ref.numDefects) <= TOL_DEFECTS;
+}
+
+bool exactly(const HandFeatures &ref, const HandFeatures &got)
+{
+    return ref.found == got.found && ref.area == got.area && ref.perimeter == got.perimeter && ref.numDefects == got.numDefects;
+}
+
+int main(int argc, char **argv)
+{
+    int threshVal = 128;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--thresh" && i + 1 < argc)
+            threshVal = std::stoi(argv[++i]);
+        else
+            inputs.push_back(arg);
+    }
+
+    // ---------- Frames ---------- //
+    // Every frame as a LumaView + the threshold that applies to it (raw Y for recordings, gray for images)
+    BenchFrames bench;
+    if (!bench.load(inputs, threshVal))
+        return -1;
+    if (inputs.empty())
+        bench.add(syntheticHandFrames(200, 22, true), threshVal);
+    const std::vector<std::pair<LumaView, int>> &frames = bench.frames();
+
+    if (frames.empty())
+    {
+        std::cerr << "❌ No frames to check" << std::endl;
+        return -1;
+    }
+
+    std::cout << frames.size() << " frames, threshVal " << threshVal << "\n"
+              << "Tolerances : area " << TOL_AREA * 100 << "%, perimeter " << TOL_PERIMETER * 100 << "%, numDefects ±"
+              << TOL_DEFECTS << ", at most " << MAX_BAD_FRAMES * 100 << "% of the frames outside them\n\n";
+
+    // ---------- Full resolution reference ---------- //
+    cv::Mat mask;
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<HandFeatures> reference;
+    double referenceMs = 0;
+    for (const auto &frame : frames)
+    {
+        const cv::Rect full(0, 0, frame.first.width, frame.first.height);
+        auto t0 = std::chrono::steady_clock::now();
+        blurThreshold(frame.first, frame.second, mask);
+        int idx = largestContour(mask, full, contours);
+        referenceMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        reference.push_back(featuresOf(contours, idx));
+    }
+
+    std::printf("%-22s %10s %8s %8s %8s\n", "search", "ms/frame", "exact", "in tol", "outside");
+    std::printf("%-22s %10.3f %8zu %8s %8s\n", "full resolution", referenceMs / frames.size(), frames.size(), "-", "-");
+
+    // ---------- Pyramid ---------- //
+    bool ok = true;
+    for (int factor : {2, 4})
+    {
+        PyramidSearch pyramid(factor);
+        size_t exact = 0, inTolerance = 0, outside = 0;
+        double ms = 0;
+
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            const LumaView &luma = frames[i].first;
+            auto t0 = std::chrono::steady_clock::now();
+            int idx = pyramid.search(luma, frames[i].second, cv::Rect(0, 0, luma.width, luma.height), mask, contours);
+            ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+            HandFeatures got = featuresOf(contours, idx);
+            if (exactly(reference[i], got))
+                exact++;
+            else if (withinTolerance(reference[i], got))
+                inTolerance++;
+            else
+            {
+                outside++;
+                std::cerr << "⚠️ 1/" << factor << " frame " << i << " : area " << got.area << " vs " << reference[i].area
+                          << ", perimeter " << got.perimeter << " vs " << reference[i].perimeter
+                          << ", numDefects " << got.numDefects << " vs " << reference[i].numDefects << std::endl;
+            }
+        }
+
+        std::printf("%-22s %10.3f %8zu %8zu %8zu\n", ("pyramid 1/" + std::to_string(factor)).c_str(), ms / frames.size(), exact, inTolerance, outside);
+        pyramid.printStats(std::cout);
+        ok &= outside <= MAX_BAD_FRAMES * frames.size();
+    }
+
+    if (!ok)
+    {
+        std::cerr << "\n❌ Pyramid features are outside the tolerances" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Pyramid features are within the tolerances" << std::endl;
+    return 0;
+}
@@ -5,6 +5,10 @@
 #include <opencv2/highgui.hpp>
 #include <opencv2/video.hpp>
 
+#include "bitMask.hpp"
+#include "skinLut.hpp"
+#include "threadPool.hpp"
+
 #define USBCAMERA 2
 
 using namespace cv;
@@ -12,6 +16,10 @@ using namespace std;
 
 int main()
 {
+    // Workers started once and pinned, the LUT lookups / morphology / median split their rows over them every frame
+    ThreadPool &pool = ThreadPool::shared();
+    cout << "Thread pool : " << pool.size() << " threads" << endl;
+
     VideoCapture usbCamera(USBCAMERA);
     Mat frame, grayFrame;
 
@@ -25,10 +33,11 @@ int main()
     usbCamera.set(cv::CAP_PROP_FRAME_WIDTH, 640);
     usbCamera.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
 
-    // HSV and YCbCr masks, kernels
-    Mat hsvMask, hsvImage;
-    Mat yCbCrMask, yCbCrImage;
-    Mat global_mask;
+    // HSV and YCbCr masks, 1 bit per pixel until they're displayed
+    BitMask hsvMask;
+    BitMask yCbCrMask;
+    BitMask global_mask;
+    BitMask inverted;
     Mat HSV_result, YCrCb_result, global_result;
     Mat finalImage;
 
@@ -36,9 +45,14 @@ int main()
     int upperH = 17, upperS = 170, upperV = 255;
     Scalar lower_hsv(lowerH, lowerS, lowerV);
     Scalar upper_hsv(upperH, upperS, upperV);
+    cv::Scalar lower_YCrCb(0, 135, 85);
+    cv::Scalar upper_YCrCb(255, 180, 135);
 
-    cv::Mat kernel_3x3 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
-    cv::Mat kernel_4x4 = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(4, 4));
+    // BGR → skin lookup tables, one per rule since each mask is opened on its own before the AND
+    // Same masks as cvtColor + inRange, without converting the frame
+    SkinLut hsvLut, yCbCrLut;
+    hsvLut.setHSV(lower_hsv, upper_hsv);
+    yCbCrLut.setYCrCb(lower_YCrCb, upper_YCrCb);
 
     while (true)
     {
@@ -51,31 +65,30 @@ int main()
             break;
         }
 
-        // Convert to HSV and apply HSV mask
-        cvtColor(frame, hsvImage, COLOR_BGR2HSV);
-        inRange(hsvImage, lower_hsv, upper_hsv, hsvMask);
-        cv::morphologyEx(hsvMask, hsvMask, cv::MORPH_OPEN, kernel_3x3);
+        // HSV mask, opened with a 3x3 rect kernel
+        hsvLut.apply(frame, hsvMask);
+        maskOpen(hsvMask, hsvMask, 3, 3);
 
-        // Convert to YCbCr and apply YCbCr mask
-        cv::cvtColor(frame, yCbCrImage, cv::COLOR_BGR2YCrCb);
-        cv::Scalar lower_YCrCb(0, 135, 85);
-        cv::Scalar upper_YCrCb(255, 180, 135);
-        cv::inRange(yCbCrImage, lower_YCrCb, upper_YCrCb, yCbCrMask);
-        cv::morphologyEx(yCbCrMask, yCbCrMask, cv::MORPH_OPEN, kernel_3x3);
+        // YCbCr mask, opened with a 3x3 rect kernel
+        yCbCrLut.apply(frame, yCbCrMask);
+        maskOpen(yCbCrMask, yCbCrMask, 3, 3);
 
         // Merge the YCbCr and HSV masks using bitwise AND
-        cv::bitwise_and(yCbCrMask, hsvMask, global_mask);
+        maskAnd(yCbCrMask, hsvMask, global_mask);
 
-        // Apply a median blur to the global mask
-        cv::medianBlur(global_mask, global_mask, 3);
+        // Apply a median blur to the global mask (3x3 majority vote)
+        maskMedian3(global_mask, global_mask);
 
-        // Apply another opening morphological transformation to the global mask
-        cv::morphologyEx(global_mask, global_mask, cv::MORPH_OPEN, kernel_4x4);
+        // Apply another opening morphological transformation to the global mask (4x4 rect kernel)
+        maskOpen(global_mask, global_mask, 4, 4);
 
-        // Invert the masks
-        cv::bitwise_not(hsvMask, HSV_result);
-        cv::bitwise_not(yCbCrMask, YCrCb_result);
-        cv::bitwise_not(global_mask, global_result);
+        // Invert the masks, back to cv::Mat only for imshow
+        maskNot(hsvMask, inverted);
+        inverted.toMat(HSV_result);
+        maskNot(yCbCrMask, inverted);
+        inverted.toMat(YCrCb_result);
+        maskNot(global_mask, inverted);
+        inverted.toMat(global_result);
 
         // Display results
         imshow("Original Frame", frame);
@@ -89,5 +102,6 @@ int main()
         cv::waitKey(1);
     }
 
+    pool.printStats(cout);
     return 0;
 }
@@ -1,6 +1,8 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 
+#include "thresholdStage.hpp"
+
 int main()
 {
     cv::VideoCapture cap(2); // Open the default camera
@@ -14,7 +16,7 @@ int main()
     cap.set(cv::CAP_PROP_FRAME_WIDTH, 640);
     cap.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
 
-    cv::Mat frame, grayFrame, blurredFrame, thresholdedFrame;
+    cv::Mat frame, grayFrame, thresholdedFrame;
     while (true)
     {
         cap >> frame;
@@ -25,16 +27,10 @@ int main()
             // break;
         }
 
-        // Convert to grayscale
-        cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY);
-
-        // Apply Gaussian blur
-        // void cv::GaussianBlur(cv::InputArray src, cv::OutputArray dst, cv::Size ksize, double sigmaX, double sigmaY = (0.0), int borderType = 4)
-        cv::GaussianBlur(grayFrame, blurredFrame, cv::Size(5, 5), 0);
-
-        // Threshold the image
-        // double cv::threshold(cv::InputArray src, cv::OutputArray dst, double thresh, double maxval, int type)
-        cv::threshold(blurredFrame, thresholdedFrame, 60, 255, cv::THRESH_BINARY);
+        // Grayscale + Gaussian blur (5x5) + threshold (60) in one pass, same mask as
+        //      cvtColor(BGR2GRAY) → GaussianBlur(cv::Size(5, 5), 0) → threshold(60, 255, cv::THRESH_BINARY)
+        // without the two intermediate frames
+        blurThreshold(lumaFromBGR(frame), 60, thresholdedFrame);
 
         // Find contours
         std::vector<std::vector<cv::Point>> contours;
@@ -46,6 +42,8 @@ int main()
         cv::drawContours(contourOutput, contours, -1, cv::Scalar(0, 255, 0), 2);
 
         // Display the frame
+        // The fused pass keeps no gray frame, this one is only converted for its window
+        cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY);
         cv::imshow("grayFrame", grayFrame);
         cv::moveWindow("grayFrame", 100, 300);
         cv::imshow("ThresholdedFrame", thresholdedFrame);